@@ -0,0 +1,71 @@
+#include <vector>
+#include <random>
+#include "solarCalculator/almanac.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/sun.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+StationSet makeStations(const size_t nStations)
+{
+    StationSet stations;
+    std::mt19937 generator(4);
+    std::uniform_real_distribution<double> latDist(-60, 60);
+    std::uniform_real_distribution<double> lonDist(-180, 180);
+    for (size_t i = 0; i < nStations; ++i)
+    {
+        stations.add(Observer{latDist(generator), lonDist(generator)});
+    }
+    return stations;
+}
+
+/// One year of rise/set/noon at 100 stations with Sun.
+void BM_AlmanacSun(benchmark::State &state)
+{
+    auto stations = makeStations(100);
+    std::vector<double> values(3*365*stations.size());
+    for (auto _ : state)
+    {
+        size_t k = 0;
+        for (size_t site = 0; site < stations.size(); ++site)
+        {
+            const auto &observer = stations.getSite(site);
+            Sun sun;
+            sun.setLocation(Location(observer.latitude, observer.longitude));
+            for (int day = 0; day < 365; ++day)
+            {
+                sun.setTime(1577880000 + static_cast<int64_t> (day)*86400);
+                values[k] = sun.getSunrise();
+                values[k + 1] = sun.getSunset();
+                values[k + 2] = sun.getSolarNoon();
+                k = k + 3;
+            }
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations()*365*stations.size());
+}
+
+/// The same with the almanac.
+void BM_Almanac(benchmark::State &state)
+{
+    auto stations = makeStations(100);
+    Almanac almanac;
+    for (auto _ : state)
+    {
+        almanac.compute(stations, 2021, 2021);
+        benchmark::DoNotOptimize(almanac.getSunrises());
+    }
+    state.SetItemsProcessed(state.iterations()*365*stations.size());
+}
+
+}
+
+BENCHMARK(BM_AlmanacSun);
+BENCHMARK(BM_Almanac);
@@ -0,0 +1,236 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/parallelEngine.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+struct Catalog
+{
+    explicit Catalog(const size_t nRows) :
+        times(nRows),
+        latitudes(nRows),
+        longitudes(nRows),
+        elevations(nRows),
+        azimuths(nRows)
+    {
+        std::mt19937 generator(4);
+        std::uniform_real_distribution<double> timeDist(0, 2000000000);
+        std::uniform_real_distribution<double> latDist(37, 42);
+        std::uniform_real_distribution<double> lonDist(-114, -109);
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            times[i] = timeDist(generator);
+            latitudes[i] = latDist(generator);
+            longitudes[i] = lonDist(generator);
+        }
+    }
+    std::vector<double> times;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<double> elevations;
+    std::vector<double> azimuths;
+};
+
+void BM_ComputeSolarPositions(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    for (auto _ : state)
+    {
+        computeSolarPositions(catalog.times.size(), catalog.times.data(),
+                              catalog.latitudes.data(),
+                              catalog.longitudes.data(),
+                              catalog.elevations.data(),
+                              catalog.azimuths.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+/// Rows with the polynomial trigonometry of the fast accuracy tier.
+void BM_ComputeSolarPositionsFast(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    for (auto _ : state)
+    {
+        computeSolarPositions(Accuracy::Fast,
+                              catalog.times.size(), catalog.times.data(),
+                              catalog.latitudes.data(),
+                              catalog.longitudes.data(),
+                              catalog.elevations.data(),
+                              catalog.azimuths.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+/// Single precision rows.
+void BM_ComputeSolarPositionsFloat(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    std::vector<float> latitudes(catalog.latitudes.begin(),
+                                 catalog.latitudes.end());
+    std::vector<float> longitudes(catalog.longitudes.begin(),
+                                  catalog.longitudes.end());
+    std::vector<float> elevations(latitudes.size());
+    std::vector<float> azimuths(latitudes.size());
+    for (auto _ : state)
+    {
+        computeSolarPositionsFloat(catalog.times.size(), catalog.times.data(),
+                                   latitudes.data(), longitudes.data(),
+                                   elevations.data(), azimuths.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+/// Rows at a network of 1000 registered sites.
+void BM_StationSetComputeSolarPositions(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    StationSet stations;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        stations.add(Observer{catalog.latitudes[i], catalog.longitudes[i]});
+    }
+    std::vector<size_t> sites(catalog.times.size());
+    for (size_t i = 0; i < sites.size(); ++i){sites[i] = i%stations.size();}
+    for (auto _ : state)
+    {
+        computeSolarPositions(stations, catalog.times.size(),
+                              catalog.times.data(), sites.data(),
+                              catalog.elevations.data(),
+                              catalog.azimuths.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+void BM_ParallelEngineComputeSolarPositions(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    ParallelEngine engine;
+    for (auto _ : state)
+    {
+        engine.computeSolarPositions(catalog.times.size(),
+                                     catalog.times.data(),
+                                     catalog.latitudes.data(),
+                                     catalog.longitudes.data(),
+                                     catalog.elevations.data(),
+                                     catalog.azimuths.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+/// One time at many candidate locations: the subsolar vector path, the
+/// shared ephemeris path, and the same locations as catalog rows.
+void BM_ComputeElevationsStationSet(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    StationSet stations;
+    stations.reserve(catalog.times.size());
+    for (size_t i = 0; i < catalog.times.size(); ++i)
+    {
+        stations.add(Observer{catalog.latitudes[i], catalog.longitudes[i]});
+    }
+    for (auto _ : state)
+    {
+        computeElevations(1622042345, stations, catalog.elevations.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+void BM_ComputeElevations(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    for (auto _ : state)
+    {
+        computeElevations(1622042345, catalog.times.size(),
+                          catalog.latitudes.data(), catalog.longitudes.data(),
+                          catalog.elevations.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+void BM_ComputeSolarPositionsOneTime(benchmark::State &state)
+{
+    Catalog catalog(static_cast<size_t> (state.range(0)));
+    std::fill(catalog.times.begin(), catalog.times.end(), 1622042345);
+    for (auto _ : state)
+    {
+        computeSolarPositions(catalog.times.size(), catalog.times.data(),
+                              catalog.latitudes.data(),
+                              catalog.longitudes.data(),
+                              catalog.elevations.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+/// Elevations on a square grid at one time versus the same nodes as rows.
+void BM_ComputeSolarPositionGrid(benchmark::State &state)
+{
+    auto n = static_cast<size_t> (state.range(0));
+    std::vector<double> latitudes(n);
+    std::vector<double> longitudes(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        latitudes[i] = 37 + 5*static_cast<double> (i)/n;
+        longitudes[i] = -114 + 5*static_cast<double> (i)/n;
+    }
+    std::vector<double> elevations(n*n);
+    for (auto _ : state)
+    {
+        computeSolarPositionGrid(1622042345, n, latitudes.data(),
+                                 n, longitudes.data(), elevations.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*n*n);
+}
+
+void BM_ComputeSolarPositionsGridAsRows(benchmark::State &state)
+{
+    auto n = static_cast<size_t> (state.range(0));
+    std::vector<double> times(n*n, 1622042345);
+    std::vector<double> latitudes(n*n);
+    std::vector<double> longitudes(n*n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            latitudes[i*n + j] = 37 + 5*static_cast<double> (i)/n;
+            longitudes[i*n + j] = -114 + 5*static_cast<double> (j)/n;
+        }
+    }
+    std::vector<double> elevations(n*n);
+    for (auto _ : state)
+    {
+        computeSolarPositions(times.size(), times.data(), latitudes.data(),
+                              longitudes.data(), elevations.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*n*n);
+}
+
+}
+
+BENCHMARK(BM_ComputeSolarPositions)->Arg(1024)->Arg(1 << 20);
+BENCHMARK(BM_ComputeSolarPositionsFast)->Arg(1024)->Arg(1 << 20);
+BENCHMARK(BM_ComputeSolarPositionsFloat)->Arg(1024)->Arg(1 << 20);
+BENCHMARK(BM_StationSetComputeSolarPositions)->Arg(1 << 20);
+BENCHMARK(BM_ParallelEngineComputeSolarPositions)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(BM_ComputeElevationsStationSet)->Arg(1 << 16);
+BENCHMARK(BM_ComputeElevations)->Arg(1 << 16);
+BENCHMARK(BM_ComputeSolarPositionsOneTime)->Arg(1 << 16);
+BENCHMARK(BM_ComputeSolarPositionGrid)->Arg(500);
+BENCHMARK(BM_ComputeSolarPositionsGridAsRows)->Arg(500);
@@ -0,0 +1,42 @@
+#include <vector>
+#include <random>
+#include "solarCalculator/dayNight.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+/// Events clustered around a few quarry sites.
+void BM_IsNight(benchmark::State &state)
+{
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> timeDist(1.5e9, 1.5e9 + 86400*365);
+    std::uniform_int_distribution<size_t> siteDist(0, 99);
+    std::vector<Observer> sites;
+    for (int i = 0; i < 100; ++i)
+    {
+        sites.push_back(Observer{37 + 0.05*i, -114 + 0.05*i});
+    }
+    std::vector<double> times(1 << 16);
+    std::vector<Observer> observers(times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        times[i] = timeDist(generator);
+        observers[i] = sites[siteDist(generator)];
+    }
+    DayNightClassifier classifier(1 << 16);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(classifier.isNight(times[i], observers[i]));
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(BM_IsNight);
@@ -0,0 +1,56 @@
+#include <vector>
+#include <random>
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/ephemerisTable.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+std::vector<double> makeTimes()
+{
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> timeDist(1.5e9, 1.6e9);
+    std::vector<double> times(1 << 16);
+    for (auto &time : times){time = timeDist(generator);}
+    return times;
+}
+
+/// The analytic NOAA formulas.
+void BM_EphemerisAnalytic(benchmark::State &state)
+{
+    auto times = makeTimes();
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        Ephemeris ephemeris(times[i]);
+        benchmark::DoNotOptimize(ephemeris);
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// The Chebyshev table.
+void BM_EphemerisTable(benchmark::State &state)
+{
+    auto times = makeTimes();
+    EphemerisTable table;
+    table.initialize(2000, 2030);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        double declination, equationOfTime;
+        table.evaluate(times[i], &declination, &equationOfTime);
+        benchmark::DoNotOptimize(declination);
+        benchmark::DoNotOptimize(equationOfTime);
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(BM_EphemerisAnalytic);
+BENCHMARK(BM_EphemerisTable);
@@ -0,0 +1,101 @@
+#include <vector>
+#include <cmath>
+#include <time/utc.hpp>
+#include "solarCalculator/julianDate.hpp"
+#include "kernels.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+/// The NOAA Julian day at 0h of a date.
+double getJD(int year, int month, const int day)
+{
+    if (month <= 2)
+    {
+        year -= 1;
+        month += 12;
+    }
+    auto A = static_cast<int> (std::floor(year/100.));
+    auto B = 2 - A + static_cast<int> (std::floor(A/4.));
+    return std::floor(365.25*(year + 4716)) + std::floor(30.6001*(month+1))
+         + day + B - 1524.5;
+}
+
+double calcTimeJulianCent(const double jd)
+{
+    return (jd - 2451545.0)/36525.0;
+}
+
+/// One time stamp per hour starting at the given year.
+std::vector<int64_t> makeTimes(const int year)
+{
+    Time::UTC start;
+    start.setYear(year);
+    start.setMonthAndDay({1, 1});
+    auto t0 = static_cast<int64_t> (start.getEpoch());
+    std::vector<int64_t> times(8760);
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        times[i] = t0 + 3600*static_cast<int64_t> (i);
+    }
+    return times;
+}
+
+/// This is what Sun::setTime() and update() used to do: build a UTC time,
+/// decompose it into a calendar date, then rebuild the Julian day.
+void BM_TimeUTCToJulianCentury(benchmark::State &state)
+{
+    auto times = makeTimes(static_cast<int> (state.range(0)));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        Time::UTC time(static_cast<double> (times[i]));
+        auto jday = getJD(time.getYear(), time.getMonth(),
+                          time.getDayOfMonth());
+        auto timeLocal = time.getHour()*60
+                       + time.getMinute()
+                       + time.getSecond()/60.0;
+        auto T = calcTimeJulianCent(jday + timeLocal/1440.0);
+        benchmark::DoNotOptimize(T);
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// The direct arithmetic conversion.
+void BM_EpochToJulianCentury(benchmark::State &state)
+{
+    auto times = makeTimes(static_cast<int> (state.range(0)));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto T = toJulianCentury(static_cast<double> (times[i]));
+        benchmark::DoNotOptimize(T);
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// The direct conversion with fractional seconds.
+void BM_FractionalEpochToJulianCentury(benchmark::State &state)
+{
+    auto times = makeTimes(static_cast<int> (state.range(0)));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto T = toJulianCentury(static_cast<double> (times[i]) + 0.25);
+        benchmark::DoNotOptimize(T);
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(BM_TimeUTCToJulianCentury)->Arg(-999)->Arg(1980)->Arg(2998);
+BENCHMARK(BM_EpochToJulianCentury)->Arg(-999)->Arg(1980)->Arg(2998);
+BENCHMARK(BM_FractionalEpochToJulianCentury)->Arg(1980);
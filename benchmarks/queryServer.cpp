@@ -0,0 +1,161 @@
+#include <vector>
+#include <random>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <unistd.h>
+#include "solarCalculator/queryServer.hpp"
+#include "solarCalculator/queryClient.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+/// One server shared by every benchmark and thread.
+const std::string &getServer()
+{
+    static QueryServer server;
+    static const std::string socketPath = []()
+    {
+        auto path = "/tmp/solarCalculator-benchmark-"
+                  + std::to_string(::getpid()) + ".sock";
+        server.start(path, 2000, 2050);
+        return path;
+    }();
+    return socketPath;
+}
+
+struct Catalog
+{
+    explicit Catalog(const size_t nRows) :
+        times(nRows),
+        latitudes(nRows),
+        longitudes(nRows)
+    {
+        std::mt19937 generator(5);
+        std::uniform_real_distribution<double> timeDist(1.5e9,
+                                                        1.5e9 + 86400*365);
+        std::uniform_real_distribution<double> latDist(-90, 90);
+        std::uniform_real_distribution<double> lonDist(-180, 180);
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            times[i] = timeDist(generator);
+            latitudes[i] = latDist(generator);
+            longitudes[i] = lonDist(generator);
+        }
+    }
+    std::vector<double> times;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+};
+
+/// Round-trip latency of a one-row position query.  With threads this
+/// measures the server coalescing concurrent clients.
+void BM_QueryPosition(benchmark::State &state)
+{
+    QueryClient client;
+    client.connect(getServer());
+    Catalog catalog(1024);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        double elevation = 0;
+        double azimuth = 0;
+        client.computePositions(1, &catalog.times[i], &catalog.latitudes[i],
+                                &catalog.longitudes[i], &elevation, &azimuth);
+        benchmark::DoNotOptimize(elevation);
+        i = (i + 1)%catalog.times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Throughput of a bulk position query.
+void BM_QueryPositionBulk(benchmark::State &state)
+{
+    QueryClient client;
+    client.connect(getServer());
+    auto nRows = static_cast<size_t> (state.range(0));
+    Catalog catalog(nRows);
+    std::vector<double> elevations(nRows), azimuths(nRows);
+    for (auto _ : state)
+    {
+        client.computePositions(nRows, catalog.times.data(),
+                                catalog.latitudes.data(),
+                                catalog.longitudes.data(),
+                                elevations.data(), azimuths.data());
+        benchmark::DoNotOptimize(elevations.data());
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+
+/// Round-trip latency of a one-row position query while another client
+/// keeps the server busy with bulk requests computed exactly.
+void BM_QueryPositionUnderLoad(benchmark::State &state)
+{
+    std::atomic<bool> stop{false};
+    std::thread load([&stop]()
+    {
+        QueryClient client;
+        client.connect(getServer());
+        // 1990 is before the table
+        const size_t nRows = 1 << 20;
+        Catalog catalog(nRows);
+        for (auto &time : catalog.times){time = time - 86400*365*27;}
+        std::vector<double> elevations(nRows), azimuths(nRows);
+        while (!stop)
+        {
+            client.computePositions(nRows, catalog.times.data(),
+                                    catalog.latitudes.data(),
+                                    catalog.longitudes.data(),
+                                    elevations.data(), azimuths.data());
+        }
+    });
+    QueryClient client;
+    client.connect(getServer());
+    Catalog catalog(1024);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        double elevation = 0;
+        double azimuth = 0;
+        client.computePositions(1, &catalog.times[i], &catalog.latitudes[i],
+                                &catalog.longitudes[i], &elevation, &azimuth);
+        benchmark::DoNotOptimize(elevation);
+        i = (i + 1)%catalog.times.size();
+    }
+    stop = true;
+    load.join();
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Round-trip latency of a one-row day/night query at a few sites.
+void BM_QueryDayNight(benchmark::State &state)
+{
+    QueryClient client;
+    client.connect(getServer());
+    Catalog catalog(1024);
+    for (size_t i = 0; i < catalog.times.size(); ++i)
+    {
+        catalog.latitudes[i] = 37 + 0.05*static_cast<double> (i%100);
+        catalog.longitudes[i] =-114 + 0.05*static_cast<double> (i%100);
+    }
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        bool isNight = false;
+        client.classifyDayNight(1, &catalog.times[i], &catalog.latitudes[i],
+                                &catalog.longitudes[i], &isNight);
+        benchmark::DoNotOptimize(isNight);
+        i = (i + 1)%catalog.times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(BM_QueryPosition)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_QueryPositionBulk)->Arg(1 << 12)->Arg(1 << 18)->UseRealTime();
+BENCHMARK(BM_QueryPositionUnderLoad)->UseRealTime();
+BENCHMARK(BM_QueryDayNight)->UseRealTime();
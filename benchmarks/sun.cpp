@@ -0,0 +1,237 @@
+#include <vector>
+#include <time/utc.hpp>
+#include "solarCalculator/sun.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "kernels.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+/// Every benchmark is run for these epoch years and latitudes.  This
+/// includes far-epoch and polar cases.
+const std::vector<int64_t> YEARS{-999, 1000, 2021, 2998};
+const std::vector<int64_t> LATITUDES{0, 41, 70, 85};
+
+/// Times every 61 minutes (so the sampling drifts through the day)
+/// starting on the given year's summer solstice.
+std::vector<double> makeTimes(const int64_t year)
+{
+    Time::UTC start;
+    start.setYear(static_cast<int> (year));
+    start.setMonthAndDay({6, 21});
+    std::vector<double> times(4096);
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        times[i] = start.getEpoch() + 61*60*static_cast<double> (i);
+    }
+    return times;
+}
+
+void setLabel(benchmark::State &state)
+{
+    state.SetLabel("year=" + std::to_string(state.range(0))
+                 + " latitude=" + std::to_string(state.range(1)));
+}
+
+///--------------------------------------------------------------------------///
+///                                   Sun                                    ///
+///--------------------------------------------------------------------------///
+
+void BM_SunSetTime(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    Sun sun;
+    sun.setLocation(Location(static_cast<double> (state.range(1)), -111.89));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        sun.setTime(static_cast<int64_t> (times[i]));
+        i = (i + 1)%times.size();
+    }
+    benchmark::DoNotOptimize(sun);
+    setLabel(state);
+}
+
+void BM_SunSetLocation(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    Sun sun;
+    sun.setTime(static_cast<int64_t> (times[0]));
+    Location location(static_cast<double> (state.range(1)), -111.89);
+    for (auto _ : state)
+    {
+        sun.setLocation(location);
+    }
+    benchmark::DoNotOptimize(sun);
+    setLabel(state);
+}
+
+/// A getter on a freshly set time; i.e., the per-event cost.
+template<typename Getter>
+void sunGetter(benchmark::State &state, Getter getter)
+{
+    auto times = makeTimes(state.range(0));
+    Sun sun;
+    sun.setLocation(Location(static_cast<double> (state.range(1)), -111.89));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        sun.setTime(static_cast<int64_t> (times[i]));
+        benchmark::DoNotOptimize(getter(sun));
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    setLabel(state);
+}
+
+void BM_SunGetElevation(benchmark::State &state)
+{
+    sunGetter(state, [](const Sun &sun){return sun.getElevation();});
+}
+
+void BM_SunGetAzimuth(benchmark::State &state)
+{
+    sunGetter(state, [](const Sun &sun){return sun.getAzimuth();});
+}
+
+void BM_SunGetDeclination(benchmark::State &state)
+{
+    sunGetter(state, [](const Sun &sun){return sun.getDeclination();});
+}
+
+void BM_SunGetEquationOfTime(benchmark::State &state)
+{
+    sunGetter(state, [](const Sun &sun){return sun.getEquationOfTime();});
+}
+
+///--------------------------------------------------------------------------///
+///                                 Kernels                                  ///
+///--------------------------------------------------------------------------///
+
+void BM_CalcEquationOfTime(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            calcEquationOfTime(toJulianCentury(times[i])));
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    setLabel(state);
+}
+
+void BM_CalcSunDeclination(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            calcSunDeclination(toJulianCentury(times[i])));
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    setLabel(state);
+}
+
+void BM_CalcAzEl(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    auto latitude = static_cast<double> (state.range(1));
+    std::vector<double> eqTimes(times.size());
+    std::vector<double> thetas(times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        eqTimes[i] = calcEquationOfTime(toJulianCentury(times[i]));
+        thetas[i] = calcSunDeclination(toJulianCentury(times[i]));
+    }
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            calcAzEl(toJulianCentury(times[i]),
+                     calcMinutesOfDayFromEpoch(times[i]),
+                     latitude, 248.11, 0, eqTimes[i], thetas[i]));
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    setLabel(state);
+}
+
+void BM_CalcRiseSetEpochs(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    auto latitude = static_cast<double> (state.range(1));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        double rise = 0;
+        double set = 0;
+        double noon = 0;
+        auto day = calcLocalDay(times[i], 248.11);
+        benchmark::DoNotOptimize(
+            calcRiseSetEpochs(day, latitude, 248.11, 90.833,
+                              &rise, &set, &noon));
+        benchmark::DoNotOptimize(rise);
+        benchmark::DoNotOptimize(set);
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    setLabel(state);
+}
+
+/// The next sunrise skips the polar night and midnight sun in a bounded
+/// number of rise/set solves.
+void BM_CalcNextRiseSetEpoch(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    auto latitude = static_cast<double> (state.range(1));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            calcNextRiseSetEpoch(times[i], latitude, 248.11, 90.833,
+                                 true, true));
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    setLabel(state);
+}
+
+void BM_CalcTransitEpoch(benchmark::State &state)
+{
+    auto times = makeTimes(state.range(0));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(calcTransitEpoch(times[i], 248.11));
+        i = (i + 1)%times.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    setLabel(state);
+}
+
+}
+
+#define SOLAR_BENCHMARK(name) \
+    BENCHMARK(name)->ArgsProduct({YEARS, LATITUDES})
+
+SOLAR_BENCHMARK(BM_SunSetTime);
+SOLAR_BENCHMARK(BM_SunSetLocation);
+SOLAR_BENCHMARK(BM_SunGetElevation);
+SOLAR_BENCHMARK(BM_SunGetAzimuth);
+SOLAR_BENCHMARK(BM_SunGetDeclination);
+SOLAR_BENCHMARK(BM_SunGetEquationOfTime);
+SOLAR_BENCHMARK(BM_CalcEquationOfTime);
+SOLAR_BENCHMARK(BM_CalcSunDeclination);
+SOLAR_BENCHMARK(BM_CalcAzEl);
+SOLAR_BENCHMARK(BM_CalcRiseSetEpochs);
+SOLAR_BENCHMARK(BM_CalcNextRiseSetEpoch);
+SOLAR_BENCHMARK(BM_CalcTransitEpoch);
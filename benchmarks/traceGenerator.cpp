@@ -0,0 +1,50 @@
+#include <vector>
+#include "solarCalculator/traceGenerator.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/batch.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+constexpr size_t N_SAMPLES = 86400;
+
+/// One day at 1 Hz with the batch solver.
+void BM_TraceBatch(benchmark::State &state)
+{
+    std::vector<double> times(N_SAMPLES);
+    for (size_t i = 0; i < N_SAMPLES; ++i){times[i] = 1.6e9 + i;}
+    std::vector<double> latitudes(N_SAMPLES, 40.77);
+    std::vector<double> longitudes(N_SAMPLES, -111.89);
+    std::vector<double> elevations(N_SAMPLES);
+    for (auto _ : state)
+    {
+        computeSolarPositions(N_SAMPLES, times.data(),
+                              latitudes.data(), longitudes.data(),
+                              elevations.data());
+        benchmark::DoNotOptimize(elevations.data());
+    }
+    state.SetItemsProcessed(state.iterations()*N_SAMPLES);
+}
+
+/// One day at 1 Hz with the incremental generator.
+void BM_TraceGenerator(benchmark::State &state)
+{
+    Location location(40.77, -111.89);
+    std::vector<double> elevations(N_SAMPLES);
+    TraceGenerator generator;
+    for (auto _ : state)
+    {
+        generator.initialize(location, 1.6e9, 1);
+        generator.generate(N_SAMPLES, elevations.data());
+        benchmark::DoNotOptimize(elevations.data());
+    }
+    state.SetItemsProcessed(state.iterations()*N_SAMPLES);
+}
+
+}
+
+BENCHMARK(BM_TraceBatch);
+BENCHMARK(BM_TraceGenerator);
@@ -0,0 +1,23 @@
+#ifndef SOLARCALCULATOR_ACCURACY_HPP
+#define SOLARCALCULATOR_ACCURACY_HPP
+namespace SolarCalculator
+{
+/// @brief Selects how the trigonometric functions in the solar position
+///        formulas are evaluated.
+enum class Accuracy
+{
+    Exact, /*!< The standard library's functions.  This is the default and
+                is bit-identical to the functions without an accuracy
+                argument. */
+    Fast   /*!< Short minimax polynomials in place of libm's functions.
+                Over the years [-1000,2999] the elevation differs from
+                Exact by at most 5.e-6 degrees, the declination by at most
+                2.e-6 degrees, and the equation of time by at most 1.e-8
+                minutes.  The azimuth differs by at most 1.e-4 degrees
+                except within a degree of the zenith or nadir, where the
+                azimuth is ill-conditioned and the difference can reach
+                1.e-3 degrees.  These are negligible compared to the NOAA
+                formulas' own error (~0.01 degrees). */
+};
+}
+#endif
@@ -0,0 +1,128 @@
+#ifndef SOLARCALCULATOR_ALMANAC_HPP
+#define SOLARCALCULATOR_ALMANAC_HPP
+#include <cstdint>
+#include <memory>
+namespace SolarCalculator
+{
+class StationSet;
+class ParallelEngine;
+/// @class Almanac "almanac.hpp" "solarCalculator/almanac.hpp"
+/// @brief Tabulates the sunrise, sunset, solar noon, and day length on
+///        every day of a range of years at every site of a station set.
+///
+///        The declination and equation of time are sampled once per UTC
+///        day and interpolated for all sites, so the ephemeris is computed
+///        once for the network rather than several times per site and day.
+///        The interpolated rise, set, and noon times differ from those of
+///        \c Sun by well under a millisecond.
+///
+///        The results are columnar.  Each column has one row per site and
+///        day where row = site*\c getNumberOfDays() + day.  Day d of a site
+///        is the local mean solar day d of \c getLocalDays(), i.e., the
+///        calendar date at the site's mean solar time.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class Almanac
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    Almanac();
+    /// @brief Copy constructor.
+    /// @param[in] almanac  The almanac from which to initialize this class.
+    Almanac(const Almanac &almanac);
+    /// @brief Move constructor.
+    /// @param[in,out] almanac  The almanac from which to initialize this
+    ///                         class.  On exit, almanac's behavior is
+    ///                         undefined.
+    Almanac(Almanac &&almanac) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] almanac  The almanac to copy to this.
+    /// @result A deep copy of the almanac.
+    Almanac& operator=(const Almanac &almanac);
+    /// @brief Move assignment operator.
+    /// @param[in,out] almanac  The almanac whose memory will be moved to
+    ///                         this.  On exit, almanac's behavior is
+    ///                         undefined.
+    /// @result The memory from almanac moved to this.
+    Almanac& operator=(Almanac &&almanac) noexcept;
+    /// @}
+
+    /// @name Computation
+    /// @{
+    /// @brief Computes the almanac on the calling thread.
+    /// @param[in] stations   The sites.
+    /// @param[in] firstYear  The first year.
+    /// @param[in] lastYear   The last year.  The almanac runs through the
+    ///                       end of this year.
+    /// @throws std::invalid_argument if stations is empty, the years are
+    ///         not in the range [-1000,2999], or firstYear > lastYear.
+    void compute(const StationSet &stations, int firstYear, int lastYear);
+    /// @brief Computes the almanac in parallel.
+    /// @param[in,out] engine  The thread pool that computes the rows.
+    /// @sa The other \c compute() for the remaining parameters.
+    /// @throws std::invalid_argument if stations is empty, the years are
+    ///         not in the range [-1000,2999], or firstYear > lastYear.
+    void compute(const StationSet &stations, int firstYear, int lastYear,
+                 ParallelEngine &engine);
+    /// @result True indicates the almanac was computed.
+    [[nodiscard]] bool haveAlmanac() const noexcept;
+    /// @}
+
+    /// @name Dimensions
+    /// @{
+    /// @result The number of sites.
+    [[nodiscard]] size_t getNumberOfSites() const noexcept;
+    /// @result The number of days per site.
+    [[nodiscard]] size_t getNumberOfDays() const noexcept;
+    /// @result The number of rows, i.e., sites times days.
+    [[nodiscard]] size_t getNumberOfRows() const noexcept;
+    /// @result The local mean solar days as days since the epoch.  The
+    ///         local day d begins at local mean midnight,
+    ///         (d - longitude/360)*86400 seconds from the epoch, where the
+    ///         longitude is in [-180,180).  This is an array whose dimension
+    ///         is [\c getNumberOfDays()].
+    /// @throws std::runtime_error if \c haveAlmanac() is false.
+    [[nodiscard]] const int64_t *getLocalDays() const;
+    /// @}
+
+    /// @name Columns
+    /// @{
+    /// @result The sunrise times in seconds from the epoch.  This is NaN if
+    ///         the sun does not rise or set that day.  This is an array
+    ///         whose dimension is [\c getNumberOfRows()].
+    /// @throws std::runtime_error if \c haveAlmanac() is false.
+    [[nodiscard]] const double *getSunrises() const;
+    /// @result The sunset times in seconds from the epoch.  This is NaN if
+    ///         the sun does not rise or set that day.  This is an array
+    ///         whose dimension is [\c getNumberOfRows()].
+    /// @throws std::runtime_error if \c haveAlmanac() is false.
+    [[nodiscard]] const double *getSunsets() const;
+    /// @result The solar noon (transit) times in seconds from the epoch.
+    ///         This is an array whose dimension is [\c getNumberOfRows()].
+    /// @throws std::runtime_error if \c haveAlmanac() is false.
+    [[nodiscard]] const double *getSolarNoons() const;
+    /// @result The day lengths, sunset less sunrise, in seconds.  This is
+    ///         86400 during the midnight sun and 0 during the polar night.
+    ///         This is an array whose dimension is [\c getNumberOfRows()].
+    /// @throws std::runtime_error if \c haveAlmanac() is false.
+    [[nodiscard]] const double *getDayLengths() const;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Releases the almanac.
+    void clear() noexcept;
+    /// @brief Destructor.
+    ~Almanac();
+    /// @}
+private:
+    class AlmanacImpl;
+    std::unique_ptr<AlmanacImpl> pImpl;
+};
+}
+#endif
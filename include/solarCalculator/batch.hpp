@@ -0,0 +1,233 @@
+#ifndef SOLARCALCULATOR_BATCH_HPP
+#define SOLARCALCULATOR_BATCH_HPP
+#include <cstddef>
+#include "solarCalculator/accuracy.hpp"
+namespace SolarCalculator
+{
+class EphemerisCache;
+class EphemerisTable;
+class StationSet;
+/// @brief Computes the solar position for a catalog of rows stored as a
+///        structure of arrays.  This is equivalent to looping on
+///        \c Sun::setLocation(), \c Sun::setTime(), and the getters but
+///        without the per-object overhead.
+/// @param[in] nRows        The number of rows.
+/// @param[in] times        The UTC times in seconds from the epoch
+///                         (e.g., Jan 1 1970).  Fractional seconds are
+///                         supported.  This is an array whose dimension
+///                         is [nRows].
+/// @param[in] latitudes    The latitudes in degrees.  Each latitude must
+///                         be in the range [-90,90].  This is an array
+///                         whose dimension is [nRows].
+/// @param[in] longitudes   The longitudes in degrees where positive is
+///                         east.  Each longitude must be in the range
+///                         [-540,540).  This is an array whose dimension
+///                         is [nRows].
+/// @param[out] elevations  The angle between the sun and the horizon in
+///                         degrees.  If not NULL then this is an array
+///                         whose dimension is [nRows].
+/// @param[out] azimuths    The azimuth of the sun in degrees measured
+///                         positive clockwise from true north.  If not
+///                         NULL then this is an array whose dimension is
+///                         [nRows].
+/// @param[out] declinations  The declination of the sun in degrees.  If
+///                           not NULL then this is an array whose
+///                           dimension is [nRows].
+/// @param[out] equationsOfTime  The equation of time in minutes.  If not
+///                              NULL then this is an array whose dimension
+///                              is [nRows].
+/// @throws std::invalid_argument if times, latitudes, or longitudes is
+///         NULL, a time is earlier than the year -1000 or later than the
+///         year 2999, or a latitude or longitude is out of range.
+void computeSolarPositions(size_t nRows,
+                           const double times[],
+                           const double latitudes[],
+                           const double longitudes[],
+                           double elevations[],
+                           double azimuths[] = nullptr,
+                           double declinations[] = nullptr,
+                           double equationsOfTime[] = nullptr);
+/// @brief Computes the solar position for a catalog of rows stored as a
+///        structure of arrays at the given accuracy.
+/// @param[in] accuracy  Accuracy::Exact is identical to the
+///                      \c computeSolarPositions() without an accuracy.
+///                      Accuracy::Fast replaces the standard library's
+///                      trigonometric functions with polynomials; see
+///                      \c Accuracy for the error bounds.
+/// @sa The other \c computeSolarPositions() for the remaining parameters.
+/// @throws std::invalid_argument if times, latitudes, or longitudes is
+///         NULL, a time is earlier than the year -1000 or later than the
+///         year 2999, or a latitude or longitude is out of range.
+void computeSolarPositions(Accuracy accuracy,
+                           size_t nRows,
+                           const double times[],
+                           const double latitudes[],
+                           const double longitudes[],
+                           double elevations[],
+                           double azimuths[] = nullptr,
+                           double declinations[] = nullptr,
+                           double equationsOfTime[] = nullptr);
+/// @brief Computes the solar position for a catalog of rows stored as a
+///        structure of arrays in single precision.  The times remain
+///        double precision epochal times and are internally split into
+///        whole days and the fraction of the day so that the time of day
+///        is not lost; the remaining arithmetic is float32 and the
+///        latitude, longitude, and output arrays take half the memory.
+/// @note Compared to the double precision solver over the years
+///       [-1000,2999] the elevation differs by at most 0.002 degrees
+///       (~1.e-5 degrees RMS).  The azimuth differs by at most 0.01
+///       degrees except within ten degrees of the zenith or nadir and
+///       within five degrees of the meridian, where float32 acos is
+///       ill-conditioned and the difference can reach a few tenths of a
+///       degree.  The declination differs by at most 5.e-5 degrees and the
+///       equation of time by at most 5.e-5 minutes.  This is adequate for,
+///       e.g., day/night classification but not for precise rise and set
+///       times.
+/// @sa The double precision \c computeSolarPositions() for the parameters.
+/// @throws std::invalid_argument if times, latitudes, or longitudes is
+///         NULL, a time is earlier than the year -1000 or later than the
+///         year 2999, or a latitude or longitude is out of range.
+void computeSolarPositionsFloat(size_t nRows,
+                                const double times[],
+                                const float latitudes[],
+                                const float longitudes[],
+                                float elevations[],
+                                float azimuths[] = nullptr,
+                                float declinations[] = nullptr,
+                                float equationsOfTime[] = nullptr);
+/// @brief Computes the solar position for a catalog of rows stored as a
+///        structure of arrays.  The time-only declination and equation of
+///        time are taken from the cache.  This is useful when many rows
+///        share the same time.
+/// @param[in] cache  The ephemeris cache.  Times are rounded to the cache's
+///                   resolution when computing the declination and
+///                   equation of time.
+/// @sa The other \c computeSolarPositions() for the remaining parameters.
+/// @throws std::invalid_argument if times, latitudes, or longitudes is
+///         NULL, a time is earlier than the year -1000 or later than the
+///         year 2999, or a latitude or longitude is out of range.
+void computeSolarPositions(const EphemerisCache &cache,
+                           size_t nRows,
+                           const double times[],
+                           const double latitudes[],
+                           const double longitudes[],
+                           double elevations[],
+                           double azimuths[] = nullptr,
+                           double declinations[] = nullptr,
+                           double equationsOfTime[] = nullptr);
+/// @brief Computes the solar position for a catalog of rows stored as a
+///        structure of arrays.  The time-only declination and equation of
+///        time are interpolated from the Chebyshev table.
+/// @param[in] table  The ephemeris table.  Every time must be in the table.
+/// @sa The other \c computeSolarPositions() for the remaining parameters.
+/// @throws std::invalid_argument if the table is not initialized, times,
+///         latitudes, or longitudes is NULL, a time is not in the table,
+///         or a latitude or longitude is out of range.
+void computeSolarPositions(const EphemerisTable &table,
+                           size_t nRows,
+                           const double times[],
+                           const double latitudes[],
+                           const double longitudes[],
+                           double elevations[],
+                           double azimuths[] = nullptr,
+                           double declinations[] = nullptr,
+                           double equationsOfTime[] = nullptr);
+/// @brief Computes the solar position for a catalog of rows whose
+///        locations are sites in a station set.
+/// @param[in] stations  The station set.
+/// @param[in] nRows     The number of rows.
+/// @param[in] times     The UTC times in seconds from the epoch.  This is
+///                      an array whose dimension is [nRows].
+/// @param[in] sites     The index of each row's site in the station set.
+///                      This is an array whose dimension is [nRows].
+/// @sa The other \c computeSolarPositions() for the output parameters.
+/// @throws std::invalid_argument if times or sites is NULL, a time is
+///         earlier than the year -1000 or later than the year 2999, or a
+///         site index is not less than stations.size().
+void computeSolarPositions(const StationSet &stations,
+                           size_t nRows,
+                           const double times[],
+                           const size_t sites[],
+                           double elevations[],
+                           double azimuths[] = nullptr,
+                           double declinations[] = nullptr,
+                           double equationsOfTime[] = nullptr);
+/// @brief Computes the solar elevation at one time at every site of a
+///        station set, e.g., candidate epicenters.  The sun's direction is
+///        fixed so the subsolar unit vector is computed once and the
+///        elevation at a site is the arcsine of its dot product with the
+///        site's precomputed unit vector, followed by the refraction
+///        correction.  No per-site trigonometry is needed other than the
+///        arcsine.
+/// @note This agrees with \c computeSolarPositions() to 1.e-6 degrees.  The
+///       largest differences are near the zenith and nadir where the
+///       arcsine is ill-conditioned.
+/// @param[in] time         The UTC time in seconds from the epoch.
+/// @param[in] stations     The sites.
+/// @param[out] elevations  The elevation in degrees at each site.  This is
+///                         an array whose dimension is [stations.size()].
+/// @throws std::invalid_argument if the time is earlier than the year -1000
+///         or later than the year 2999 or elevations is NULL and the
+///         station set is not empty.
+void computeElevations(double time,
+                       const StationSet &stations,
+                       double elevations[]);
+/// @brief Computes the solar elevation at one time at many locations, e.g.,
+///        a location uncertainty cloud.  The declination and equation of
+///        time are computed once rather than once per location.
+/// @param[in] time         The UTC time in seconds from the epoch.
+/// @param[in] nLocations   The number of locations.
+/// @param[in] latitudes    The latitudes in degrees.  Each latitude must be
+///                         in the range [-90,90].  This is an array whose
+///                         dimension is [nLocations].
+/// @param[in] longitudes   The longitudes in degrees.  Each longitude must
+///                         be in the range [-540,540).  This is an array
+///                         whose dimension is [nLocations].
+/// @param[out] elevations  The elevation in degrees at each location.  This
+///                         is an array whose dimension is [nLocations].
+/// @throws std::invalid_argument if the time is earlier than the year -1000
+///         or later than the year 2999, an array is NULL, or a latitude or
+///         longitude is out of range.
+void computeElevations(double time,
+                       size_t nLocations,
+                       const double latitudes[],
+                       const double longitudes[],
+                       double elevations[]);
+/// @brief Computes the solar position at one time on every node of a
+///        latitude/longitude grid, e.g., for maps and regional night masks.
+///        The declination and equation of time are computed once, the
+///        latitude terms once per grid row, and the hour angle terms once
+///        per grid column.  The elevation at a node is then a multiply-add
+///        of a row and a column term followed by an arccosine.  The results
+///        match \c computeSolarPositions() at the nodes.
+/// @param[in] time          The UTC time in seconds from the epoch.
+/// @param[in] nLatitudes    The number of grid rows.
+/// @param[in] latitudes     The latitude of each grid row in degrees.  Each
+///                          latitude must be in the range [-90,90].  This is
+///                          an array whose dimension is [nLatitudes].
+/// @param[in] nLongitudes   The number of grid columns.
+/// @param[in] longitudes    The longitude of each grid column in degrees.
+///                          Each longitude must be in the range [-540,540).
+///                          This is an array whose dimension is
+///                          [nLongitudes].
+/// @param[out] elevations   The elevation in degrees at each node where
+///                          elevations[i*nLongitudes + j] corresponds to
+///                          latitudes[i] and longitudes[j].  If not NULL
+///                          then this is an array whose dimension is
+///                          [nLatitudes x nLongitudes].
+/// @param[out] azimuths     The azimuth in degrees at each node.  If not
+///                          NULL then this is an array whose dimension is
+///                          [nLatitudes x nLongitudes].  This is
+///                          considerably more expensive than the elevation.
+/// @throws std::invalid_argument if the time is earlier than the year -1000
+///         or later than the year 2999, latitudes or longitudes is NULL, or
+///         a latitude or longitude is out of range.
+void computeSolarPositionGrid(double time,
+                              size_t nLatitudes,
+                              const double latitudes[],
+                              size_t nLongitudes,
+                              const double longitudes[],
+                              double elevations[],
+                              double azimuths[] = nullptr);
+}
+#endif
@@ -0,0 +1,174 @@
+#ifndef SOLARCALCULATOR_CATALOGFILE_HPP
+#define SOLARCALCULATOR_CATALOGFILE_HPP
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+namespace SolarCalculator
+{
+/// @brief The data type of a catalog column.
+enum class ColumnType : uint32_t
+{
+    Float64 = 0, /*!< 64 bit IEEE floating point. */
+    Int64 = 1    /*!< 64 bit signed integer. */
+};
+
+/// @class CatalogFile "catalogFile.hpp" "solarCalculator/catalogFile.hpp"
+/// @brief A memory-mapped, columnar binary catalog.  Inputs are read and
+///        results are written directly in the mapped pages so the batch
+///        solvers operate on the file without copies.
+///
+///        The file layout is, with all values in the host's (little-endian)
+///        byte order:
+///        - A 64 byte header: the magic "SCCATLOG" (8 bytes), the uint32
+///          version (1), the uint32 byte order mark 0x01020304, the uint32
+///          number of columns, the uint32 maximum number of columns (32),
+///          the uint64 number of rows, and zero padding.
+///        - A 1024 byte column directory of 32 entries.  Each 32 byte entry
+///          is a NUL padded name (16 bytes), the uint32 \c ColumnType, a
+///          uint32 of zero padding, and the uint64 byte offset of the
+///          column's data from the start of the file.
+///        - The columns.  Each column is nRows contiguous 8 byte values
+///          beginning on a 64 byte boundary.
+///
+///        By convention the inputs are the float64 columns "time" (UTC
+///        seconds from the epoch), "latitude", and "longitude" (degrees)
+///        and the results are "elevation" and "azimuth" (degrees).
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class CatalogFile
+{
+public:
+    /// @brief The maximum number of columns.
+    static constexpr size_t MAXIMUM_NUMBER_OF_COLUMNS = 32;
+    /// @brief The maximum length of a column name.
+    static constexpr size_t MAXIMUM_NAME_LENGTH = 15;
+
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    CatalogFile();
+    /// @brief Move constructor.
+    /// @param[in,out] catalog  The catalog from which to initialize this
+    ///                         class.  On exit, catalog's behavior is
+    ///                         undefined.
+    CatalogFile(CatalogFile &&catalog) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Move assignment operator.
+    /// @param[in,out] catalog  The catalog whose memory will be moved to
+    ///                         this.  On exit, catalog's behavior is
+    ///                         undefined.
+    /// @result The memory from catalog moved to this.
+    CatalogFile& operator=(CatalogFile &&catalog) noexcept;
+    /// @}
+
+    /// @name Opening and Closing
+    /// @{
+    /// @brief Creates a new catalog file, overwriting any existing file, and
+    ///        maps it for reading and writing.  The columns are zeroed.
+    /// @param[in] fileName  The name of the file.
+    /// @param[in] nRows     The number of rows.
+    /// @param[in] columns   The name and type of each column.
+    /// @throws std::invalid_argument if a name is empty, too long, or
+    ///         repeated, or there are too many columns.
+    /// @throws std::runtime_error if the file cannot be created or mapped.
+    void create(const std::string &fileName,
+                size_t nRows,
+                const std::vector<std::pair<std::string, ColumnType>> &columns);
+    /// @brief Maps an existing catalog file.
+    /// @param[in] fileName  The name of the file.
+    /// @param[in] writable  If true then the columns may be modified and
+    ///                      columns may be added.  Modifications are written
+    ///                      to the file.
+    /// @throws std::invalid_argument if the file does not exist.
+    /// @throws std::runtime_error if the file cannot be mapped or is not
+    ///         a valid catalog.
+    void open(const std::string &fileName, bool writable = false);
+    /// @result True indicates a file is mapped.
+    [[nodiscard]] bool isOpen() const noexcept;
+    /// @result True indicates the file is mapped for writing.
+    [[nodiscard]] bool isWritable() const noexcept;
+    /// @brief Schedules modifications to be written to the file.
+    /// @throws std::runtime_error if the file is not open.
+    void flush() const;
+    /// @brief Unmaps the file.  Modifications are written to the file.
+    void close() noexcept;
+    /// @}
+
+    /// @name Columns
+    /// @{
+    /// @brief Adds a zeroed column to the end of the file.
+    /// @param[in] name  The column name.
+    /// @param[in] type  The column type.
+    /// @throws std::invalid_argument if the name is empty, too long, or
+    ///         exists or the catalog has the maximum number of columns.
+    /// @throws std::runtime_error if the file is not open for writing.
+    /// @note This remaps the file so previously obtained column pointers
+    ///       are invalidated.
+    void addColumn(const std::string &name, ColumnType type);
+    /// @result The number of rows.
+    /// @throws std::runtime_error if the file is not open.
+    [[nodiscard]] size_t getNumberOfRows() const;
+    /// @result The column names in the order they appear in the file.
+    /// @throws std::runtime_error if the file is not open.
+    [[nodiscard]] std::vector<std::string> getColumnNames() const;
+    /// @param[in] name  The column name.
+    /// @result True indicates the column exists.
+    [[nodiscard]] bool haveColumn(const std::string &name) const noexcept;
+    /// @param[in] name  The column name.
+    /// @result The column's type.
+    /// @throws std::invalid_argument if the column does not exist.
+    [[nodiscard]] ColumnType getColumnType(const std::string &name) const;
+    /// @param[in] name  The column name.
+    /// @result A pointer to the column's values.  This is an array whose
+    ///         dimension is [\c getNumberOfRows()].
+    /// @throws std::invalid_argument if the column does not exist or is not
+    ///         float64.
+    [[nodiscard]] const double *getFloat64Column(const std::string &name) const;
+    /// @param[in] name  The column name.
+    /// @result A pointer to the column's values.  This is an array whose
+    ///         dimension is [\c getNumberOfRows()].
+    /// @throws std::invalid_argument if the column does not exist or is not
+    ///         float64.
+    /// @throws std::runtime_error if the file is not open for writing.
+    [[nodiscard]] double *getMutableFloat64Column(const std::string &name);
+    /// @param[in] name  The column name.
+    /// @result A pointer to the column's values.  This is an array whose
+    ///         dimension is [\c getNumberOfRows()].
+    /// @throws std::invalid_argument if the column does not exist or is not
+    ///         int64.
+    [[nodiscard]] const int64_t *getInt64Column(const std::string &name) const;
+    /// @param[in] name  The column name.
+    /// @result A pointer to the column's values.  This is an array whose
+    ///         dimension is [\c getNumberOfRows()].
+    /// @throws std::invalid_argument if the column does not exist or is not
+    ///         int64.
+    /// @throws std::runtime_error if the file is not open for writing.
+    [[nodiscard]] int64_t *getMutableInt64Column(const std::string &name);
+    /// @}
+
+    /// @brief Destructor.
+    ~CatalogFile();
+
+    CatalogFile(const CatalogFile &) = delete;
+    CatalogFile& operator=(const CatalogFile &) = delete;
+private:
+    class CatalogFileImpl;
+    std::unique_ptr<CatalogFileImpl> pImpl;
+};
+
+/// @brief Computes the solar elevation and azimuth of every row in a
+///        catalog in place.  The "elevation" and "azimuth" float64 columns
+///        are added if they do not exist.
+/// @param[in,out] catalog  A catalog open for writing with the "time",
+///                         "latitude", and "longitude" columns.  On exit,
+///                         the "elevation" and "azimuth" columns are set.
+/// @throws std::runtime_error if the catalog is not open for writing.
+/// @throws std::invalid_argument if an input column is missing or a row is
+///         invalid.
+void annotateCatalog(CatalogFile &catalog);
+}
+#endif
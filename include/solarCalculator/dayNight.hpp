@@ -0,0 +1,121 @@
+#ifndef SOLARCALCULATOR_DAYNIGHT_HPP
+#define SOLARCALCULATOR_DAYNIGHT_HPP
+#include <memory>
+namespace SolarCalculator
+{
+class Location;
+struct Observer;
+/// @class DayNightClassifier "dayNight.hpp" "solarCalculator/dayNight.hpp"
+/// @brief Answers "was it dark at this location at this time?".  The
+///        first query for a (location, day, depression angle) computes
+///        that day's rise and set times.  These are cached so subsequent
+///        queries cost a lookup and two comparisons.  Catalogs that cluster
+///        around a few hundred sites will almost always hit the cache.
+/// @note Days are local mean solar days (i.e., midnight to midnight in
+///       local mean time) so that each day has at most one daylight
+///       interval.
+/// @note This class is thread-safe.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class DayNightClassifier
+{
+public:
+    /// @brief The depression angle for sunrise and sunset.  This accounts
+    ///        for atmospheric refraction and the sun's semi-diameter.
+    static constexpr double SUNRISE_DEPRESSION_ANGLE = 0.833;
+    /// @brief The depression angle that ends civil twilight.
+    static constexpr double CIVIL_DEPRESSION_ANGLE = 6;
+    /// @brief The depression angle that ends nautical twilight.
+    static constexpr double NAUTICAL_DEPRESSION_ANGLE = 12;
+    /// @brief The depression angle that ends astronomical twilight.
+    static constexpr double ASTRONOMICAL_DEPRESSION_ANGLE = 18;
+
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    /// @param[in] capacity  The number of station-days retained.  This is
+    ///                      rounded up to the next power of 2.
+    /// @throws std::invalid_argument if capacity is 0.
+    explicit DayNightClassifier(size_t capacity = 65536);
+    /// @brief Move constructor.
+    /// @param[in,out] classifier  The classifier from which to initialize
+    ///                            this class.  On exit, classifier's
+    ///                            behavior is undefined.
+    DayNightClassifier(DayNightClassifier &&classifier) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Move assignment operator.
+    /// @param[in,out] classifier  The classifier whose memory will be moved
+    ///                            to this.  On exit, classifier's behavior
+    ///                            is undefined.
+    /// @result The memory from classifier moved to this.
+    DayNightClassifier& operator=(DayNightClassifier &&classifier) noexcept;
+    /// @}
+
+    /// @name Classification
+    /// @{
+    /// @param[in] time      The UTC time in seconds from the epoch.
+    /// @param[in] location  The location.
+    /// @param[in] depressionAngle  It is night when the sun's center is more
+    ///                             than this many degrees below the
+    ///                             geometric horizon.
+    /// @result True indicates that it is night.
+    /// @throws std::invalid_argument if the time is not in the years
+    ///         [-1000,2999], the location's latitude or longitude is not
+    ///         set, or the depression angle is not in [-90,90].
+    [[nodiscard]] bool isNight(double time,
+                               const Location &location,
+                               double depressionAngle = SUNRISE_DEPRESSION_ANGLE) const;
+    /// @param[in] time      The UTC time in seconds from the epoch.
+    /// @param[in] observer  The observer's latitude and longitude.
+    /// @param[in] depressionAngle  It is night when the sun's center is more
+    ///                             than this many degrees below the
+    ///                             geometric horizon.
+    /// @result True indicates that it is night.
+    /// @throws std::invalid_argument if the time is not in the years
+    ///         [-1000,2999], the latitude is not in [-90,90], or the
+    ///         depression angle is not in [-90,90].
+    [[nodiscard]] bool isNight(double time,
+                               const Observer &observer,
+                               double depressionAngle = SUNRISE_DEPRESSION_ANGLE) const;
+    /// @brief Classifies a catalog stored as a structure of arrays.
+    /// @param[in] nRows       The number of rows.
+    /// @param[in] times       The UTC times in seconds from the epoch.  This
+    ///                        is an array whose dimension is [nRows].
+    /// @param[in] latitudes   The latitudes in degrees.  This is an array
+    ///                        whose dimension is [nRows].
+    /// @param[in] longitudes  The longitudes in degrees.  This is an array
+    ///                        whose dimension is [nRows].
+    /// @param[out] isNight    isNight[i] is true if it was night for the
+    ///                        i'th row.  This is an array whose dimension is
+    ///                        [nRows].
+    /// @param[in] depressionAngle  It is night when the sun's center is more
+    ///                             than this many degrees below the
+    ///                             geometric horizon.
+    /// @throws std::invalid_argument if an array is NULL or a row is
+    ///         invalid.
+    void classify(size_t nRows,
+                  const double times[],
+                  const double latitudes[],
+                  const double longitudes[],
+                  bool isNight[],
+                  double depressionAngle = SUNRISE_DEPRESSION_ANGLE) const;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Empties the cache.
+    void clear() noexcept;
+    /// @brief Destructor.
+    ~DayNightClassifier();
+    /// @}
+
+    DayNightClassifier(const DayNightClassifier &) = delete;
+    DayNightClassifier& operator=(const DayNightClassifier &) = delete;
+private:
+    class DayNightClassifierImpl;
+    std::unique_ptr<DayNightClassifierImpl> pImpl;
+};
+}
+#endif
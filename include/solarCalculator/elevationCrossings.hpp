@@ -0,0 +1,72 @@
+#ifndef SOLARCALCULATOR_ELEVATIONCROSSINGS_HPP
+#define SOLARCALCULATOR_ELEVATIONCROSSINGS_HPP
+#include <vector>
+namespace SolarCalculator
+{
+struct Observer;
+/// @struct TimeInterval "elevationCrossings.hpp" "solarCalculator/elevationCrossings.hpp"
+/// @brief A closed interval of UTC times in seconds from the epoch.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+struct TimeInterval
+{
+    /// The start time.
+    double start = 0;
+    /// The end time.
+    double end = 0;
+};
+
+/// @brief Defines which side of an elevation threshold is sought.
+enum class ElevationRegion
+{
+    Below, /*!< The sun is below the threshold, e.g., night. */
+    Above  /*!< The sun is above the threshold, e.g., day. */
+};
+
+/// @brief Finds the times in a window at which the solar elevation, as
+///        returned by \c computePosition(), crosses a threshold.
+///
+///        The elevation is monotonic between the sun's upper and lower
+///        transits so the window is split at the (refined) transits and a
+///        half-day only holds a crossing if its end points are on opposite
+///        sides of the threshold.  Each crossing is then found with an
+///        Illinois regula falsi solve to better than a millisecond.  This
+///        costs about seven elevation evaluations per crossing plus four
+///        per half-day to bracket the crossings.
+/// @param[in] observer   The observer's latitude and longitude.
+/// @param[in] startTime  The UTC start time of the window in seconds from
+///                       the epoch.
+/// @param[in] endTime    The UTC end time of the window in seconds from the
+///                       epoch.
+/// @param[in] threshold  The elevation threshold in degrees, e.g., -6 for
+///                       civil twilight.
+/// @result The crossing times in increasing order.
+/// @throws std::invalid_argument if the window is not in the years
+///         [-1000,2999], startTime > endTime, the latitude is not in
+///         [-90,90], or the threshold is not in [-90,90].
+[[nodiscard]] std::vector<double>
+    findElevationCrossings(const Observer &observer,
+                           double startTime, double endTime,
+                           double threshold);
+/// @brief Finds the intervals of a window in which the solar elevation is
+///        below (or above) a threshold, e.g., night masks.
+/// @param[in] observer   The observer's latitude and longitude.
+/// @param[in] startTime  The UTC start time of the window in seconds from
+///                       the epoch.
+/// @param[in] endTime    The UTC end time of the window in seconds from the
+///                       epoch.
+/// @param[in] threshold  The elevation threshold in degrees.
+/// @param[in] region     Whether the intervals are below or above the
+///                       threshold.
+/// @result The disjoint intervals in increasing order.  Intervals that
+///         extend past the window are clipped to it.
+/// @throws std::invalid_argument if the window is not in the years
+///         [-1000,2999], startTime > endTime, the latitude is not in
+///         [-90,90], or the threshold is not in [-90,90].
+/// @sa \c findElevationCrossings()
+[[nodiscard]] std::vector<TimeInterval>
+    findElevationIntervals(const Observer &observer,
+                           double startTime, double endTime,
+                           double threshold,
+                           ElevationRegion region = ElevationRegion::Below);
+}
+#endif
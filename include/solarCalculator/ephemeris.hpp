@@ -0,0 +1,120 @@
+#ifndef SOLARCALCULATOR_EPHEMERIS_HPP
+#define SOLARCALCULATOR_EPHEMERIS_HPP
+#include <memory>
+namespace SolarCalculator
+{
+/// @class Ephemeris "ephemeris.hpp" "solarCalculator/ephemeris.hpp"
+/// @brief The time-only part of the solar calculation.  The declination,
+///        equation of time, and obliquity do not depend on the observer
+///        so they can be computed once for a time and reused for many
+///        locations.
+/// @note This is a small, trivially copyable value.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class Ephemeris
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    Ephemeris() = default;
+    /// @brief Computes the ephemeris at the given time.
+    /// @param[in] time  The UTC time in seconds from the epoch
+    ///                  (e.g., Jan 1 1970).
+    /// @throws std::invalid_argument if the time stamp is earlier than the
+    ///         year -1000 or greater than the year 2999.
+    explicit Ephemeris(double time);
+    /// @brief Constructs an ephemeris from precomputed terms, e.g., those
+    ///        interpolated from an \c EphemerisTable.
+    /// @param[in] time            The UTC time in seconds from the epoch.
+    /// @param[in] declination     The declination of the sun in degrees.
+    /// @param[in] equationOfTime  The equation of time in minutes.
+    /// @param[in] obliquity       The corrected obliquity of the ecliptic
+    ///                            in degrees.
+    Ephemeris(double time, double declination,
+              double equationOfTime, double obliquity) noexcept;
+    /// @}
+
+    /// @result The UTC time in seconds from the epoch at which the ephemeris
+    ///         was computed.
+    [[nodiscard]] double getTime() const noexcept;
+    /// @result The time measured in Julian centuries from J2000.0.
+    [[nodiscard]] double getJulianCentury() const noexcept;
+    /// @result The declination of the sun in degrees.
+    [[nodiscard]] double getDeclination() const noexcept;
+    /// @result The equation of time in minutes.
+    [[nodiscard]] double getEquationOfTime() const noexcept;
+    /// @result The corrected obliquity of the ecliptic in degrees.
+    [[nodiscard]] double getObliquity() const noexcept;
+private:
+    double mTime = 0;
+    double mJulianCentury = 0;
+    double mDeclination = 0;
+    double mEquationOfTime = 0;
+    double mObliquity = 0;
+};
+
+/// @class EphemerisCache "ephemeris.hpp" "solarCalculator/ephemeris.hpp"
+/// @brief A fixed-size cache of ephemerides keyed by quantized time.  This
+///        is useful when the same origin time is evaluated at many stations
+///        or the same station-day is evaluated for many events.
+/// @note This class is thread-safe; it may be shared by many threads and
+///       many \c Sun objects.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class EphemerisCache
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    /// @param[in] resolution  Times are rounded to the nearest multiple of
+    ///                        this many seconds before being looked up.  The
+    ///                        default of 1 second is exact for integral
+    ///                        epochal times.
+    /// @param[in] capacity    The number of ephemerides retained.  This is
+    ///                        rounded up to the next power of 2.
+    /// @throws std::invalid_argument if resolution or capacity is not
+    ///         positive.
+    explicit EphemerisCache(double resolution = 1, size_t capacity = 65536);
+    /// @brief Move constructor.
+    /// @param[in,out] cache  The cache from which to initialize this class.
+    ///                       On exit, cache's behavior is undefined.
+    EphemerisCache(EphemerisCache &&cache) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Move assignment operator.
+    /// @param[in,out] cache  The cache whose memory will be moved to this.
+    ///                       On exit, cache's behavior is undefined.
+    /// @result The memory from cache moved to this.
+    EphemerisCache& operator=(EphemerisCache &&cache) noexcept;
+    /// @}
+
+    /// @result The ephemeris at the given time rounded to the resolution.
+    ///         Near the ends of the years [-1000,2999] the time is instead
+    ///         rounded to a multiple of the resolution inside the range.
+    /// @param[in] time  The UTC time in seconds from the epoch.
+    /// @throws std::invalid_argument if the time stamp is earlier than the
+    ///         year -1000 or greater than the year 2999.
+    [[nodiscard]] Ephemeris getEphemeris(double time) const;
+    /// @result The time resolution in seconds.
+    [[nodiscard]] double getResolution() const noexcept;
+    /// @result The number of ephemerides the cache can hold.
+    [[nodiscard]] size_t getCapacity() const noexcept;
+
+    /// @name Destructors
+    /// @{
+    /// @brief Empties the cache.
+    void clear() noexcept;
+    /// @brief Destructor.
+    ~EphemerisCache();
+    /// @}
+
+    EphemerisCache(const EphemerisCache &) = delete;
+    EphemerisCache& operator=(const EphemerisCache &) = delete;
+private:
+    class EphemerisCacheImpl;
+    std::unique_ptr<EphemerisCacheImpl> pImpl;
+};
+}
+#endif
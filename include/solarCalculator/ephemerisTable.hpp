@@ -0,0 +1,128 @@
+#ifndef SOLARCALCULATOR_EPHEMERISTABLE_HPP
+#define SOLARCALCULATOR_EPHEMERISTABLE_HPP
+#include <memory>
+#include <string>
+namespace SolarCalculator
+{
+class Ephemeris;
+/// @class EphemerisTable "ephemerisTable.hpp" "solarCalculator/ephemerisTable.hpp"
+/// @brief Tabulates the declination, equation of time, and obliquity as
+///        piecewise Chebyshev series.  The time axis is divided into
+///        fixed-length segments and each series is fit by interpolating
+///        the NOAA formulas at the Chebyshev nodes of the segment.
+///        Evaluating the table then costs a short Clenshaw recurrence
+///        rather than a dozen trigonometric functions.
+/// @note Once initialized or loaded this class is read-only and may be
+///       shared by many threads.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class EphemerisTable
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    EphemerisTable();
+    /// @brief Move constructor.
+    /// @param[in,out] table  The table from which to initialize this class.
+    ///                       On exit, table's behavior is undefined.
+    EphemerisTable(EphemerisTable &&table) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Move assignment operator.
+    /// @param[in,out] table  The table whose memory will be moved to this.
+    ///                       On exit, table's behavior is undefined.
+    /// @result The memory from table moved to this.
+    EphemerisTable& operator=(EphemerisTable &&table) noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Fits the table.
+    /// @param[in] firstYear      The first year in the table.
+    /// @param[in] lastYear       The last year in the table.  The table
+    ///                           runs through the end of this year.
+    /// @param[in] segmentLength  The duration of each segment in seconds.
+    ///                           The default is 8 days.
+    /// @param[in] nCoefficients  The number of Chebyshev coefficients per
+    ///                           series in each segment.
+    /// @throws std::invalid_argument if the years are not in the range
+    ///         [-1000,2999], firstYear > lastYear, segmentLength is not
+    ///         positive, or nCoefficients is not in the range [2,32].
+    void initialize(int firstYear, int lastYear,
+                    double segmentLength = 8*86400,
+                    int nCoefficients = 8);
+    /// @brief Loads a table previously written by \c save().  The file is
+    ///        memory mapped rather than read.
+    /// @param[in] fileName  The name of the table file.
+    /// @throws std::invalid_argument if the file does not exist.
+    /// @throws std::runtime_error if the file cannot be mapped or is not
+    ///         a valid ephemeris table.
+    void load(const std::string &fileName);
+    /// @result True indicates the table was initialized or loaded.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @}
+
+    /// @brief Writes the table to a binary file.  The file consists of an
+    ///        80 byte header followed by the coefficients as native-endian
+    ///        doubles.  Each segment stores the declination, equation of
+    ///        time, and obliquity coefficients in that order.
+    /// @param[in] fileName  The name of the file to write.
+    /// @throws std::runtime_error if the table is not initialized or the
+    ///         file cannot be written.
+    void save(const std::string &fileName) const;
+
+    /// @result The ephemeris at the given time.
+    /// @param[in] time  The UTC time in seconds from the epoch.
+    /// @throws std::runtime_error if the table is not initialized.
+    /// @throws std::invalid_argument if the time is outside of the table.
+    [[nodiscard]] Ephemeris getEphemeris(double time) const;
+    /// @brief Evaluates the declination and equation of time.
+    /// @param[in] time             The UTC time in seconds from the epoch.
+    ///                             This must be in the table.
+    /// @param[out] declination     The declination of the sun in degrees.
+    /// @param[out] equationOfTime  The equation of time in minutes.
+    /// @note This does not check the time.  It is intended for inner loops
+    ///       whose inputs have already been validated.
+    void evaluate(double time,
+                  double *declination, double *equationOfTime) const noexcept;
+    /// @param[in] time  The UTC time in seconds from the epoch.
+    /// @result True indicates the time is in the table.
+    [[nodiscard]] bool contains(double time) const noexcept;
+
+    /// @result The UTC time in seconds from the epoch at which the table
+    ///         begins.
+    /// @throws std::runtime_error if the table is not initialized.
+    [[nodiscard]] double getStartTime() const;
+    /// @result The UTC time in seconds from the epoch at which the table
+    ///         ends.  Times must be less than this.
+    /// @throws std::runtime_error if the table is not initialized.
+    [[nodiscard]] double getEndTime() const;
+    /// @result The maximum absolute difference in degrees between the
+    ///         tabulated and analytic declinations measured at the
+    ///         Chebyshev extrema of every segment.
+    /// @throws std::runtime_error if the table is not initialized.
+    [[nodiscard]] double getMaximumDeclinationError() const;
+    /// @result The maximum absolute difference in minutes between the
+    ///         tabulated and analytic equations of time measured at the
+    ///         Chebyshev extrema of every segment.
+    /// @throws std::runtime_error if the table is not initialized.
+    [[nodiscard]] double getMaximumEquationOfTimeError() const;
+
+    /// @name Destructors
+    /// @{
+    /// @brief Releases the table.
+    void clear() noexcept;
+    /// @brief Destructor.
+    ~EphemerisTable();
+    /// @}
+
+    EphemerisTable(const EphemerisTable &) = delete;
+    EphemerisTable& operator=(const EphemerisTable &) = delete;
+private:
+    class EphemerisTableImpl;
+    std::unique_ptr<EphemerisTableImpl> pImpl;
+};
+}
+#endif
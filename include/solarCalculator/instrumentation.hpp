@@ -0,0 +1,92 @@
+#ifndef SOLARCALCULATOR_INSTRUMENTATION_HPP
+#define SOLARCALCULATOR_INSTRUMENTATION_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+/// @brief Opt-in performance counters and latency histograms.
+///
+///        The library only records these when it is configured with
+///        -DENABLE_INSTRUMENTATION=ON.  Otherwise the recording sites compile
+///        to nothing and \c snapshot() returns zeros.  When enabled, each
+///        thread increments its own counters so recording never contends
+///        between threads; \c snapshot() sums the threads.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+namespace SolarCalculator::Instrumentation
+{
+/// @brief The event counters.
+enum class Counter : int
+{
+    EphemerisEvaluations = 0, /*!< Ephemerides computed from the time. */
+    PositionEvaluations,      /*!< Calls to \c computePosition(). */
+    RiseSetSolves,            /*!< Rise/set solves on a local day. */
+    RiseSetSearches,          /*!< Next/previous rise or set searches. */
+    PolarJumps,               /*!< Jumps over a polar night or midnight
+                                   sun by a search. */
+    NaNResults,               /*!< Sunrises/sunsets that were NaN because
+                                   the sun did not rise or set. */
+    SunCacheHits,             /*!< Cached \c Sun results that were
+                                   reused. */
+    SunCacheMisses,           /*!< \c Sun results that were computed. */
+    EphemerisCacheHits,       /*!< \c EphemerisCache hits. */
+    EphemerisCacheMisses,     /*!< \c EphemerisCache misses. */
+    BatchRows,                /*!< Rows computed by the batch functions. */
+    AlmanacRows               /*!< Site-days computed by \c Almanac. */
+};
+/// @brief The number of counters.
+constexpr int NUMBER_OF_COUNTERS = 12;
+
+/// @brief The timed operations.
+enum class Timer : int
+{
+    SunUpdate = 0,  /*!< Computing a \c Sun result on a cache miss. */
+    RiseSetSearch,  /*!< A next/previous rise or set search. */
+    Batch,          /*!< A call to a batch function. */
+    Almanac         /*!< A call to \c Almanac::compute(). */
+};
+/// @brief The number of timers.
+constexpr int NUMBER_OF_TIMERS = 4;
+
+/// @brief The number of latency histogram bins.  Bin b counts latencies in
+///        [2^b, 2^(b+1)) nanoseconds; bin 0 also counts 0 nanoseconds.
+constexpr int NUMBER_OF_BINS = 48;
+
+/// @struct Snapshot "instrumentation.hpp" "solarCalculator/instrumentation.hpp"
+/// @brief The counters and histograms summed over all threads.
+struct Snapshot
+{
+    /// @result The count of the event.
+    [[nodiscard]] uint64_t getCount(Counter counter) const noexcept;
+    /// @result The latency histogram of the operation.
+    [[nodiscard]] const std::array<uint64_t, NUMBER_OF_BINS>&
+        getHistogram(Timer timer) const noexcept;
+    /// @result The number of times the operation was timed.
+    [[nodiscard]] uint64_t getNumberOfSamples(Timer timer) const noexcept;
+    /// @result An upper bound in nanoseconds on the given percentile of the
+    ///         operation's latency, i.e., the upper edge of the bin that
+    ///         contains the percentile.  This is 0 if there are no samples.
+    /// @param[in] timer       The operation.
+    /// @param[in] percentile  The percentile in the range [0,100].
+    [[nodiscard]] double getPercentile(Timer timer,
+                                       double percentile) const noexcept;
+
+    /// The counts indexed by \c Counter.
+    std::array<uint64_t, NUMBER_OF_COUNTERS> counts{};
+    /// The histograms indexed by \c Timer.
+    std::array<std::array<uint64_t, NUMBER_OF_BINS>, NUMBER_OF_TIMERS>
+        histograms{};
+};
+
+/// @result True indicates the library was built with instrumentation.
+[[nodiscard]] bool isEnabled() noexcept;
+/// @result The counters and histograms accumulated since the last
+///         \c reset().  Threads may continue recording while this runs so
+///         the snapshot is not an atomic cut across threads.
+[[nodiscard]] Snapshot snapshot();
+/// @brief Zeros the counters and histograms.
+void reset();
+/// @result The name of the counter, e.g., "RiseSetSolves".
+[[nodiscard]] const char *toString(Counter counter) noexcept;
+/// @result The name of the timer, e.g., "SunUpdate".
+[[nodiscard]] const char *toString(Timer timer) noexcept;
+}
+#endif
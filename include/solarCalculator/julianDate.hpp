@@ -0,0 +1,76 @@
+#ifndef SOLARCALCULATOR_JULIANDATE_HPP
+#define SOLARCALCULATOR_JULIANDATE_HPP
+namespace SolarCalculator
+{
+/// @name Julian Date Conversions
+/// @brief These convert UTC seconds from the epoch (Jan 1 1970) directly
+///        to Julian days and centuries.  This is pure arithmetic and
+///        avoids decomposing the time into a calendar date.  Fractional
+///        seconds are supported.
+/// @{
+
+/// @brief The Julian day of the epoch (1970-01-01 00:00:00 UTC).
+constexpr double EPOCH_JULIAN_DAY = 2440587.5;
+/// @brief The Julian day of J2000.0 (2000-01-01 12:00:00 UTC).
+constexpr double J2000_JULIAN_DAY = 2451545.0;
+/// @brief The UTC time in seconds from the epoch of J2000.0.
+constexpr double J2000_EPOCH = 946728000.0;
+/// @brief The UTC time in seconds from the epoch of -1000-01-01 00:00:00.
+///        This is the earliest time the solar calculator supports.
+constexpr double MINIMUM_EPOCH = -93724128000.0;
+/// @brief The UTC time in seconds from the epoch of 3000-01-01 00:00:00.
+///        Times must be less than this.
+constexpr double MAXIMUM_EPOCH = 32503680000.0;
+
+/// @param[in] time  The UTC time in seconds from the epoch.
+/// @result True indicates the time is in the supported years [-1000,2999].
+[[nodiscard]] constexpr bool isValidTime(const double time) noexcept
+{
+    return (time >= MINIMUM_EPOCH && time < MAXIMUM_EPOCH);
+}
+
+/// @param[in] year   The year in the proleptic Gregorian calendar.  Year 0
+///                   is 1 BCE.
+/// @param[in] month  The month in the range [1,12].
+/// @param[in] day    The day of the month.
+/// @result The number of days from the epoch to the start of the date.
+///         This is exact for negative years too.
+[[nodiscard]] constexpr long long daysFromCivil(const long long year,
+                                                const int month,
+                                                const int day) noexcept
+{
+    // Count from March 1 so the leap day ends the year
+    auto y = (month <= 2) ? year - 1 : year;
+    auto era = (y >= 0 ? y : y - 399)/400;
+    auto yearOfEra = y - era*400;
+    auto dayOfYear = (153*(month > 2 ? month - 3 : month + 9) + 2)/5 + day - 1;
+    auto dayOfEra = yearOfEra*365 + yearOfEra/4 - yearOfEra/100 + dayOfYear;
+    // 719468 days from 0000-03-01 to the epoch
+    return era*146097 + dayOfEra - 719468;
+}
+
+/// @param[in] time  The UTC time in seconds from the epoch.
+/// @result The corresponding Julian day.
+[[nodiscard]] constexpr double toJulianDay(const double time) noexcept
+{
+    return time/86400.0 + EPOCH_JULIAN_DAY;
+}
+
+/// @param[in] julianDay  The Julian day.
+/// @result The corresponding UTC time in seconds from the epoch.
+[[nodiscard]] constexpr double fromJulianDay(const double julianDay) noexcept
+{
+    return (julianDay - EPOCH_JULIAN_DAY)*86400.0;
+}
+
+/// @param[in] time  The UTC time in seconds from the epoch.
+/// @result The time in Julian centuries from J2000.0.
+/// @note This is computed relative to J2000.0 in seconds so, unlike going
+///       through the Julian day, it retains sub-millisecond precision.
+[[nodiscard]] constexpr double toJulianCentury(const double time) noexcept
+{
+    return (time - J2000_EPOCH)/(86400.0*36525.0);
+}
+/// @}
+}
+#endif
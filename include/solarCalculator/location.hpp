@@ -3,6 +3,7 @@
 #include <memory>
 namespace SolarCalculator
 {
+struct Observer;
 /// @class Location "location.hpp" "solarCalculator/location.hpp"
 /// @brief Defines a computation location by a latitude and longitude.
 /// @copyright Ben Baker (University of Utah) distributed under the MIT license.
@@ -18,6 +19,12 @@ public:
     /// @param[in] longitude   The location's longitude in degrees.
     /// @sa \c setLatitude(), \c setLongitude().
     Location(double latitude, double longitude);
+    /// @brief Creates a location from an observer.
+    /// @param[in] observer  The observer's latitude and longitude.
+    /// @throws std::invalid_argument if the latitude or longitude is out of
+    ///         range.
+    /// @sa \c setLatitude(), \c setLongitude().
+    explicit Location(const Observer &observer);
     /// @brief Copy constructor.
     /// @param[in] location   The location class from which to initialize
     ///                       this class.
@@ -70,6 +77,11 @@ public:
     [[nodiscard]] bool haveLongitude() const noexcept;
     /// @}
 
+    /// @result The location as a trivially copyable observer.
+    /// @throws std::runtime_error if \c haveLatitude() or \c haveLongitude()
+    ///         is false.
+    [[nodiscard]] Observer getObserver() const;
+
     /// @name Destructors
     /// @{
     /// @brief Destructor.
@@ -0,0 +1,101 @@
+#ifndef SOLARCALCULATOR_PARALLELENGINE_HPP
+#define SOLARCALCULATOR_PARALLELENGINE_HPP
+#include <memory>
+#include <functional>
+namespace SolarCalculator
+{
+/// @class ParallelEngine "parallelEngine.hpp" "solarCalculator/parallelEngine.hpp"
+/// @brief A thread pool that splits a large catalog into fixed-size chunks
+///        and balances them with work-stealing.  Each thread starts with a
+///        contiguous share of the chunks and, when it runs out, steals half
+///        of the remaining chunks from another thread.  This keeps every
+///        core busy even when some rows (e.g., polar sunrise/sunset
+///        searches) are far more expensive than others.
+/// @note The rows are independent so the results do not depend on the
+///       number of threads.
+/// @note Concerning what is safe to share between threads: \c Location,
+///       \c Sun, and \c Ephemeris objects may be read concurrently but
+///       should not be modified by one thread while used by another, so a
+///       task that sets the time or location must own its \c Sun, e.g., a
+///       copy or one constructed in the task.  The free functions (e.g.,
+///       \c computeSolarPositions(), \c computePosition()) are stateless
+///       and the \c EphemerisCache is synchronized, so they may be called
+///       from any thread.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class ParallelEngine
+{
+public:
+    /// @brief The function invoked on a chunk.  The arguments are the first
+    ///        row, one past the last row, and the index of the calling
+    ///        thread which is in the range [0, \c getNumberOfThreads()).
+    using ChunkFunction = std::function<void (size_t, size_t, int)>;
+
+    /// @name Constructors
+    /// @{
+    /// @brief Constructs an engine with one thread per hardware thread.
+    ParallelEngine();
+    /// @brief Constructs an engine with the given number of threads.
+    /// @param[in] nThreads  The number of threads.  This includes the
+    ///                      calling thread which also performs work.
+    /// @throws std::invalid_argument if nThreads is not positive.
+    explicit ParallelEngine(int nThreads);
+    /// @}
+
+    /// @name Parameters
+    /// @{
+    /// @result The number of threads, including the calling thread.
+    [[nodiscard]] int getNumberOfThreads() const noexcept;
+    /// @brief Sets the number of rows in each chunk.
+    /// @param[in] grainSize  The number of rows per chunk.  Smaller chunks
+    ///                       balance better but cost more synchronization.
+    /// @throws std::invalid_argument if grainSize is 0.
+    /// @throws std::runtime_error if called from within a chunk function.
+    /// @note This waits for a running \c parallelFor() to finish.
+    void setGrainSize(size_t grainSize);
+    /// @result The number of rows per chunk.  By default this is 1024.
+    [[nodiscard]] size_t getGrainSize() const noexcept;
+    /// @}
+
+    /// @name Execution
+    /// @{
+    /// @brief Applies the function to the rows [0, nRows) in chunks.
+    /// @param[in] nRows     The number of rows.
+    /// @param[in] function  The function to apply to each chunk.  Chunks
+    ///                      are disjoint and together cover every row once.
+    /// @throws Rethrows the first exception raised by function.  No chunk
+    ///         is started after it is raised so some chunks may not have
+    ///         been processed.
+    /// @throws std::runtime_error if called from within a chunk function
+    ///         of this engine.  A chunk function must not call back into
+    ///         its engine.
+    /// @note Calls from different threads are serialized.
+    void parallelFor(size_t nRows, const ChunkFunction &function);
+    /// @brief Computes the solar position for a catalog in parallel.
+    /// @sa \c SolarCalculator::computeSolarPositions() for the parameters.
+    /// @throws std::invalid_argument if times, latitudes, or longitudes is
+    ///         NULL, a time is earlier than the year -1000 or later than the
+    ///         year 2999, or a latitude or longitude is out of range.
+    void computeSolarPositions(size_t nRows,
+                               const double times[],
+                               const double latitudes[],
+                               const double longitudes[],
+                               double elevations[],
+                               double azimuths[] = nullptr,
+                               double declinations[] = nullptr,
+                               double equationsOfTime[] = nullptr);
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.  This joins the threads.
+    ~ParallelEngine();
+    /// @}
+
+    ParallelEngine(const ParallelEngine &) = delete;
+    ParallelEngine& operator=(const ParallelEngine &) = delete;
+private:
+    class ParallelEngineImpl;
+    std::unique_ptr<ParallelEngineImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,154 @@
+#ifndef SOLARCALCULATOR_QUERYCLIENT_HPP
+#define SOLARCALCULATOR_QUERYCLIENT_HPP
+#include <memory>
+#include <string>
+namespace SolarCalculator
+{
+/// @class QueryClient "queryClient.hpp" "solarCalculator/queryClient.hpp"
+/// @brief A blocking client of a \c QueryServer.  Each call sends one
+///        request and waits for its response.  Catalogs with more than
+///        QueryProtocol::MAXIMUM_ROWS rows are sent as several requests.
+/// @note This class is not thread-safe.  Threads that query concurrently
+///       should each have their own client; the server coalesces their
+///       requests.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class QueryClient
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    QueryClient();
+    /// @brief Move constructor.
+    /// @param[in,out] client  The client from which to initialize this
+    ///                        class.  On exit, client's behavior is
+    ///                        undefined.
+    QueryClient(QueryClient &&client) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Move assignment operator.
+    /// @param[in,out] client  The client whose connection will be moved to
+    ///                        this.  On exit, client's behavior is
+    ///                        undefined.
+    /// @result The connection from client moved to this.
+    QueryClient& operator=(QueryClient &&client) noexcept;
+    /// @}
+
+    /// @name Connection
+    /// @{
+    /// @brief Connects to a server.  Any existing connection is closed.
+    /// @param[in] socketPath  The path of the server's Unix domain socket.
+    /// @throws std::invalid_argument if the socket path is empty or longer
+    ///         than QueryProtocol::MAXIMUM_SOCKET_PATH_LENGTH.
+    /// @throws std::runtime_error if the connection fails.
+    void connect(const std::string &socketPath);
+    /// @result True indicates the client is connected.
+    [[nodiscard]] bool isConnected() const noexcept;
+    /// @brief Closes the connection.
+    void disconnect() noexcept;
+    /// @}
+
+    /// @name Queries
+    /// @{
+    /// @brief Computes the solar elevation and azimuth.
+    /// @param[in] nRows        The number of rows.
+    /// @param[in] times        The UTC times in seconds from the epoch.
+    ///                         This is an array whose dimension is [nRows].
+    /// @param[in] latitudes    The latitudes in degrees.  This is an array
+    ///                         whose dimension is [nRows].
+    /// @param[in] longitudes   The longitudes in degrees.  This is an array
+    ///                         whose dimension is [nRows].
+    /// @param[out] elevations  The solar elevation in degrees.  This is an
+    ///                         array whose dimension is [nRows].
+    /// @param[out] azimuths    The solar azimuth in degrees measured
+    ///                         clockwise from north.  If not NULL then this
+    ///                         is an array whose dimension is [nRows].
+    /// @throws std::invalid_argument if an input array or elevations is
+    ///         NULL or the server rejects a row.
+    /// @throws std::runtime_error if the client is not connected or the
+    ///         connection fails.  The connection is closed in this case.
+    void computePositions(size_t nRows,
+                          const double times[],
+                          const double latitudes[],
+                          const double longitudes[],
+                          double elevations[],
+                          double azimuths[] = nullptr);
+    /// @brief Classifies rows as day or night.
+    /// @param[in] nRows       The number of rows.
+    /// @param[in] times       The UTC times in seconds from the epoch.  This
+    ///                        is an array whose dimension is [nRows].
+    /// @param[in] latitudes   The latitudes in degrees.  This is an array
+    ///                        whose dimension is [nRows].
+    /// @param[in] longitudes  The longitudes in degrees.  This is an array
+    ///                        whose dimension is [nRows].
+    /// @param[out] isNight    isNight[i] is true if it was night for the
+    ///                        i'th row.  This is an array whose dimension is
+    ///                        [nRows].
+    /// @param[in] depressionAngle  It is night when the sun's center is more
+    ///                             than this many degrees below the
+    ///                             geometric horizon.
+    /// @throws std::invalid_argument if an array is NULL or the server
+    ///         rejects a row or the depression angle.
+    /// @throws std::runtime_error if the client is not connected or the
+    ///         connection fails.  The connection is closed in this case.
+    /// @sa \c DayNightClassifier
+    void classifyDayNight(size_t nRows,
+                          const double times[],
+                          const double latitudes[],
+                          const double longitudes[],
+                          bool isNight[],
+                          double depressionAngle = 0.833);
+    /// @brief Computes the sunrise, sunset, and solar noon of the local
+    ///        mean solar day containing each row's time.
+    /// @param[in] nRows        The number of rows.
+    /// @param[in] times        The UTC times in seconds from the epoch.
+    ///                         This is an array whose dimension is [nRows].
+    /// @param[in] latitudes    The latitudes in degrees.  This is an array
+    ///                         whose dimension is [nRows].
+    /// @param[in] longitudes   The longitudes in degrees.  This is an array
+    ///                         whose dimension is [nRows].
+    /// @param[out] sunrises    The sunrise in UTC seconds from the epoch or
+    ///                         NaN if the sun does not rise or set that
+    ///                         day.  This is an array whose dimension is
+    ///                         [nRows].
+    /// @param[out] sunsets     The sunset in UTC seconds from the epoch or
+    ///                         NaN if the sun does not rise or set that
+    ///                         day.  This is an array whose dimension is
+    ///                         [nRows].
+    /// @param[out] solarNoons  The solar noon in UTC seconds from the
+    ///                         epoch.  If not NULL then this is an array
+    ///                         whose dimension is [nRows].
+    /// @param[in] depressionAngle  The sun rises and sets when its center
+    ///                             is this many degrees below the geometric
+    ///                             horizon.
+    /// @throws std::invalid_argument if an input array, sunrises, or
+    ///         sunsets is NULL or the server rejects a row or the
+    ///         depression angle.
+    /// @throws std::runtime_error if the client is not connected or the
+    ///         connection fails.  The connection is closed in this case.
+    void computeRiseSet(size_t nRows,
+                        const double times[],
+                        const double latitudes[],
+                        const double longitudes[],
+                        double sunrises[],
+                        double sunsets[],
+                        double solarNoons[] = nullptr,
+                        double depressionAngle = 0.833);
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.  This closes the connection.
+    ~QueryClient();
+    /// @}
+
+    QueryClient(const QueryClient &) = delete;
+    QueryClient& operator=(const QueryClient &) = delete;
+private:
+    class QueryClientImpl;
+    std::unique_ptr<QueryClientImpl> pImpl;
+};
+}
+#endif
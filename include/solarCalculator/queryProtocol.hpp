@@ -0,0 +1,96 @@
+#ifndef SOLARCALCULATOR_QUERYPROTOCOL_HPP
+#define SOLARCALCULATOR_QUERYPROTOCOL_HPP
+#include <cstddef>
+#include <cstdint>
+/// @brief The binary format spoken between a \c QueryClient and a
+///        \c QueryServer over a Unix domain stream socket.
+///
+///        A request is a RequestHeader followed by nRows Rows.  A response
+///        is a ResponseHeader followed by either nRows results or, if the
+///        status is not Success, a messageLength byte error message.  The
+///        results are a PositionResult, a uint8_t (1 is night), or a
+///        RiseSetResult per row for Position, DayNight, and RiseSet
+///        requests, respectively.  Every field is in the host's byte order
+///        since the socket is local.  A client may pipeline requests; the
+///        responses are returned in the order of the requests.
+namespace SolarCalculator::QueryProtocol
+{
+/// @brief Begins every request and response.  This is "SCQ1".
+constexpr uint32_t MAGIC = 0x31514353;
+/// @brief The most rows in a request.
+constexpr uint64_t MAXIMUM_ROWS = 1 << 22;
+/// @brief The longest socket path.  This is the length of sun_path less
+///        the terminating null.
+constexpr size_t MAXIMUM_SOCKET_PATH_LENGTH = 107;
+
+/// @brief The request types.
+enum class RequestType : uint32_t
+{
+    Position = 1, /*!< The solar elevation and azimuth. */
+    DayNight = 2, /*!< Whether it is night.  The parameter is the
+                       depression angle in degrees. */
+    RiseSet = 3   /*!< The sunrise, sunset, and solar noon of the local
+                       mean solar day containing the time.  The parameter
+                       is the depression angle in degrees. */
+};
+
+/// @brief The response status.
+enum class Status : uint32_t
+{
+    Success = 0,         /*!< The results follow. */
+    InvalidArgument = 1, /*!< A row, the type, or the parameter is
+                              invalid.  The message follows. */
+    InternalError = 2    /*!< The server failed.  The message follows. */
+};
+
+/// @brief The request header.
+struct RequestHeader
+{
+    uint32_t magic = MAGIC;  /*!< Must be MAGIC. */
+    uint32_t type = 0;       /*!< The RequestType. */
+    uint64_t id = 0;         /*!< Echoed in the response. */
+    uint64_t nRows = 0;      /*!< The number of rows that follow. */
+    double parameter = 0;    /*!< The request type's parameter. */
+};
+
+/// @brief A row of a request.
+struct Row
+{
+    double time = 0;         /*!< UTC seconds from the epoch. */
+    double latitude = 0;     /*!< Degrees in [-90,90]. */
+    double longitude = 0;    /*!< Degrees in [-540,540). */
+};
+
+/// @brief The response header.
+struct ResponseHeader
+{
+    uint32_t magic = MAGIC;     /*!< MAGIC. */
+    uint32_t status = 0;        /*!< The Status. */
+    uint64_t id = 0;            /*!< The request's identifier. */
+    uint64_t nRows = 0;         /*!< The number of results that follow. */
+    uint64_t messageLength = 0; /*!< The length of the error message. */
+};
+
+/// @brief The result of a Position request.
+struct PositionResult
+{
+    double elevation = 0;    /*!< Degrees above the horizon. */
+    double azimuth = 0;      /*!< Degrees clockwise from north. */
+};
+
+/// @brief The result of a RiseSet request.  The sunrise and sunset are NaN
+///        if the sun does not rise or set that day.
+struct RiseSetResult
+{
+    double sunrise = 0;      /*!< UTC seconds from the epoch. */
+    double sunset = 0;       /*!< UTC seconds from the epoch. */
+    double solarNoon = 0;    /*!< UTC seconds from the epoch. */
+};
+
+static_assert(sizeof(RequestHeader) == 32, "RequestHeader must be 32 bytes");
+static_assert(sizeof(Row) == 24, "Row must be 24 bytes");
+static_assert(sizeof(ResponseHeader) == 32, "ResponseHeader must be 32 bytes");
+static_assert(sizeof(PositionResult) == 16, "PositionResult must be 16 bytes");
+static_assert(sizeof(RiseSetResult) == 24, "RiseSetResult must be 24 bytes");
+}
+#endif
@@ -0,0 +1,90 @@
+#ifndef SOLARCALCULATOR_QUERYSERVER_HPP
+#define SOLARCALCULATOR_QUERYSERVER_HPP
+#include <memory>
+#include <string>
+#include <cstdint>
+namespace SolarCalculator
+{
+/// @class QueryServer "queryServer.hpp" "solarCalculator/queryServer.hpp"
+/// @brief Answers sun position, day/night, and rise/set queries from other
+///        processes on the same machine over a Unix domain socket.  The
+///        wire format is described in \c QueryProtocol.
+///
+///        A single I/O thread polls the connections.  Every request that
+///        has fully arrived when the thread wakes is answered as one batch:
+///        the position rows of all requests are concatenated and evaluated
+///        together, in parallel when there are many.  There is no timer so
+///        a lone query is answered as soon as it arrives, while concurrent
+///        clients are coalesced automatically because requests accumulate
+///        while the previous batch is being computed.  A batch takes a
+///        bounded slice of each request's rows so a bulk request is answered
+///        over several batches and does not hold up small ones.  Responses
+///        on a connection are returned in the order of its requests.
+///
+///        The server keeps an ephemeris table of the given years and a
+///        day/night and rise/set cache warm for its lifetime.  Positions
+///        whose times are in the table are interpolated from it, which
+///        agrees with \c computeSolarPositions() to 1.e-6 degrees; the
+///        others are computed exactly.  A row's result therefore does not
+///        depend on how requests were batched.
+/// @note Requests are validated individually.  An invalid row fails only
+///       the request containing it.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class QueryServer
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    QueryServer();
+    /// @}
+
+    /// @name Lifetime
+    /// @{
+    /// @brief Binds the socket and starts the I/O thread.  A stale socket
+    ///        file at the path is removed.
+    /// @param[in] socketPath  The path of the Unix domain socket.
+    /// @param[in] firstYear   The first year of the ephemeris table.
+    /// @param[in] lastYear    The last year of the ephemeris table.
+    /// @throws std::invalid_argument if the socket path is empty or longer
+    ///         than QueryProtocol::MAXIMUM_SOCKET_PATH_LENGTH or the years
+    ///         are invalid; see \c EphemerisTable::initialize().
+    /// @throws std::runtime_error if the server is already running or the
+    ///         socket cannot be created.
+    void start(const std::string &socketPath,
+               int firstYear = 1900, int lastYear = 2100);
+    /// @result True indicates the server is running.
+    [[nodiscard]] bool isRunning() const noexcept;
+    /// @result The path of the socket.
+    /// @throws std::runtime_error if the server is not running.
+    [[nodiscard]] std::string getSocketPath() const;
+    /// @brief Closes every connection, stops the I/O thread, and removes
+    ///        the socket file.
+    void stop() noexcept;
+    /// @}
+
+    /// @name Statistics
+    /// @{
+    /// @result The number of requests answered since the server started.
+    [[nodiscard]] uint64_t getNumberOfRequests() const noexcept;
+    /// @result The number of batches in which those requests were
+    ///         answered.  A bulk request spans several batches.  Otherwise,
+    ///         the ratio of requests to batches measures how much the server
+    ///         is coalescing.
+    [[nodiscard]] uint64_t getNumberOfBatches() const noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.  This stops the server.
+    ~QueryServer();
+    /// @}
+
+    QueryServer(const QueryServer &) = delete;
+    QueryServer& operator=(const QueryServer &) = delete;
+private:
+    class QueryServerImpl;
+    std::unique_ptr<QueryServerImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,119 @@
+#ifndef SOLARCALCULATOR_SOLARPOSITION_HPP
+#define SOLARCALCULATOR_SOLARPOSITION_HPP
+#include <cstddef>
+#include "solarCalculator/accuracy.hpp"
+namespace SolarCalculator
+{
+class Ephemeris;
+class StationSet;
+/// @struct Observer "solarPosition.hpp" "solarCalculator/solarPosition.hpp"
+/// @brief A trivially copyable observer position.  Unlike \c Location this
+///        does not allocate and does not validate its values.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+struct Observer
+{
+    /// The latitude in degrees where positive is north.  This should be
+    /// in the range [-90,90].
+    double latitude = 0;
+    /// The longitude in degrees where positive is east.
+    double longitude = 0;
+};
+
+/// @struct SolarPosition "solarPosition.hpp" "solarCalculator/solarPosition.hpp"
+/// @brief The sun's position as seen by an observer at a given time.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+struct SolarPosition
+{
+    /// The angle between the sun and the horizon in degrees.
+    double elevation = 0;
+    /// The azimuth of the sun in degrees measured positive clockwise
+    /// from true north.
+    double azimuth = 0;
+    /// The declination of the sun in degrees.
+    double declination = 0;
+    /// The equation of time in minutes.
+    double equationOfTime = 0;
+};
+
+/// @brief Computes the solar position.  This does not allocate memory or
+///        throw exceptions.
+/// @param[in] time      The UTC time in seconds from the epoch
+///                      (e.g., Jan 1 1970).
+/// @param[in] observer  The observer's latitude and longitude.
+/// @result The solar position.  If the time is not in the years
+///         [-1000,2999] or the latitude is not in the range [-90,90]
+///         then every field is NaN.
+[[nodiscard]] SolarPosition computePosition(double time,
+                                            const Observer &observer) noexcept;
+/// @brief Computes the solar position at the given accuracy.  This does
+///        not allocate memory or throw exceptions.
+/// @param[in] time      The UTC time in seconds from the epoch.
+/// @param[in] observer  The observer's latitude and longitude.
+/// @param[in] accuracy  Accuracy::Exact is identical to the
+///                      \c computePosition() without an accuracy.
+///                      Accuracy::Fast replaces the standard library's
+///                      trigonometric functions with polynomials; see
+///                      \c Accuracy for the error bounds.
+/// @result The solar position.  If the time is not in the years
+///         [-1000,2999] or the latitude is not in the range [-90,90]
+///         then every field is NaN.
+[[nodiscard]] SolarPosition computePosition(double time,
+                                            const Observer &observer,
+                                            Accuracy accuracy) noexcept;
+/// @brief Computes the solar position.  This does not allocate memory or
+///        throw exceptions.
+/// @param[in] time       The UTC time in seconds from the epoch.
+/// @param[in] latitude   The observer's latitude in degrees.
+/// @param[in] longitude  The observer's longitude in degrees.
+/// @result The solar position.  If the time is not in the years
+///         [-1000,2999] or the latitude is not in the range [-90,90]
+///         then every field is NaN.
+[[nodiscard]] SolarPosition computePosition(double time,
+                                            double latitude,
+                                            double longitude) noexcept;
+/// @brief Computes the solar position from a precomputed ephemeris.
+/// @param[in] time       The UTC time in seconds from the epoch.  This
+///                       defines the hour angle.
+/// @param[in] ephemeris  The declination and equation of time.  This is
+///                       usually computed at or near time.
+/// @param[in] observer   The observer's latitude and longitude.
+/// @result The solar position.  If the latitude is not in the range
+///         [-90,90] then every field is NaN.
+[[nodiscard]] SolarPosition computePosition(double time,
+                                            const Ephemeris &ephemeris,
+                                            const Observer &observer) noexcept;
+/// @brief Computes the solar position at a registered site.  This does
+///        not allocate memory or throw exceptions.
+/// @param[in] time      The UTC time in seconds from the epoch.
+/// @param[in] stations  The station set.
+/// @param[in] site      The index of the site in the station set.
+/// @result The solar position.  If the time is not in the years
+///         [-1000,2999] or the site index is out of range then every
+///         field is NaN.
+[[nodiscard]] SolarPosition computePosition(double time,
+                                            const StationSet &stations,
+                                            size_t site) noexcept;
+/// @brief Computes the solar position at a registered site from a
+///        precomputed ephemeris.
+/// @param[in] time       The UTC time in seconds from the epoch.  This
+///                       defines the hour angle.
+/// @param[in] ephemeris  The declination and equation of time.
+/// @param[in] stations   The station set.
+/// @param[in] site       The index of the site in the station set.
+/// @result The solar position.  If the site index is out of range then
+///         every field is NaN.
+[[nodiscard]] SolarPosition computePosition(double time,
+                                            const Ephemeris &ephemeris,
+                                            const StationSet &stations,
+                                            size_t site) noexcept;
+/// @brief Computes the subsolar point, i.e., where the sun is at the
+///        zenith.  The solar elevation at any site is the arcsine of the
+///        dot product of the subsolar point's and the site's unit vectors.
+///        This does not allocate memory or throw exceptions.
+/// @param[in] time  The UTC time in seconds from the epoch.
+/// @result The subsolar point.  The latitude is the declination and the
+///         longitude is in [-180,180).  If the time is not in the years
+///         [-1000,2999] then both fields are NaN.
+[[nodiscard]] Observer computeSubsolarPoint(double time) noexcept;
+}
+#endif
@@ -0,0 +1,132 @@
+#ifndef SOLARCALCULATOR_STATIONSET_HPP
+#define SOLARCALCULATOR_STATIONSET_HPP
+#include <memory>
+#include <string>
+namespace SolarCalculator
+{
+class Location;
+struct Observer;
+/// @struct Site "stationSet.hpp" "solarCalculator/stationSet.hpp"
+/// @brief A registered site with the latitude's trigonometry precomputed.
+///        This is a 32 byte, trivially copyable record.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+struct Site
+{
+    /// The latitude in degrees in the range [-90,90].
+    double latitude = 0;
+    /// The longitude in degrees normalized to the range [0,360).
+    double longitude = 0;
+    /// The sine of the latitude.
+    double sinLatitude = 0;
+    /// The cosine of the latitude.
+    double cosLatitude = 1;
+};
+
+/// @class StationSet "stationSet.hpp" "solarCalculator/stationSet.hpp"
+/// @brief A registry of stations and sites (e.g., network stations and
+///        quarries).  The sites are stored contiguously in insertion order
+///        so a site is identified by its index.  Solvers that take a
+///        station set and index avoid re-deriving the latitude's sine and
+///        cosine for every time.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class StationSet
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    StationSet();
+    /// @brief Copy constructor.
+    /// @param[in] stations  The station set from which to initialize this
+    ///                      class.
+    StationSet(const StationSet &stations);
+    /// @brief Move constructor.
+    /// @param[in,out] stations  The station set from which to initialize
+    ///                          this class.  On exit, stations' behavior is
+    ///                          undefined.
+    StationSet(StationSet &&stations) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] stations  The station set to copy to this.
+    /// @result A deep copy of the station set.
+    StationSet& operator=(const StationSet &stations);
+    /// @brief Move assignment operator.
+    /// @param[in,out] stations  The station set whose memory will be moved
+    ///                          to this.  On exit, stations' behavior is
+    ///                          undefined.
+    /// @result The memory from stations moved to this.
+    StationSet& operator=(StationSet &&stations) noexcept;
+    /// @}
+
+    /// @name Registration
+    /// @{
+    /// @brief Adds a site.
+    /// @param[in] observer  The site's latitude and longitude in degrees.
+    /// @param[in] name      The site's name, e.g., UU.CTU.  This may be
+    ///                      empty.
+    /// @result The index of the site.
+    /// @throws std::invalid_argument if the latitude is not in the range
+    ///         [-90,90], the longitude is not in the range [-540,540), or
+    ///         the name is not empty and already registered.
+    size_t add(const Observer &observer, const std::string &name = "");
+    /// @brief Adds a site.
+    /// @param[in] location  The site's location.
+    /// @param[in] name      The site's name.  This may be empty.
+    /// @result The index of the site.
+    /// @throws std::invalid_argument if the location's latitude or longitude
+    ///         is not set or the name is not empty and already registered.
+    size_t add(const Location &location, const std::string &name = "");
+    /// @brief Reserves space for the given number of sites.
+    /// @param[in] nSites  The anticipated number of sites.
+    void reserve(size_t nSites);
+    /// @}
+
+    /// @result The number of sites.
+    [[nodiscard]] size_t size() const noexcept;
+    /// @param[in] index  The site index.
+    /// @result The site.
+    /// @throws std::invalid_argument if index is not less than \c size().
+    [[nodiscard]] const Site& getSite(size_t index) const;
+    /// @result A pointer to the sites.  This is an array whose dimension
+    ///         is [\c size()].
+    [[nodiscard]] const Site *getSites() const noexcept;
+    /// @result The x components of the sites' Earth-centered unit vectors,
+    ///         cos(latitude)*cos(longitude).  This is an array whose
+    ///         dimension is [\c size()].
+    [[nodiscard]] const double *getUnitVectorsX() const noexcept;
+    /// @result The y components of the sites' Earth-centered unit vectors,
+    ///         cos(latitude)*sin(longitude).  This is an array whose
+    ///         dimension is [\c size()].
+    [[nodiscard]] const double *getUnitVectorsY() const noexcept;
+    /// @result The z components of the sites' Earth-centered unit vectors,
+    ///         sin(latitude).  This is an array whose dimension is
+    ///         [\c size()].
+    [[nodiscard]] const double *getUnitVectorsZ() const noexcept;
+    /// @param[in] index  The site index.
+    /// @result The site's name.
+    /// @throws std::invalid_argument if index is not less than \c size().
+    [[nodiscard]] std::string getName(size_t index) const;
+    /// @param[in] name  The site's name.
+    /// @result The index of the named site.
+    /// @throws std::invalid_argument if the name is not registered.
+    [[nodiscard]] size_t getIndex(const std::string &name) const;
+    /// @param[in] name  The site's name.
+    /// @result True indicates the name is registered.
+    [[nodiscard]] bool haveSite(const std::string &name) const noexcept;
+
+    /// @name Destructors
+    /// @{
+    /// @brief Removes all sites.
+    void clear() noexcept;
+    /// @brief Destructor.
+    ~StationSet();
+    /// @}
+private:
+    class StationSetImpl;
+    std::unique_ptr<StationSetImpl> pImpl;
+};
+}
+#endif
@@ -4,10 +4,15 @@
 namespace SolarCalculator
 {
 class Location;
+class EphemerisCache;
 /// @class Sun "sun.hpp" "solarCalculator/sun.hpp"
 /// @brief This class performs the solar calculator computations and will,
 ///        for example, compute the sun's azimuth, elevation, etc. at a
 ///        a position for a given time.
+/// @note The results are computed on first access and cached until the
+///       time or location changes.  The cache is synchronized so several
+///       threads may call the const getters of one \c Sun at once.  The
+///       setters must not run concurrently with any other call.
 /// @copyright Ben Baker (University of Utah) distributed under the MIT license.
 class Sun
 {
@@ -64,6 +69,14 @@ public:
     /// @result True indicates that the time was set.
     [[nodiscard]] bool haveTime() const noexcept;
  
+    /// @brief Shares an ephemeris cache with this class.  The declination
+    ///        and equation of time only depend on the time, so when many
+    ///        \c Sun objects (e.g., one per station) are evaluated at the
+    ///        same times they can be looked up rather than recomputed.
+    /// @param[in] cache  The ephemeris cache.  If this is NULL then the
+    ///                   ephemeris will be computed directly.
+    void setEphemerisCache(std::shared_ptr<const EphemerisCache> cache) noexcept;
+
     /// @result Convenience function to determine if both \c haveTime()
     ///         and \c haveLocation() are true.
     [[nodiscard]] bool haveTimeAndLocation() const noexcept;
@@ -89,6 +102,47 @@ public:
     ///         a given location over the course of the year.
     /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
     [[nodiscard]] double getEquationOfTime() const;
+    /// @result The UTC time in seconds from the epoch of sunrise; i.e., when
+    ///         the top of the sun's disk rises above the horizon.  This is
+    ///         the sunrise on the local day (midnight to midnight in local
+    ///         mean solar time) containing the time.  If the sun does not
+    ///         rise or does not set on that day, e.g., in the polar night
+    ///         or midnight sun, then this is NaN.
+    /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
+    [[nodiscard]] double getSunrise() const;
+    /// @result The UTC time in seconds from the epoch of sunset on the local
+    ///         day containing the time.  If the sun does not rise or does
+    ///         not set on that day then this is NaN.
+    /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
+    [[nodiscard]] double getSunset() const;
+    /// @result The UTC time in seconds from the epoch of solar noon (i.e.,
+    ///         when the sun transits the meridian) on the local day
+    ///         containing the time.
+    /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
+    [[nodiscard]] double getSolarNoon() const;
+    /// @result The UTC time in seconds from the epoch of the first sunrise
+    ///         after the time.  Unlike \c getSunrise() this skips over the
+    ///         polar night, e.g., in the arctic winter this is the sunrise
+    ///         that ends it.  The search jumps over polar seasons so its
+    ///         cost is bounded.  This is NaN if the sun never rises, e.g.,
+    ///         within a degree or so of the pole.
+    /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
+    [[nodiscard]] double getNextSunrise() const;
+    /// @result The UTC time in seconds from the epoch of the first sunset
+    ///         after the time.  This skips over the midnight sun.
+    /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
+    /// @sa \c getNextSunrise()
+    [[nodiscard]] double getNextSunset() const;
+    /// @result The UTC time in seconds from the epoch of the last sunrise
+    ///         before the time.
+    /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
+    /// @sa \c getNextSunrise()
+    [[nodiscard]] double getPreviousSunrise() const;
+    /// @result The UTC time in seconds from the epoch of the last sunset
+    ///         before the time.
+    /// @throws std::runtime_error if \c haveTimeAndLocation() is false.
+    /// @sa \c getNextSunrise()
+    [[nodiscard]] double getPreviousSunset() const;
     /// @}
 
     /// @name Destructors
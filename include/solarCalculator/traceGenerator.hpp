@@ -0,0 +1,106 @@
+#ifndef SOLARCALCULATOR_TRACEGENERATOR_HPP
+#define SOLARCALCULATOR_TRACEGENERATOR_HPP
+#include <memory>
+namespace SolarCalculator
+{
+class Location;
+/// @class TraceGenerator "traceGenerator.hpp" "solarCalculator/traceGenerator.hpp"
+/// @brief Generates the solar elevation and azimuth at a station sampled
+///        at a fixed rate.  Rather than solving for each sample from
+///        scratch, the hour angle is advanced by a rotation recurrence and
+///        the declination and equation of time are linearly interpolated
+///        between knots.  The knot spacing adapts so that the interpolation
+///        error stays within a tolerance.  Samples are written to
+///        caller-provided buffers so arbitrarily long traces can be
+///        generated in chunks.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class TraceGenerator
+{
+public:
+    /// @brief The default tolerance in degrees.
+    static constexpr double DEFAULT_TOLERANCE = 1.e-5;
+
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    TraceGenerator();
+    /// @brief Copy constructor.
+    /// @param[in] generator  The generator from which to initialize this
+    ///                       class.
+    TraceGenerator(const TraceGenerator &generator);
+    /// @brief Move constructor.
+    /// @param[in,out] generator  The generator from which to initialize this
+    ///                           class.  On exit, generator's behavior is
+    ///                           undefined.
+    TraceGenerator(TraceGenerator &&generator) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] generator  The generator to copy to this.
+    /// @result A deep copy of the generator.
+    TraceGenerator& operator=(const TraceGenerator &generator);
+    /// @brief Move assignment operator.
+    /// @param[in,out] generator  The generator whose memory will be moved to
+    ///                           this.  On exit, generator's behavior is
+    ///                           undefined.
+    /// @result The memory from generator moved to this.
+    TraceGenerator& operator=(TraceGenerator &&generator) noexcept;
+    /// @}
+
+    /// @brief Initializes the generator.
+    /// @param[in] location        The station location.
+    /// @param[in] startTime       The UTC time in seconds from the epoch of
+    ///                            the first sample.
+    /// @param[in] samplingPeriod  The time between samples in seconds.
+    /// @param[in] tolerance       The maximum allowable interpolation error
+    ///                            in degrees of the declination and hour
+    ///                            angle.
+    /// @throws std::invalid_argument if the location's latitude or
+    ///         longitude is not set, the start time is earlier than the
+    ///         year -1000 or later than the year 2999, or the sampling
+    ///         period or tolerance is not positive.
+    void initialize(const Location &location,
+                    double startTime,
+                    double samplingPeriod,
+                    double tolerance = DEFAULT_TOLERANCE);
+    /// @result True indicates the generator is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+
+    /// @brief Generates the next samples of the trace.
+    /// @param[in] nSamples     The number of samples to generate.
+    /// @param[out] elevations  The angle between the sun and the horizon in
+    ///                         degrees.  This is an array whose dimension
+    ///                         is [nSamples].
+    /// @param[out] azimuths    The azimuth of the sun in degrees measured
+    ///                         positive clockwise from true north.  If not
+    ///                         NULL then this is an array whose dimension
+    ///                         is [nSamples].
+    /// @throws std::runtime_error if the generator is not initialized.
+    /// @throws std::invalid_argument if elevations is NULL or the trace
+    ///         would extend past the year 2999.
+    /// @note Successive calls continue the trace.
+    void generate(size_t nSamples,
+                  double elevations[], double azimuths[] = nullptr);
+    /// @result The UTC time in seconds from the epoch of the next sample
+    ///         that will be generated.
+    /// @throws std::runtime_error if the generator is not initialized.
+    [[nodiscard]] double getNextTime() const;
+    /// @result The time between samples in seconds.
+    /// @throws std::runtime_error if the generator is not initialized.
+    [[nodiscard]] double getSamplingPeriod() const;
+
+    /// @name Destructors
+    /// @{
+    /// @brief Resets the class.
+    void clear() noexcept;
+    /// @brief Destructor.
+    ~TraceGenerator();
+    /// @}
+private:
+    class TraceGeneratorImpl;
+    std::unique_ptr<TraceGeneratorImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,8 @@
+#ifndef PSOLARCALCULATOR_BATCH_HPP
+#define PSOLARCALCULATOR_BATCH_HPP
+#include <pybind11/pybind11.h>
+namespace PSolarCalculator
+{
+void initializeBatch(pybind11::module &m);
+}
+#endif
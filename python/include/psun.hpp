@@ -32,6 +32,9 @@ public:
     [[nodiscard]] double getAzimuth() const;
     [[nodiscard]] double getDeclination() const;
     [[nodiscard]] double getEquationOfTime() const;
+    [[nodiscard]] double getSunrise() const;
+    [[nodiscard]] double getSunset() const;
+    [[nodiscard]] double getSolarNoon() const;
 
     /// Destructors
     ~Sun();
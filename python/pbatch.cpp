@@ -0,0 +1,120 @@
+#include <string>
+#include <stdexcept>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <solarCalculator/batch.hpp>
+#include "include/pbatch.hpp"
+
+namespace
+{
+
+/// Contiguous double precision array.  Inputs of another type or layout
+/// are converted by pybind11 once on entry.
+using Array = pybind11::array_t<double,
+                                pybind11::array::c_style
+                              | pybind11::array::forcecast>;
+
+/// @result The number of rows after checking the inputs are 1D and have
+///         the same length.
+size_t checkShapes(const Array &times,
+                   const Array &latitudes,
+                   const Array &longitudes)
+{
+    if (times.ndim() != 1 || latitudes.ndim() != 1 || longitudes.ndim() != 1)
+    {
+        throw std::invalid_argument(
+            "times, latitudes, and longitudes must be 1D arrays");
+    }
+    auto nRows = static_cast<size_t> (times.shape(0));
+    if (static_cast<size_t> (latitudes.shape(0)) != nRows)
+    {
+        throw std::invalid_argument("latitudes size = "
+                                  + std::to_string(latitudes.shape(0))
+                                  + " must equal times size = "
+                                  + std::to_string(nRows));
+    }
+    if (static_cast<size_t> (longitudes.shape(0)) != nRows)
+    {
+        throw std::invalid_argument("longitudes size = "
+                                  + std::to_string(longitudes.shape(0))
+                                  + " must equal times size = "
+                                  + std::to_string(nRows));
+    }
+    return nRows;
+}
+
+/// Runs the batch solver with the GIL released.  Unwanted outputs are
+/// nullptr.
+void compute(const Array &times, const Array &latitudes,
+             const Array &longitudes,
+             double *elevations, double *azimuths,
+             double *declinations, double *equationsOfTime)
+{
+    auto nRows = checkShapes(times, latitudes, longitudes);
+    const double *timesPtr = times.data();
+    const double *latitudesPtr = latitudes.data();
+    const double *longitudesPtr = longitudes.data();
+    pybind11::gil_scoped_release release;
+    SolarCalculator::computeSolarPositions(nRows,
+                                           timesPtr,
+                                           latitudesPtr,
+                                           longitudesPtr,
+                                           elevations,
+                                           azimuths,
+                                           declinations,
+                                           equationsOfTime);
+}
+
+Array elevation(const Array &times, const Array &latitudes,
+                const Array &longitudes)
+{
+    Array result(times.size());
+    compute(times, latitudes, longitudes,
+            result.mutable_data(), nullptr, nullptr, nullptr);
+    return result;
+}
+
+Array azimuth(const Array &times, const Array &latitudes,
+              const Array &longitudes)
+{
+    Array result(times.size());
+    compute(times, latitudes, longitudes,
+            nullptr, result.mutable_data(), nullptr, nullptr);
+    return result;
+}
+
+pybind11::tuple solarPosition(const Array &times, const Array &latitudes,
+                              const Array &longitudes)
+{
+    Array elevations(times.size());
+    Array azimuths(times.size());
+    Array declinations(times.size());
+    Array equationsOfTime(times.size());
+    compute(times, latitudes, longitudes,
+            elevations.mutable_data(), azimuths.mutable_data(),
+            declinations.mutable_data(), equationsOfTime.mutable_data());
+    return pybind11::make_tuple(elevations, azimuths,
+                                declinations, equationsOfTime);
+}
+
+}
+
+/// Initialize
+void PSolarCalculator::initializeBatch(pybind11::module &m)
+{
+    m.def("elevation", &elevation,
+          "Computes the angle in degrees between the sun and the horizon for each row.  The times are UTC seconds from the epoch, the latitudes are in degrees in the range [-90,90], and the longitudes are in degrees in the range [-540,540).  All arrays must have the same length.  The GIL is released during the computation.",
+          pybind11::arg("times"),
+          pybind11::arg("latitudes"),
+          pybind11::arg("longitudes"));
+    m.def("azimuth", &azimuth,
+          "Computes the azimuth of the sun in degrees measured positive clockwise from true north for each row.  The inputs are as in elevation.  The GIL is released during the computation.",
+          pybind11::arg("times"),
+          pybind11::arg("latitudes"),
+          pybind11::arg("longitudes"));
+    m.def("solar_position", &solarPosition,
+          "Computes the tuple (elevation, azimuth, declination, equation_of_time) of arrays for each row.  The angles are in degrees and the equation of time is in minutes.  The inputs are as in elevation.  The GIL is released during the computation.",
+          pybind11::arg("times"),
+          pybind11::arg("latitudes"),
+          pybind11::arg("longitudes"));
+}
@@ -1,4 +1,5 @@
 #include "include/psun.hpp"
+#include "include/pbatch.hpp"
 #include "include/plocation.hpp"
 #include "include/plocation.hpp"
 //#include <solarCalculator/version.hpp>
@@ -11,4 +12,5 @@ PYBIND11_MODULE(pysolarCalculator, m)
 
     PSolarCalculator::initializeLocation(m);
     PSolarCalculator::initializeSun(m);
+    PSolarCalculator::initializeBatch(m);
 }
@@ -92,6 +92,21 @@ double Sun::getEquationOfTime() const
     return mSun->getEquationOfTime();
 }
 
+double Sun::getSunrise() const
+{
+    return mSun->getSunrise();
+}
+
+double Sun::getSunset() const
+{
+    return mSun->getSunset();
+}
+
+double Sun::getSolarNoon() const
+{
+    return mSun->getSolarNoon();
+}
+
 /// Initialize
 void PSolarCalculator::initializeSun(pybind11::module &m)
 {
@@ -102,7 +117,7 @@ void PSolarCalculator::initializeSun(pybind11::module &m)
         return PSolarCalculator::Sun(self);
     }); 
 
-    sun.doc() = "This modules performs solar calculations.\n\nProperties:\n\n  location : The location at which to compute the sun's properties.\n  time : The time in UTC measured as seconds from the epoch (January 1 1970) at which to compute the sun's properties.\n\nResults:\n\n elevation : The angle between the sun and the horizon in degrees.\n azimuth : The azimuth of the sun in degrees measured positive clockwise from true north.\n declination : The declination of the sun in degrees.  This varies from -23.44 degrees in the northern hemisphere during the winter solstice to 0 degrees at the vernal equinox to +23.44 degrees at the summer solstice.\n equation_of_time : The equation of time in minutes.  This is an astronomical term accounting for the changes in time of solar noon for a given location over the course of the year."; 
+    sun.doc() = "This modules performs solar calculations.\n\nProperties:\n\n  location : The location at which to compute the sun's properties.\n  time : The time in UTC measured as seconds from the epoch (January 1 1970) at which to compute the sun's properties.\n\nResults:\n\n elevation : The angle between the sun and the horizon in degrees.\n azimuth : The azimuth of the sun in degrees measured positive clockwise from true north.\n declination : The declination of the sun in degrees.  This varies from -23.44 degrees in the northern hemisphere during the winter solstice to 0 degrees at the vernal equinox to +23.44 degrees at the summer solstice.\n equation_of_time : The equation of time in minutes.  This is an astronomical term accounting for the changes in time of solar noon for a given location over the course of the year.\n sunrise : The UTC time in seconds from the epoch of sunrise on the local day.  This is NaN if the sun does not rise or set on that day.\n sunset : The UTC time in seconds from the epoch of sunset on the local day.  This is NaN if the sun does not rise or set on that day.\n solar_noon : The UTC time in seconds from the epoch of solar noon on the local day."; 
     sun.def_property("location",
                      &PSolarCalculator::Sun::getLocation,
                      &PSolarCalculator::Sun::setLocation);
@@ -118,4 +133,10 @@ void PSolarCalculator::initializeSun(pybind11::module &m)
                               &PSolarCalculator::Sun::getDeclination);
     sun.def_property_readonly("equation_of_time",
                               &PSolarCalculator::Sun::getEquationOfTime);
+    sun.def_property_readonly("sunrise",
+                              &PSolarCalculator::Sun::getSunrise);
+    sun.def_property_readonly("sunset",
+                              &PSolarCalculator::Sun::getSunset);
+    sun.def_property_readonly("solar_noon",
+                              &PSolarCalculator::Sun::getSolarNoon);
 }
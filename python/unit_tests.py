@@ -1,4 +1,5 @@
 #!/usr/bin/env python3
+import numpy as np
 import pysolarCalculator
 
 def test_location():
@@ -23,10 +24,43 @@ def test_sun():
     assert abs(sun.azimuth - 91.2) < 0.1, 'azimuth wrong'
     assert abs(sun.equation_of_time - 2.9) < 0.1, 'equation of time wrong'
     assert abs(sun.declination - 21.24) < 0.01, 'declination wrong'
+    assert abs(sun.sunrise - 1622030460) < 90, 'sunrise wrong'
+    assert abs(sun.sunset - 1622083680) < 90, 'sunset wrong'
+    assert sun.sunrise < sun.solar_noon < sun.sunset, 'solar noon wrong'
 
+def test_vectorized():
+    times = np.array([1622042345, 1600718786], dtype = np.float64)
+    latitudes = np.array([40.77, 39.77])
+    longitudes = np.array([-111.89, -109.89])
+    elevations = pysolarCalculator.elevation(times, latitudes, longitudes)
+    azimuths = pysolarCalculator.azimuth(times, latitudes, longitudes)
+    elevations2, azimuths2, declinations, equations_of_time \
+        = pysolarCalculator.solar_position(times, latitudes, longitudes)
+    assert elevations.shape == (2,), 'shape wrong'
+    assert abs(elevations[0] - 35.09) < 0.01, 'elevation wrong'
+    assert abs(azimuths[0] - 91.2) < 0.1, 'azimuth wrong'
+    assert abs(declinations[0] - 21.24) < 0.01, 'declination wrong'
+    assert abs(equations_of_time[0] - 2.9) < 0.1, 'equation of time wrong'
+    assert np.array_equal(elevations, elevations2), 'elevations differ'
+    assert np.array_equal(azimuths, azimuths2), 'azimuths differ'
+    for i in range(len(times)):
+        location = pysolarCalculator.Location()
+        location.latitude = latitudes[i]
+        location.longitude = longitudes[i]
+        sun = pysolarCalculator.Sun()
+        sun.location = location
+        sun.time = int(times[i])
+        assert abs(sun.elevation - elevations[i]) < 1.e-8, 'scalar mismatch'
+    try:
+        pysolarCalculator.elevation(times, latitudes[0:1], longitudes)
+        assert False, 'size mismatch not detected'
+    except ValueError:
+        pass
 
 if __name__ == "__main__":
     test_location()
     print("Passed location test")
     test_sun()
     print("Passed sun test")
+    test_vectorized()
+    print("Passed vectorized test")
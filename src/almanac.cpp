@@ -0,0 +1,295 @@
+#include <string>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "solarCalculator/almanac.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/parallelEngine.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+/// Days sampled before the first and after the last day so that the
+/// rise/set iterations and the interpolation stencil stay in the table.
+constexpr int64_t MARGIN = 3;
+
+/// @result The days since the epoch of Jan 1 of the year.
+int64_t yearToDay(const int year)
+{
+    return static_cast<int64_t> (daysFromCivil(year, 1, 1));
+}
+
+/// The declination and equation of time sampled at UTC midnights and
+/// interpolated with a four point Lagrange stencil.  Both vary smoothly
+/// enough on a one day grid that the interpolation error is ~1.e-7 degrees
+/// and minutes.
+class DailyEphemeris
+{
+public:
+    void resize(const int64_t firstDay, const size_t nDays)
+    {
+        mFirstDay = firstDay;
+        mDeclinations.resize(nDays);
+        mEquationsOfTime.resize(nDays);
+    }
+    void compute(const size_t i0, const size_t i1)
+    {
+        for (size_t i = i0; i < i1; ++i)
+        {
+            auto epoch = static_cast<double> (mFirstDay
+                                            + static_cast<int64_t> (i))
+                        *86400.0;
+            auto T = calcTimeJulianCentFromEpoch(epoch);
+            mDeclinations[i] = calcSunDeclinationBranchless(T);
+            mEquationsOfTime[i] = calcEquationOfTimeBranchless(T);
+        }
+    }
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return mDeclinations.size();
+    }
+    [[nodiscard]] double equationOfTime(const double epoch) const
+    {
+        return interpolate(epoch, mEquationsOfTime);
+    }
+    [[nodiscard]] double declination(const double epoch) const
+    {
+        return interpolate(epoch, mDeclinations);
+    }
+private:
+    [[nodiscard]] double interpolate(const double epoch,
+                                     const std::vector<double> &y) const
+    {
+        auto u = epoch/86400.0 - static_cast<double> (mFirstDay);
+        auto n = static_cast<double> (y.size());
+        auto i = std::clamp(std::floor(u), 1.0, n - 3.0);
+        auto f = u - i;
+        auto k = static_cast<size_t> (i);
+        auto fm1 = f - 1.0;
+        auto fm2 = f - 2.0;
+        auto fp1 = f + 1.0;
+        return -f*fm1*fm2/6.0*y[k - 1]
+             + fp1*fm1*fm2/2.0*y[k]
+             - fp1*f*fm2/2.0*y[k + 1]
+             + fp1*f*fm1/6.0*y[k + 2];
+    }
+    std::vector<double> mDeclinations;
+    std::vector<double> mEquationsOfTime;
+    int64_t mFirstDay{0};
+};
+
+}
+
+class Almanac::AlmanacImpl
+{
+public:
+    void initialize(const StationSet &stations,
+                    const int firstYear, const int lastYear)
+    {
+        if (stations.size() == 0)
+        {
+            throw std::invalid_argument("No stations");
+        }
+        if (firstYear < -1000 || lastYear > 2999)
+        {
+            throw std::invalid_argument("Years must be in range [-1000,2999]");
+        }
+        if (firstYear > lastYear)
+        {
+            throw std::invalid_argument("firstYear = "
+                                      + std::to_string(firstYear)
+                                      + " cannot exceed lastYear = "
+                                      + std::to_string(lastYear));
+        }
+        auto firstDay = yearToDay(firstYear);
+        auto endDay = yearToDay(lastYear + 1);
+        mLocalDays.resize(static_cast<size_t> (endDay - firstDay));
+        for (size_t i = 0; i < mLocalDays.size(); ++i)
+        {
+            mLocalDays[i] = firstDay + static_cast<int64_t> (i);
+        }
+        mSites.assign(stations.getSites(),
+                      stations.getSites() + stations.size());
+        auto nRows = mSites.size()*mLocalDays.size();
+        mSunrises.resize(nRows);
+        mSunsets.resize(nRows);
+        mSolarNoons.resize(nRows);
+        mDayLengths.resize(nRows);
+        mEphemeris.resize(firstDay - MARGIN,
+                          mLocalDays.size() + 2*MARGIN + 1);
+    }
+    void computeRows(const size_t i0, const size_t i1)
+    {
+        SOLARCALCULATOR_COUNT_N(AlmanacRows, i1 - i0);
+        constexpr double zenith = 90.833;
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+        auto nDays = mLocalDays.size();
+        for (size_t row = i0; row < i1; ++row)
+        {
+            const auto &site = mSites[row/nDays];
+            auto day = mLocalDays[row%nDays];
+            double rise = 0;
+            double set = 0;
+            auto kind = calcRiseSetEpochs(day, site.latitude, site.longitude,
+                                          zenith, &rise, &set,
+                                          &mSolarNoons[row], mEphemeris);
+            if (kind == 0)
+            {
+                mSunrises[row] = rise;
+                mSunsets[row] = set;
+                mDayLengths[row] = set - rise;
+            }
+            else
+            {
+                mSunrises[row] = nan;
+                mSunsets[row] = nan;
+                mDayLengths[row] = (kind > 0) ? 86400.0 : 0.0;
+            }
+        }
+    }
+    DailyEphemeris mEphemeris;
+    std::vector<Site> mSites;
+    std::vector<int64_t> mLocalDays;
+    std::vector<double> mSunrises;
+    std::vector<double> mSunsets;
+    std::vector<double> mSolarNoons;
+    std::vector<double> mDayLengths;
+    bool mHaveAlmanac{false};
+};
+
+/// C'tor
+Almanac::Almanac() :
+    pImpl(std::make_unique<AlmanacImpl> ())
+{
+}
+
+/// Copy c'tor
+Almanac::Almanac(const Almanac &almanac)
+{
+    *this = almanac;
+}
+
+/// Move c'tor
+Almanac::Almanac(Almanac &&almanac) noexcept
+{
+    *this = std::move(almanac);
+}
+
+/// Copy assignment
+Almanac& Almanac::operator=(const Almanac &almanac)
+{
+    if (&almanac == this){return *this;}
+    pImpl = std::make_unique<AlmanacImpl> (*almanac.pImpl);
+    return *this;
+}
+
+/// Move assignment
+Almanac& Almanac::operator=(Almanac &&almanac) noexcept
+{
+    if (&almanac == this){return *this;}
+    pImpl = std::move(almanac.pImpl);
+    return *this;
+}
+
+/// Destructor
+Almanac::~Almanac() = default;
+
+/// Clear
+void Almanac::clear() noexcept
+{
+    pImpl = std::make_unique<AlmanacImpl> ();
+}
+
+/// Compute
+void Almanac::compute(const StationSet &stations,
+                      const int firstYear, const int lastYear)
+{
+    SOLARCALCULATOR_TIME_SCOPE(Almanac);
+    auto impl = std::make_unique<AlmanacImpl> ();
+    impl->initialize(stations, firstYear, lastYear);
+    impl->mEphemeris.compute(0, impl->mEphemeris.size());
+    impl->computeRows(0, impl->mSunrises.size());
+    impl->mHaveAlmanac = true;
+    pImpl = std::move(impl);
+}
+
+void Almanac::compute(const StationSet &stations,
+                      const int firstYear, const int lastYear,
+                      ParallelEngine &engine)
+{
+    SOLARCALCULATOR_TIME_SCOPE(Almanac);
+    auto impl = std::make_unique<AlmanacImpl> ();
+    impl->initialize(stations, firstYear, lastYear);
+    auto *pointer = impl.get();
+    engine.parallelFor(impl->mEphemeris.size(),
+                       [pointer](const size_t i0, const size_t i1, int)
+                       {
+                           pointer->mEphemeris.compute(i0, i1);
+                       });
+    engine.parallelFor(impl->mSunrises.size(),
+                       [pointer](const size_t i0, const size_t i1, int)
+                       {
+                           pointer->computeRows(i0, i1);
+                       });
+    impl->mHaveAlmanac = true;
+    pImpl = std::move(impl);
+}
+
+/// Computed?
+bool Almanac::haveAlmanac() const noexcept
+{
+    return pImpl->mHaveAlmanac;
+}
+
+/// Dimensions
+size_t Almanac::getNumberOfSites() const noexcept
+{
+    return pImpl->mSites.size();
+}
+
+size_t Almanac::getNumberOfDays() const noexcept
+{
+    return pImpl->mLocalDays.size();
+}
+
+size_t Almanac::getNumberOfRows() const noexcept
+{
+    return pImpl->mSunrises.size();
+}
+
+const int64_t *Almanac::getLocalDays() const
+{
+    if (!haveAlmanac()){throw std::runtime_error("Almanac not computed");}
+    return pImpl->mLocalDays.data();
+}
+
+/// Columns
+const double *Almanac::getSunrises() const
+{
+    if (!haveAlmanac()){throw std::runtime_error("Almanac not computed");}
+    return pImpl->mSunrises.data();
+}
+
+const double *Almanac::getSunsets() const
+{
+    if (!haveAlmanac()){throw std::runtime_error("Almanac not computed");}
+    return pImpl->mSunsets.data();
+}
+
+const double *Almanac::getSolarNoons() const
+{
+    if (!haveAlmanac()){throw std::runtime_error("Almanac not computed");}
+    return pImpl->mSolarNoons.data();
+}
+
+const double *Almanac::getDayLengths() const
+{
+    if (!haveAlmanac()){throw std::runtime_error("Almanac not computed");}
+    return pImpl->mDayLengths.data();
+}
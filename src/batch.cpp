@@ -0,0 +1,705 @@
+#include <string>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/ephemerisTable.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include "kernels.hpp"
+#include "fastKernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+/// Rows are processed in blocks so that each stage's scratch space stays
+/// in L1 cache.
+constexpr size_t BLOCK_SIZE = 256;
+
+template<typename U>
+void checkInputs(const size_t nRows,
+                 const double times[],
+                 const U latitudes[],
+                 const U longitudes[])
+{
+    if (nRows == 0){return;}
+    if (times == nullptr){throw std::invalid_argument("times is NULL");}
+    if (latitudes == nullptr)
+    {
+        throw std::invalid_argument("latitudes is NULL");
+    }
+    if (longitudes == nullptr)
+    {
+        throw std::invalid_argument("longitudes is NULL");
+    }
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        if (!isValidEpoch(times[i]))
+        {
+            throw std::invalid_argument("Time " + std::to_string(times[i])
+                                      + " must be in years [-1000,2999]");
+        }
+        if (!(latitudes[i] >= -90 && latitudes[i] <= 90))
+        {
+            throw std::invalid_argument("Latitude = "
+                                      + std::to_string(latitudes[i])
+                                      + " must be in range [-90,90]");
+        }
+        if (!(longitudes[i] >= -540 && longitudes[i] < 540))
+        {
+            throw std::invalid_argument("Longitude = "
+                                      + std::to_string(longitudes[i])
+                                      + " must be in range [-540,540)");
+        }
+    }
+}
+
+void compute(const size_t nRows,
+             const double times[],
+             const double latitudes[],
+             const double longitudes[],
+             double elevations[],
+             double azimuths[],
+             double declinations[],
+             double equationsOfTime[],
+             const EphemerisCache *cache,
+             const EphemerisTable *table,
+             const Site *sites = nullptr,
+             const size_t siteIndices[] = nullptr)
+{
+    SOLARCALCULATOR_TIME_SCOPE(Batch);
+    SOLARCALCULATOR_COUNT_N(BatchRows, nRows);
+    if (siteIndices == nullptr)
+    {
+        checkInputs(nRows, times, latitudes, longitudes);
+    }
+    std::array<double, BLOCK_SIZE> T;
+    std::array<double, BLOCK_SIZE> eqTime;
+    std::array<double, BLOCK_SIZE> theta;
+    std::array<double, BLOCK_SIZE> lon;
+    std::array<double, BLOCK_SIZE> sinLat;
+    std::array<double, BLOCK_SIZE> cosLat;
+    std::array<double, BLOCK_SIZE> hourAngle;
+    std::array<double, BLOCK_SIZE> azimuth;
+    std::array<double, BLOCK_SIZE> elevation;
+    for (size_t i0 = 0; i0 < nRows; i0 = i0 + BLOCK_SIZE)
+    {
+        auto n = std::min(BLOCK_SIZE, nRows - i0);
+        const auto *t = times + i0;
+        // Time-only terms
+        if (cache)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto ephemeris = cache->getEphemeris(t[i]);
+                eqTime[i] = ephemeris.getEquationOfTime();
+                theta[i] = ephemeris.getDeclination();
+            }
+        }
+        else if (table)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                table->evaluate(t[i], &theta[i], &eqTime[i]);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                T[i] = calcTimeJulianCentFromEpoch(t[i]);
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                eqTime[i] = calcEquationOfTimeBranchless(T[i]);
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                theta[i] = calcSunDeclinationBranchless(T[i]);
+            }
+        }
+        if (declinations)
+        {
+            std::copy(theta.begin(), theta.begin() + n, declinations + i0);
+        }
+        if (equationsOfTime)
+        {
+            std::copy(eqTime.begin(), eqTime.begin() + n,
+                      equationsOfTime + i0);
+        }
+        if (elevations == nullptr && azimuths == nullptr){continue;}
+        // Location dependent terms
+        if (siteIndices)
+        {
+            const auto *index = siteIndices + i0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const auto &site = sites[index[i]];
+                lon[i] = site.longitude;
+                sinLat[i] = site.sinLatitude;
+                cosLat[i] = site.cosLatitude;
+            }
+        }
+        else
+        {
+            const auto *latitude = latitudes + i0;
+            const auto *longitude = longitudes + i0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto latRad = degToRad(latitude[i]);
+                lon[i] = longitude[i];
+                sinLat[i] = std::sin(latRad);
+                cosLat[i] = std::cos(latRad);
+            }
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            hourAngle[i]
+                = calcHourAngleBranchless(calcMinutesOfDayFromEpoch(t[i]),
+                                          lon[i], eqTime[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            calcAzElBranchless(hourAngle[i], sinLat[i], cosLat[i],
+                               theta[i], &azimuth[i], &elevation[i]);
+        }
+        if (elevations)
+        {
+            std::copy(elevation.begin(), elevation.begin() + n,
+                      elevations + i0);
+        }
+        if (azimuths)
+        {
+            std::copy(azimuth.begin(), azimuth.begin() + n, azimuths + i0);
+        }
+    }
+}
+
+/// Computation with the fast accuracy tier's polynomial trigonometry.
+void computeFast(const size_t nRows,
+                 const double times[],
+                 const double latitudes[],
+                 const double longitudes[],
+                 double elevations[],
+                 double azimuths[],
+                 double declinations[],
+                 double equationsOfTime[])
+{
+    SOLARCALCULATOR_TIME_SCOPE(Batch);
+    SOLARCALCULATOR_COUNT_N(BatchRows, nRows);
+    checkInputs(nRows, times, latitudes, longitudes);
+    std::array<double, BLOCK_SIZE> T;
+    std::array<double, BLOCK_SIZE> l0;
+    std::array<double, BLOCK_SIZE> m;
+    std::array<double, BLOCK_SIZE> eqTime;
+    std::array<double, BLOCK_SIZE> theta;
+    std::array<double, BLOCK_SIZE> sinLat;
+    std::array<double, BLOCK_SIZE> cosLat;
+    std::array<double, BLOCK_SIZE> sinDec;
+    std::array<double, BLOCK_SIZE> cosDec;
+    std::array<double, BLOCK_SIZE> hourAngle;
+    std::array<double, BLOCK_SIZE> cosHourAngle;
+    std::array<double, BLOCK_SIZE> azimuth;
+    std::array<double, BLOCK_SIZE> elevation;
+    for (size_t i0 = 0; i0 < nRows; i0 = i0 + BLOCK_SIZE)
+    {
+        auto n = std::min(BLOCK_SIZE, nRows - i0);
+        const auto *t = times + i0;
+        // Time-only terms
+        for (size_t i = 0; i < n; ++i)
+        {
+            T[i] = calcTimeJulianCentFromEpoch(t[i]);
+            l0[i] = Fast::calcGeomMeanLongSun(T[i]);
+            m[i] = calcGeomMeanAnomalySun(T[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            eqTime[i]
+                = Fast::calcEquationOfTimeFromAngles(T[i], l0[i], m[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            theta[i]
+                = Fast::calcSunDeclinationFromAngles(T[i], l0[i], m[i]);
+        }
+        if (declinations)
+        {
+            std::copy(theta.begin(), theta.begin() + n, declinations + i0);
+        }
+        if (equationsOfTime)
+        {
+            std::copy(eqTime.begin(), eqTime.begin() + n,
+                      equationsOfTime + i0);
+        }
+        if (elevations == nullptr && azimuths == nullptr){continue;}
+        // Location dependent terms
+        const auto *latitude = latitudes + i0;
+        const auto *longitude = longitudes + i0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            Fast::sinCosDeg(latitude[i], &sinLat[i], &cosLat[i]);
+            Fast::sinCosDeg(theta[i], &sinDec[i], &cosDec[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            hourAngle[i]
+                = Fast::calcHourAngle(Fast::calcMinutesOfDayFromEpoch(t[i]),
+                                      longitude[i], eqTime[i]);
+            cosHourAngle[i] = Fast::cosDeg(hourAngle[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            Fast::calcAzElFromCosines(cosHourAngle[i], hourAngle[i],
+                                      sinLat[i], cosLat[i],
+                                      sinDec[i], cosDec[i],
+                                      &azimuth[i], &elevation[i]);
+        }
+        if (elevations)
+        {
+            std::copy(elevation.begin(), elevation.begin() + n,
+                      elevations + i0);
+        }
+        if (azimuths)
+        {
+            std::copy(azimuth.begin(), azimuth.begin() + n, azimuths + i0);
+        }
+    }
+}
+
+/// Single precision computation.  The times are split into whole days and
+/// the fraction of the day; see the split Julian date kernels.
+void computeSplit(const size_t nRows,
+                  const double times[],
+                  const float latitudes[],
+                  const float longitudes[],
+                  float elevations[],
+                  float azimuths[],
+                  float declinations[],
+                  float equationsOfTime[])
+{
+    SOLARCALCULATOR_TIME_SCOPE(Batch);
+    SOLARCALCULATOR_COUNT_N(BatchRows, nRows);
+    checkInputs(nRows, times, latitudes, longitudes);
+    std::array<SplitDate<float>, BLOCK_SIZE> date;
+    std::array<float, BLOCK_SIZE> T;
+    std::array<float, BLOCK_SIZE> l0;
+    std::array<float, BLOCK_SIZE> m;
+    std::array<float, BLOCK_SIZE> eqTime;
+    std::array<float, BLOCK_SIZE> theta;
+    std::array<float, BLOCK_SIZE> sinLat;
+    std::array<float, BLOCK_SIZE> cosLat;
+    std::array<float, BLOCK_SIZE> hourAngle;
+    std::array<float, BLOCK_SIZE> azimuth;
+    std::array<float, BLOCK_SIZE> elevation;
+    for (size_t i0 = 0; i0 < nRows; i0 = i0 + BLOCK_SIZE)
+    {
+        auto n = std::min(BLOCK_SIZE, nRows - i0);
+        const auto *t = times + i0;
+        // Time-only terms
+        for (size_t i = 0; i < n; ++i)
+        {
+            date[i] = splitEpoch<float> (t[i]);
+            T[i] = calcTimeJulianCentSplit(date[i]);
+            calcMeanAnglesSplit(date[i], T[i], &l0[i], &m[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            eqTime[i] = calcEquationOfTimeFromAngles(T[i], l0[i], m[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            theta[i] = calcSunDeclinationFromAngles(T[i], l0[i], m[i]);
+        }
+        if (declinations)
+        {
+            std::copy(theta.begin(), theta.begin() + n, declinations + i0);
+        }
+        if (equationsOfTime)
+        {
+            std::copy(eqTime.begin(), eqTime.begin() + n,
+                      equationsOfTime + i0);
+        }
+        if (elevations == nullptr && azimuths == nullptr){continue;}
+        // Location dependent terms
+        const auto *latitude = latitudes + i0;
+        const auto *longitude = longitudes + i0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto latRad = degToRad(latitude[i]);
+            sinLat[i] = std::sin(latRad);
+            cosLat[i] = std::cos(latRad);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            hourAngle[i]
+                = calcHourAngleBranchless(calcMinutesOfDaySplit(date[i]),
+                                          longitude[i], eqTime[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            calcAzElBranchless(hourAngle[i], sinLat[i], cosLat[i],
+                               theta[i], &azimuth[i], &elevation[i]);
+        }
+        if (elevations)
+        {
+            std::copy(elevation.begin(), elevation.begin() + n,
+                      elevations + i0);
+        }
+        if (azimuths)
+        {
+            std::copy(azimuth.begin(), azimuth.begin() + n, azimuths + i0);
+        }
+    }
+}
+
+}
+
+/// Batch computation
+void SolarCalculator::computeSolarPositions(const size_t nRows,
+                                            const double times[],
+                                            const double latitudes[],
+                                            const double longitudes[],
+                                            double elevations[],
+                                            double azimuths[],
+                                            double declinations[],
+                                            double equationsOfTime[])
+{
+    compute(nRows, times, latitudes, longitudes,
+            elevations, azimuths, declinations, equationsOfTime,
+            nullptr, nullptr);
+}
+
+/// Batch computation at the given accuracy
+void SolarCalculator::computeSolarPositions(const Accuracy accuracy,
+                                            const size_t nRows,
+                                            const double times[],
+                                            const double latitudes[],
+                                            const double longitudes[],
+                                            double elevations[],
+                                            double azimuths[],
+                                            double declinations[],
+                                            double equationsOfTime[])
+{
+    if (accuracy == Accuracy::Fast)
+    {
+        computeFast(nRows, times, latitudes, longitudes,
+                    elevations, azimuths, declinations, equationsOfTime);
+        return;
+    }
+    compute(nRows, times, latitudes, longitudes,
+            elevations, azimuths, declinations, equationsOfTime,
+            nullptr, nullptr);
+}
+
+/// Single precision batch computation
+void SolarCalculator::computeSolarPositionsFloat(const size_t nRows,
+                                                 const double times[],
+                                                 const float latitudes[],
+                                                 const float longitudes[],
+                                                 float elevations[],
+                                                 float azimuths[],
+                                                 float declinations[],
+                                                 float equationsOfTime[])
+{
+    computeSplit(nRows, times, latitudes, longitudes,
+                 elevations, azimuths, declinations, equationsOfTime);
+}
+
+/// Batch computation with cached ephemerides
+void SolarCalculator::computeSolarPositions(const EphemerisCache &cache,
+                                            const size_t nRows,
+                                            const double times[],
+                                            const double latitudes[],
+                                            const double longitudes[],
+                                            double elevations[],
+                                            double azimuths[],
+                                            double declinations[],
+                                            double equationsOfTime[])
+{
+    compute(nRows, times, latitudes, longitudes,
+            elevations, azimuths, declinations, equationsOfTime,
+            &cache, nullptr);
+}
+
+/// Batch computation with tabulated ephemerides
+void SolarCalculator::computeSolarPositions(const EphemerisTable &table,
+                                            const size_t nRows,
+                                            const double times[],
+                                            const double latitudes[],
+                                            const double longitudes[],
+                                            double elevations[],
+                                            double azimuths[],
+                                            double declinations[],
+                                            double equationsOfTime[])
+{
+    if (!table.isInitialized())
+    {
+        throw std::invalid_argument("Table not initialized");
+    }
+    if (nRows > 0 && times == nullptr)
+    {
+        throw std::invalid_argument("times is NULL");
+    }
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        if (!table.contains(times[i]))
+        {
+            throw std::invalid_argument("Time " + std::to_string(times[i])
+                                      + " is not in the table");
+        }
+    }
+    compute(nRows, times, latitudes, longitudes,
+            elevations, azimuths, declinations, equationsOfTime,
+            nullptr, &table);
+}
+
+/// Batch computation at registered sites
+void SolarCalculator::computeSolarPositions(const StationSet &stations,
+                                            const size_t nRows,
+                                            const double times[],
+                                            const size_t sites[],
+                                            double elevations[],
+                                            double azimuths[],
+                                            double declinations[],
+                                            double equationsOfTime[])
+{
+    if (nRows == 0){return;}
+    if (times == nullptr){throw std::invalid_argument("times is NULL");}
+    if (sites == nullptr){throw std::invalid_argument("sites is NULL");}
+    auto nSites = stations.size();
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        if (!isValidEpoch(times[i]))
+        {
+            throw std::invalid_argument("Time " + std::to_string(times[i])
+                                      + " must be in years [-1000,2999]");
+        }
+        if (sites[i] >= nSites)
+        {
+            throw std::invalid_argument("Site index "
+                                      + std::to_string(sites[i])
+                                      + " must be less than "
+                                      + std::to_string(nSites));
+        }
+    }
+    compute(nRows, times, nullptr, nullptr,
+            elevations, azimuths, declinations, equationsOfTime,
+            nullptr, nullptr, stations.getSites(), sites);
+}
+
+/// Grid computation
+void SolarCalculator::computeSolarPositionGrid(const double time,
+                                               const size_t nLatitudes,
+                                               const double latitudes[],
+                                               const size_t nLongitudes,
+                                               const double longitudes[],
+                                               double elevations[],
+                                               double azimuths[])
+{
+    SOLARCALCULATOR_TIME_SCOPE(Batch);
+    SOLARCALCULATOR_COUNT_N(BatchRows, nLatitudes*nLongitudes);
+    if (!isValidEpoch(time))
+    {
+        throw std::invalid_argument("Time " + std::to_string(time)
+                                  + " must be in years [-1000,2999]");
+    }
+    if (nLatitudes > 0 && latitudes == nullptr)
+    {
+        throw std::invalid_argument("latitudes is NULL");
+    }
+    if (nLongitudes > 0 && longitudes == nullptr)
+    {
+        throw std::invalid_argument("longitudes is NULL");
+    }
+    for (size_t i = 0; i < nLatitudes; ++i)
+    {
+        if (!(latitudes[i] >= -90 && latitudes[i] <= 90))
+        {
+            throw std::invalid_argument("Latitude = "
+                                      + std::to_string(latitudes[i])
+                                      + " must be in range [-90,90]");
+        }
+    }
+    for (size_t j = 0; j < nLongitudes; ++j)
+    {
+        if (!(longitudes[j] >= -540 && longitudes[j] < 540))
+        {
+            throw std::invalid_argument("Longitude = "
+                                      + std::to_string(longitudes[j])
+                                      + " must be in range [-540,540)");
+        }
+    }
+    if (elevations == nullptr && azimuths == nullptr){return;}
+    // Time-only terms
+    auto T = calcTimeJulianCentFromEpoch(time);
+    auto eqTime = calcEquationOfTimeBranchless(T);
+    auto decRad = degToRad(calcSunDeclinationBranchless(T));
+    auto sinDec = std::sin(decRad);
+    auto cosDec = std::cos(decRad);
+    auto minutes = calcMinutesOfDayFromEpoch(time);
+    // Column terms
+    std::vector<double> hourAngle(nLongitudes);
+    std::vector<double> cosHourAngle(nLongitudes);
+    for (size_t j = 0; j < nLongitudes; ++j)
+    {
+        hourAngle[j] = calcHourAngleBranchless(minutes, longitudes[j], eqTime);
+        cosHourAngle[j] = std::cos(degToRad(hourAngle[j]));
+    }
+    // Row terms then cos(zenith) = a + b*cos(hour angle) at each node
+    std::array<double, BLOCK_SIZE> cosZenith;
+    for (size_t i = 0; i < nLatitudes; ++i)
+    {
+        auto latRad = degToRad(latitudes[i]);
+        auto sinLat = std::sin(latRad);
+        auto cosLat = std::cos(latRad);
+        auto a = sinLat*sinDec;
+        auto b = cosLat*cosDec;
+        auto offset = i*nLongitudes;
+        if (azimuths)
+        {
+            for (size_t j = 0; j < nLongitudes; ++j)
+            {
+                double elevation;
+                calcAzElFromCosines(cosHourAngle[j], hourAngle[j],
+                                    sinLat, cosLat, sinDec, cosDec,
+                                    &azimuths[offset + j], &elevation);
+                if (elevations){elevations[offset + j] = elevation;}
+            }
+            continue;
+        }
+        for (size_t j0 = 0; j0 < nLongitudes; j0 = j0 + BLOCK_SIZE)
+        {
+            auto n = std::min(BLOCK_SIZE, nLongitudes - j0);
+            const auto *c = cosHourAngle.data() + j0;
+            for (size_t j = 0; j < n; ++j)
+            {
+                cosZenith[j] = a + b*c[j];
+            }
+            auto *elevation = elevations + offset + j0;
+            for (size_t j = 0; j < n; ++j)
+            {
+                elevation[j] = calcElevationFromCosZenith(cosZenith[j]);
+            }
+        }
+    }
+}
+
+/// Elevations at a station set from the subsolar vector
+void SolarCalculator::computeElevations(const double time,
+                                        const StationSet &stations,
+                                        double elevations[])
+{
+    auto nSites = stations.size();
+    SOLARCALCULATOR_TIME_SCOPE(Batch);
+    SOLARCALCULATOR_COUNT_N(BatchRows, nSites);
+    if (!isValidEpoch(time))
+    {
+        throw std::invalid_argument("Time " + std::to_string(time)
+                                  + " must be in years [-1000,2999]");
+    }
+    if (nSites == 0){return;}
+    if (elevations == nullptr)
+    {
+        throw std::invalid_argument("elevations is NULL");
+    }
+    auto subsolar = computeSubsolarPoint(time);
+    auto decRad = degToRad(subsolar.latitude);
+    auto lonRad = degToRad(subsolar.longitude);
+    auto sx = std::cos(decRad)*std::cos(lonRad);
+    auto sy = std::cos(decRad)*std::sin(lonRad);
+    auto sz = std::sin(decRad);
+    const auto *x = stations.getUnitVectorsX();
+    const auto *y = stations.getUnitVectorsY();
+    const auto *z = stations.getUnitVectorsZ();
+    std::array<double, BLOCK_SIZE> cosZenith;
+    for (size_t i0 = 0; i0 < nSites; i0 = i0 + BLOCK_SIZE)
+    {
+        auto n = std::min(BLOCK_SIZE, nSites - i0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            cosZenith[i] = x[i0 + i]*sx + y[i0 + i]*sy + z[i0 + i]*sz;
+        }
+        auto *elevation = elevations + i0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            elevation[i] = calcElevationFromCosZenith(cosZenith[i]);
+        }
+    }
+}
+
+/// Elevations at many locations at one time
+void SolarCalculator::computeElevations(const double time,
+                                        const size_t nLocations,
+                                        const double latitudes[],
+                                        const double longitudes[],
+                                        double elevations[])
+{
+    SOLARCALCULATOR_TIME_SCOPE(Batch);
+    SOLARCALCULATOR_COUNT_N(BatchRows, nLocations);
+    if (!isValidEpoch(time))
+    {
+        throw std::invalid_argument("Time " + std::to_string(time)
+                                  + " must be in years [-1000,2999]");
+    }
+    if (nLocations == 0){return;}
+    if (elevations == nullptr)
+    {
+        throw std::invalid_argument("elevations is NULL");
+    }
+    if (latitudes == nullptr)
+    {
+        throw std::invalid_argument("latitudes is NULL");
+    }
+    if (longitudes == nullptr)
+    {
+        throw std::invalid_argument("longitudes is NULL");
+    }
+    for (size_t i = 0; i < nLocations; ++i)
+    {
+        if (!(latitudes[i] >= -90 && latitudes[i] <= 90))
+        {
+            throw std::invalid_argument("Latitude = "
+                                      + std::to_string(latitudes[i])
+                                      + " must be in range [-90,90]");
+        }
+        if (!(longitudes[i] >= -540 && longitudes[i] < 540))
+        {
+            throw std::invalid_argument("Longitude = "
+                                      + std::to_string(longitudes[i])
+                                      + " must be in range [-540,540)");
+        }
+    }
+    // Time-only terms
+    auto T = calcTimeJulianCentFromEpoch(time);
+    auto eqTime = calcEquationOfTimeBranchless(T);
+    auto decRad = degToRad(calcSunDeclinationBranchless(T));
+    auto sinDec = std::sin(decRad);
+    auto cosDec = std::cos(decRad);
+    auto minutes = calcMinutesOfDayFromEpoch(time);
+    std::array<double, BLOCK_SIZE> cosZenith;
+    for (size_t i0 = 0; i0 < nLocations; i0 = i0 + BLOCK_SIZE)
+    {
+        auto n = std::min(BLOCK_SIZE, nLocations - i0);
+        const auto *latitude = latitudes + i0;
+        const auto *longitude = longitudes + i0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto latRad = degToRad(latitude[i]);
+            auto hourAngle = calcHourAngleBranchless(minutes, longitude[i],
+                                                     eqTime);
+            cosZenith[i] = std::sin(latRad)*sinDec
+                         + std::cos(latRad)*cosDec
+                          *std::cos(degToRad(hourAngle));
+        }
+        auto *elevation = elevations + i0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            elevation[i] = calcElevationFromCosZenith(cosZenith[i]);
+        }
+    }
+}
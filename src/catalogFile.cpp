@@ -0,0 +1,454 @@
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "solarCalculator/catalogFile.hpp"
+#include "solarCalculator/batch.hpp"
+
+using namespace SolarCalculator;
+
+namespace
+{
+
+constexpr char MAGIC[8] = {'S', 'C', 'C', 'A', 'T', 'L', 'O', 'G'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint64_t ALIGNMENT = 64;
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t nColumns;
+    uint32_t maxColumns;
+    uint64_t nRows;
+    char padding[32];
+};
+static_assert(sizeof(Header) == 64, "Header must be 64 bytes");
+
+struct Entry
+{
+    char name[16];
+    uint32_t type;
+    uint32_t padding;
+    uint64_t offset;
+};
+static_assert(sizeof(Entry) == 32, "Entry must be 32 bytes");
+
+constexpr uint64_t DATA_OFFSET
+    = sizeof(Header) + CatalogFile::MAXIMUM_NUMBER_OF_COLUMNS*sizeof(Entry);
+static_assert(DATA_OFFSET%ALIGNMENT == 0, "Data must be aligned");
+
+uint64_t align(const uint64_t offset)
+{
+    return ((offset + ALIGNMENT - 1)/ALIGNMENT)*ALIGNMENT;
+}
+
+void checkName(const std::string &name)
+{
+    if (name.empty()){throw std::invalid_argument("Column name is empty");}
+    if (name.size() > CatalogFile::MAXIMUM_NAME_LENGTH)
+    {
+        throw std::invalid_argument("Column name " + name
+                                  + " exceeds "
+                                  + std::to_string(
+                                       CatalogFile::MAXIMUM_NAME_LENGTH)
+                                  + " characters");
+    }
+}
+
+}
+
+class CatalogFile::CatalogFileImpl
+{
+public:
+    ~CatalogFileImpl()
+    {
+        close();
+    }
+    void close() noexcept
+    {
+        if (mMap){munmap(mMap, mSize);}
+        if (mFileDescriptor >= 0){::close(mFileDescriptor);}
+        mMap = nullptr;
+        mSize = 0;
+        mFileDescriptor =-1;
+        mWritable = false;
+    }
+    void map(const size_t size)
+    {
+        auto protection = mWritable ? PROT_READ | PROT_WRITE : PROT_READ;
+        auto map = mmap(nullptr, size, protection, MAP_SHARED,
+                        mFileDescriptor, 0);
+        if (map == MAP_FAILED)
+        {
+            throw std::runtime_error("Failed to map " + mFileName);
+        }
+        mMap = static_cast<char *> (map);
+        mSize = size;
+    }
+    [[nodiscard]] Header *header() const noexcept
+    {
+        return reinterpret_cast<Header *> (mMap);
+    }
+    [[nodiscard]] Entry *entries() const noexcept
+    {
+        return reinterpret_cast<Entry *> (mMap + sizeof(Header));
+    }
+    [[nodiscard]] const Entry *find(const std::string &name) const noexcept
+    {
+        if (!mMap || name.size() > MAXIMUM_NAME_LENGTH){return nullptr;}
+        auto nColumns = header()->nColumns;
+        const auto *entry = entries();
+        for (uint32_t i = 0; i < nColumns; ++i)
+        {
+            if (std::strncmp(entry[i].name, name.c_str(),
+                             sizeof(Entry::name)) == 0)
+            {
+                return &entry[i];
+            }
+        }
+        return nullptr;
+    }
+    [[nodiscard]] char *getColumn(const std::string &name,
+                                  const ColumnType type) const
+    {
+        if (!mMap){throw std::runtime_error("Catalog not open");}
+        const auto *entry = find(name);
+        if (entry == nullptr)
+        {
+            throw std::invalid_argument("Column " + name + " does not exist");
+        }
+        if (entry->type != static_cast<uint32_t> (type))
+        {
+            throw std::invalid_argument("Column " + name
+                                      + " has a different type");
+        }
+        return mMap + entry->offset;
+    }
+    std::string mFileName;
+    char *mMap = nullptr;
+    size_t mSize = 0;
+    int mFileDescriptor =-1;
+    bool mWritable = false;
+};
+
+/// C'tor
+CatalogFile::CatalogFile() :
+    pImpl(std::make_unique<CatalogFileImpl> ())
+{
+}
+
+/// Move c'tor
+CatalogFile::CatalogFile(CatalogFile &&catalog) noexcept
+{
+    *this = std::move(catalog);
+}
+
+/// Move assignment
+CatalogFile& CatalogFile::operator=(CatalogFile &&catalog) noexcept
+{
+    if (&catalog == this){return *this;}
+    pImpl = std::move(catalog.pImpl);
+    return *this;
+}
+
+/// Destructor
+CatalogFile::~CatalogFile() = default;
+
+/// Close
+void CatalogFile::close() noexcept
+{
+    pImpl->close();
+}
+
+/// Create
+void CatalogFile::create(
+    const std::string &fileName,
+    const size_t nRows,
+    const std::vector<std::pair<std::string, ColumnType>> &columns)
+{
+    if (columns.size() > MAXIMUM_NUMBER_OF_COLUMNS)
+    {
+        throw std::invalid_argument("At most "
+                                  + std::to_string(MAXIMUM_NUMBER_OF_COLUMNS)
+                                  + " columns are allowed");
+    }
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        checkName(columns[i].first);
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (columns[i].first == columns[j].first)
+            {
+                throw std::invalid_argument("Column " + columns[i].first
+                                          + " is repeated");
+            }
+        }
+    }
+    close();
+    auto impl = std::make_unique<CatalogFileImpl> ();
+    impl->mFileName = fileName;
+    impl->mWritable = true;
+    impl->mFileDescriptor = ::open(fileName.c_str(),
+                                   O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (impl->mFileDescriptor < 0)
+    {
+        throw std::runtime_error("Failed to create " + fileName);
+    }
+    std::vector<uint64_t> offsets(columns.size());
+    auto size = DATA_OFFSET;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        offsets[i] = align(size);
+        size = offsets[i] + nRows*sizeof(double);
+    }
+    if (ftruncate(impl->mFileDescriptor, static_cast<off_t> (size)) != 0)
+    {
+        throw std::runtime_error("Failed to size " + fileName);
+    }
+    impl->map(size);
+    auto *header = impl->header();
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->version = VERSION;
+    header->byteOrderMark = BYTE_ORDER_MARK;
+    header->nColumns = static_cast<uint32_t> (columns.size());
+    header->maxColumns = static_cast<uint32_t> (MAXIMUM_NUMBER_OF_COLUMNS);
+    header->nRows = nRows;
+    auto *entries = impl->entries();
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        std::memcpy(entries[i].name, columns[i].first.data(),
+                    columns[i].first.size());
+        entries[i].type = static_cast<uint32_t> (columns[i].second);
+        entries[i].offset = offsets[i];
+    }
+    pImpl = std::move(impl);
+}
+
+/// Open
+void CatalogFile::open(const std::string &fileName, const bool writable)
+{
+    if (!std::filesystem::exists(fileName))
+    {
+        throw std::invalid_argument(fileName + " does not exist");
+    }
+    close();
+    auto impl = std::make_unique<CatalogFileImpl> ();
+    impl->mFileName = fileName;
+    impl->mWritable = writable;
+    impl->mFileDescriptor = ::open(fileName.c_str(),
+                                   writable ? O_RDWR : O_RDONLY);
+    if (impl->mFileDescriptor < 0)
+    {
+        throw std::runtime_error("Failed to open " + fileName);
+    }
+    struct stat status;
+    if (fstat(impl->mFileDescriptor, &status) != 0)
+    {
+        throw std::runtime_error("Failed to stat " + fileName);
+    }
+    auto size = static_cast<uint64_t> (status.st_size);
+    if (size < DATA_OFFSET)
+    {
+        throw std::runtime_error(fileName + " is too small to be a catalog");
+    }
+    impl->map(size);
+    const auto *header = impl->header();
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        throw std::runtime_error(fileName + " is not a catalog");
+    }
+    if (header->byteOrderMark != BYTE_ORDER_MARK)
+    {
+        throw std::runtime_error(fileName + " has a different byte order");
+    }
+    if (header->version != VERSION)
+    {
+        throw std::runtime_error("Unsupported version "
+                               + std::to_string(header->version));
+    }
+    if (header->maxColumns != MAXIMUM_NUMBER_OF_COLUMNS ||
+        header->nColumns > MAXIMUM_NUMBER_OF_COLUMNS)
+    {
+        throw std::runtime_error(fileName + " has an invalid header");
+    }
+    const auto *entries = impl->entries();
+    for (uint32_t i = 0; i < header->nColumns; ++i)
+    {
+        auto type = entries[i].type;
+        auto offset = entries[i].offset;
+        if ((type != static_cast<uint32_t> (ColumnType::Float64) &&
+             type != static_cast<uint32_t> (ColumnType::Int64)) ||
+            offset < DATA_OFFSET || offset%ALIGNMENT != 0 ||
+            offset > size ||
+            header->nRows > (size - offset)/sizeof(double))
+        {
+            throw std::runtime_error(fileName + " has an invalid column "
+                                   + std::to_string(i));
+        }
+    }
+    pImpl = std::move(impl);
+}
+
+/// Open?
+bool CatalogFile::isOpen() const noexcept
+{
+    return pImpl->mMap != nullptr;
+}
+
+bool CatalogFile::isWritable() const noexcept
+{
+    return isOpen() && pImpl->mWritable;
+}
+
+/// Flush
+void CatalogFile::flush() const
+{
+    if (!isOpen()){throw std::runtime_error("Catalog not open");}
+    if (pImpl->mWritable){msync(pImpl->mMap, pImpl->mSize, MS_ASYNC);}
+}
+
+/// Add a column
+void CatalogFile::addColumn(const std::string &name, const ColumnType type)
+{
+    if (!isWritable())
+    {
+        throw std::runtime_error("Catalog not open for writing");
+    }
+    checkName(name);
+    if (haveColumn(name))
+    {
+        throw std::invalid_argument("Column " + name + " already exists");
+    }
+    auto nColumns = pImpl->header()->nColumns;
+    if (nColumns >= MAXIMUM_NUMBER_OF_COLUMNS)
+    {
+        throw std::invalid_argument("Catalog has the maximum number of "
+                                    "columns");
+    }
+    auto nRows = pImpl->header()->nRows;
+    auto offset = align(pImpl->mSize);
+    auto size = offset + nRows*sizeof(double);
+    munmap(pImpl->mMap, pImpl->mSize);
+    pImpl->mMap = nullptr;
+    if (ftruncate(pImpl->mFileDescriptor, static_cast<off_t> (size)) != 0)
+    {
+        pImpl->close();
+        throw std::runtime_error("Failed to resize " + pImpl->mFileName);
+    }
+    pImpl->map(size);
+    auto &entry = pImpl->entries()[nColumns];
+    std::memset(&entry, 0, sizeof(Entry));
+    std::memcpy(entry.name, name.data(), name.size());
+    entry.type = static_cast<uint32_t> (type);
+    entry.offset = offset;
+    pImpl->header()->nColumns = nColumns + 1;
+}
+
+/// Number of rows
+size_t CatalogFile::getNumberOfRows() const
+{
+    if (!isOpen()){throw std::runtime_error("Catalog not open");}
+    return static_cast<size_t> (pImpl->header()->nRows);
+}
+
+/// Column names
+std::vector<std::string> CatalogFile::getColumnNames() const
+{
+    if (!isOpen()){throw std::runtime_error("Catalog not open");}
+    std::vector<std::string> names;
+    const auto *entries = pImpl->entries();
+    for (uint32_t i = 0; i < pImpl->header()->nColumns; ++i)
+    {
+        names.push_back(std::string(entries[i].name,
+                                    strnlen(entries[i].name,
+                                            sizeof(Entry::name))));
+    }
+    return names;
+}
+
+bool CatalogFile::haveColumn(const std::string &name) const noexcept
+{
+    return pImpl->find(name) != nullptr;
+}
+
+ColumnType CatalogFile::getColumnType(const std::string &name) const
+{
+    const auto *entry = pImpl->find(name);
+    if (entry == nullptr)
+    {
+        throw std::invalid_argument("Column " + name + " does not exist");
+    }
+    return static_cast<ColumnType> (entry->type);
+}
+
+/// Columns
+const double *CatalogFile::getFloat64Column(const std::string &name) const
+{
+    return reinterpret_cast<const double *>
+           (pImpl->getColumn(name, ColumnType::Float64));
+}
+
+double *CatalogFile::getMutableFloat64Column(const std::string &name)
+{
+    if (!isWritable())
+    {
+        throw std::runtime_error("Catalog not open for writing");
+    }
+    return reinterpret_cast<double *>
+           (pImpl->getColumn(name, ColumnType::Float64));
+}
+
+const int64_t *CatalogFile::getInt64Column(const std::string &name) const
+{
+    return reinterpret_cast<const int64_t *>
+           (pImpl->getColumn(name, ColumnType::Int64));
+}
+
+int64_t *CatalogFile::getMutableInt64Column(const std::string &name)
+{
+    if (!isWritable())
+    {
+        throw std::runtime_error("Catalog not open for writing");
+    }
+    return reinterpret_cast<int64_t *>
+           (pImpl->getColumn(name, ColumnType::Int64));
+}
+
+/// Annotate
+void SolarCalculator::annotateCatalog(CatalogFile &catalog)
+{
+    if (!catalog.isWritable())
+    {
+        throw std::runtime_error("Catalog not open for writing");
+    }
+    for (const auto &name : {"time", "latitude", "longitude"})
+    {
+        if (!catalog.haveColumn(name))
+        {
+            throw std::invalid_argument("Catalog is missing "
+                                      + std::string {name});
+        }
+    }
+    for (const auto &name : {"elevation", "azimuth"})
+    {
+        if (!catalog.haveColumn(name))
+        {
+            catalog.addColumn(name, ColumnType::Float64);
+        }
+    }
+    computeSolarPositions(catalog.getNumberOfRows(),
+                          catalog.getFloat64Column("time"),
+                          catalog.getFloat64Column("latitude"),
+                          catalog.getFloat64Column("longitude"),
+                          catalog.getMutableFloat64Column("elevation"),
+                          catalog.getMutableFloat64Column("azimuth"));
+}
@@ -0,0 +1,257 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "solarCalculator/dayNight.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+/// The daylight intervals of a local day clipped to that day.  Besides the
+/// day's own interval, near the poles the previous day's sunset or the next
+/// day's sunrise can spill over midnight.
+struct DaylightIntervals
+{
+    std::array<double, 3> begin{0, 0, 0};
+    std::array<double, 3> end{0, 0, 0};
+    int nIntervals = 0;
+    [[nodiscard]] bool contains(const double time) const noexcept
+    {
+        if (nIntervals > 0 && time >= begin[0] && time <= end[0])
+        {
+            return true;
+        }
+        for (int i = 1; i < nIntervals; ++i)
+        {
+            if (time >= begin[i] && time <= end[i]){return true;}
+        }
+        return false;
+    }
+};
+
+DaylightIntervals computeDaylightIntervals(const int64_t day,
+                                           const double latitude,
+                                           const double longitude,
+                                           const double zenith)
+{
+    DaylightIntervals intervals;
+    auto windowBegin = calcLocalMidnight(day, longitude);
+    auto windowEnd = calcLocalMidnight(day + 1, longitude);
+    // The neighboring days can only spill over midnight if the sun can be
+    // above the threshold near lower transit.  That requires
+    // |latitude| + |declination| - 90 >= 90 - zenith with a little margin
+    // for the equation of time.
+    constexpr double maximumDeclination = 23.45;
+    constexpr double margin = 2;
+    int nDays = 1;
+    if (std::abs(latitude) + maximumDeclination + margin >= 180 - zenith)
+    {
+        nDays = 3;
+    }
+    // The day's own interval goes first since it is the one usually hit
+    const std::array<int64_t, 3> days{day, day - 1, day + 1};
+    for (int id = 0; id < nDays; ++id)
+    {
+        auto d = days[id];
+        double rise = 0;
+        double set = 0;
+        double noon = 0;
+        auto kind = calcRiseSetEpochs(d, latitude, longitude, zenith,
+                                      &rise, &set, &noon);
+        if (kind < 0){continue;}
+        auto begin = std::max(rise, windowBegin);
+        auto end = std::min(set, windowEnd);
+        if (begin < end)
+        {
+            intervals.begin[intervals.nIntervals] = begin;
+            intervals.end[intervals.nIntervals] = end;
+            intervals.nIntervals = intervals.nIntervals + 1;
+        }
+    }
+    return intervals;
+}
+
+uint64_t toBits(const double x)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(double));
+    return bits;
+}
+
+}
+
+class DayNightClassifier::DayNightClassifierImpl
+{
+public:
+    /// Number of locks.  Slot i is guarded by lock i%N_LOCKS.
+    static constexpr size_t N_LOCKS = 64;
+    struct Slot
+    {
+        DaylightIntervals intervals;
+        double latitude = 0;
+        double longitude = 0;
+        double zenith = 0;
+        int64_t day = 0;
+        bool valid = false;
+    };
+    explicit DayNightClassifierImpl(const size_t capacity)
+    {
+        size_t n = 1;
+        while (n < capacity){n = 2*n;}
+        mSlots.resize(n);
+        mMask = n - 1;
+    }
+    bool isNight(const double time, const double latitude,
+                 const double longitude, const double depressionAngle)
+    {
+        if (!isValidTime(time))
+        {
+            throw std::invalid_argument("Time " + std::to_string(time)
+                                      + " must be in years [-1000,2999]");
+        }
+        if (!(latitude >= -90 && latitude <= 90))
+        {
+            throw std::invalid_argument("Latitude = "
+                                      + std::to_string(latitude)
+                                      + " must be in range [-90,90]");
+        }
+        if (!std::isfinite(longitude))
+        {
+            throw std::invalid_argument("Longitude must be finite");
+        }
+        if (!(depressionAngle >= -90 && depressionAngle <= 90))
+        {
+            throw std::invalid_argument("Depression angle = "
+                                      + std::to_string(depressionAngle)
+                                      + " must be in range [-90,90]");
+        }
+        auto lon = wrapLongitude(longitude);
+        auto zenith = 90 + depressionAngle;
+        auto day = calcLocalDay(time, lon);
+        uint64_t hash = toBits(latitude)*0x9E3779B97F4A7C15ULL;
+        hash = (hash ^ toBits(lon))*0xC2B2AE3D27D4EB4FULL;
+        hash = (hash ^ toBits(zenith))*0x165667B19E3779F9ULL;
+        hash = (hash ^ static_cast<uint64_t> (day))*0x9E3779B97F4A7C15ULL;
+        auto index = static_cast<size_t> (hash >> 32) & mMask;
+        auto &slot = mSlots[index];
+        {
+        std::scoped_lock lock(mMutexes[index%N_LOCKS]);
+        if (slot.valid && slot.day == day &&
+            slot.latitude == latitude && slot.longitude == lon &&
+            slot.zenith == zenith)
+        {
+            return !slot.intervals.contains(time);
+        }
+        }
+        auto intervals = computeDaylightIntervals(day, latitude, lon, zenith);
+        std::scoped_lock lock(mMutexes[index%N_LOCKS]);
+        slot.intervals = intervals;
+        slot.latitude = latitude;
+        slot.longitude = lon;
+        slot.zenith = zenith;
+        slot.day = day;
+        slot.valid = true;
+        return !intervals.contains(time);
+    }
+    std::vector<Slot> mSlots;
+    std::array<std::mutex, N_LOCKS> mMutexes;
+    size_t mMask = 0;
+};
+
+/// C'tor
+DayNightClassifier::DayNightClassifier(const size_t capacity)
+{
+    if (capacity < 1){throw std::invalid_argument("Capacity must be positive");}
+    pImpl = std::make_unique<DayNightClassifierImpl> (capacity);
+}
+
+/// Move c'tor
+DayNightClassifier::DayNightClassifier(
+    DayNightClassifier &&classifier) noexcept
+{
+    *this = std::move(classifier);
+}
+
+/// Move assignment
+DayNightClassifier&
+DayNightClassifier::operator=(DayNightClassifier &&classifier) noexcept
+{
+    if (&classifier == this){return *this;}
+    pImpl = std::move(classifier.pImpl);
+    return *this;
+}
+
+/// Destructor
+DayNightClassifier::~DayNightClassifier() = default;
+
+/// Clear
+void DayNightClassifier::clear() noexcept
+{
+    for (size_t i = 0; i < pImpl->mSlots.size(); ++i)
+    {
+        std::scoped_lock lock(
+            pImpl->mMutexes[i%DayNightClassifierImpl::N_LOCKS]);
+        pImpl->mSlots[i].valid = false;
+    }
+}
+
+/// Is it night?
+bool DayNightClassifier::isNight(const double time,
+                                 const Observer &observer,
+                                 const double depressionAngle) const
+{
+    return pImpl->isNight(time, observer.latitude, observer.longitude,
+                          depressionAngle);
+}
+
+bool DayNightClassifier::isNight(const double time,
+                                 const Location &location,
+                                 const double depressionAngle) const
+{
+    if (!location.haveLatitude())
+    {
+        throw std::invalid_argument("Latitude not set");
+    }
+    if (!location.haveLongitude())
+    {
+        throw std::invalid_argument("Longitude not set");
+    }
+    return pImpl->isNight(time, location.getLatitude(),
+                          location.getLongitude(), depressionAngle);
+}
+
+/// Batch
+void DayNightClassifier::classify(const size_t nRows,
+                                  const double times[],
+                                  const double latitudes[],
+                                  const double longitudes[],
+                                  bool isNight[],
+                                  const double depressionAngle) const
+{
+    if (nRows == 0){return;}
+    if (times == nullptr){throw std::invalid_argument("times is NULL");}
+    if (latitudes == nullptr)
+    {
+        throw std::invalid_argument("latitudes is NULL");
+    }
+    if (longitudes == nullptr)
+    {
+        throw std::invalid_argument("longitudes is NULL");
+    }
+    if (isNight == nullptr){throw std::invalid_argument("isNight is NULL");}
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        isNight[i] = pImpl->isNight(times[i], latitudes[i], longitudes[i],
+                                    depressionAngle);
+    }
+}
@@ -0,0 +1,220 @@
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "solarCalculator/elevationCrossings.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+/// Crossings are refined until successive estimates agree to this many
+/// seconds.
+constexpr double TOLERANCE = 1.e-3;
+/// Half-width in seconds of the stencil that refines a transit to the
+/// elevation's extremum.
+constexpr double STENCIL = 300;
+
+class Elevation
+{
+public:
+    Elevation(const Observer &observer, const double threshold) :
+        mObserver(observer),
+        mThreshold(threshold)
+    {
+    }
+    /// @result The elevation less the threshold.
+    [[nodiscard]] double operator()(const double time) const noexcept
+    {
+        return computePosition(time, mObserver).elevation - mThreshold;
+    }
+    const Observer &getObserver() const noexcept
+    {
+        return mObserver;
+    }
+private:
+    Observer mObserver;
+    double mThreshold;
+};
+
+/// The declination changes during the day so the elevation's extremum is
+/// not exactly at the transit.  The offset is seconds at mid-latitudes but
+/// minutes near the poles, so it is found with a parabola through the
+/// transit.
+double refineExtremum(const Elevation &elevation, const double transit)
+{
+    auto fm = elevation(transit - STENCIL);
+    auto f0 = elevation(transit);
+    auto fp = elevation(transit + STENCIL);
+    auto curvature = fm - 2.0*f0 + fp;
+    if (curvature == 0 || !std::isfinite(curvature)){return transit;}
+    auto shift = 0.5*STENCIL*(fm - fp)/curvature;
+    if (std::abs(shift) > STENCIL){return transit;}
+    return transit + shift;
+}
+
+/// @result The upper and lower transits in (startTime, endTime).
+std::vector<double> computeBreakpoints(const Elevation &elevation,
+                                       const double startTime,
+                                       const double endTime)
+{
+    auto longitude = elevation.getObserver().longitude;
+    auto firstDay = calcLocalDay(startTime, longitude) - 1;
+    auto lastDay = calcLocalDay(endTime, longitude) + 1;
+    std::vector<double> breakpoints;
+    breakpoints.reserve(static_cast<size_t> (2*(lastDay - firstDay + 1)));
+    for (auto day = firstDay; day <= lastDay; ++day)
+    {
+        auto noon = calcLocalMidnight(day, longitude) + 43200.0;
+        // The lower transit is the upper transit on the opposite meridian
+        for (auto transit : {calcTransitEpoch(noon, longitude),
+                             calcTransitEpoch(noon + 43200.0,
+                                              longitude + 180.0)})
+        {
+            if (transit <= startTime - STENCIL || transit >= endTime + STENCIL)
+            {
+                continue;
+            }
+            auto extremum = refineExtremum(elevation, transit);
+            if (extremum > startTime && extremum < endTime)
+            {
+                breakpoints.push_back(extremum);
+            }
+        }
+    }
+    std::sort(breakpoints.begin(), breakpoints.end());
+    return breakpoints;
+}
+
+/// Illinois regula falsi for the root in [a, b] where fa and fb have
+/// opposite signs.
+double solve(const Elevation &elevation,
+             double a, double b, double fa, double fb)
+{
+    if (fa == 0){return a;}
+    if (fb == 0){return b;}
+    double c = a;
+    double previous = b;
+    int side = 0;
+    for (int iteration = 0; iteration < 100; ++iteration)
+    {
+        c = (fa*b - fb*a)/(fa - fb);
+        if (std::abs(c - previous) < TOLERANCE){break;}
+        previous = c;
+        auto fc = elevation(c);
+        if (fc == 0){break;}
+        if ((fc > 0) == (fb > 0))
+        {
+            b = c;
+            fb = fc;
+            if (side == -1){fa = 0.5*fa;}
+            side = -1;
+        }
+        else
+        {
+            a = c;
+            fa = fc;
+            if (side == 1){fb = 0.5*fb;}
+            side = 1;
+        }
+        if (b - a < TOLERANCE){break;}
+    }
+    return c;
+}
+
+void checkInputs(const Observer &observer,
+                 const double startTime, const double endTime,
+                 const double threshold)
+{
+    if (!isValidTime(startTime) || !isValidTime(endTime))
+    {
+        throw std::invalid_argument("Window must be in years [-1000,2999]");
+    }
+    if (startTime > endTime)
+    {
+        throw std::invalid_argument("startTime = "
+                                  + std::to_string(startTime)
+                                  + " cannot exceed endTime = "
+                                  + std::to_string(endTime));
+    }
+    if (!(observer.latitude >= -90 && observer.latitude <= 90))
+    {
+        throw std::invalid_argument("Latitude must be in range [-90,90]");
+    }
+    if (!(threshold >= -90 && threshold <= 90))
+    {
+        throw std::invalid_argument("Threshold must be in range [-90,90]");
+    }
+}
+
+/// @result The crossings and whether the sun is above the threshold at the
+///         start of the window.
+std::vector<double> findCrossings(const Observer &observer,
+                                  const double startTime,
+                                  const double endTime,
+                                  const double threshold,
+                                  bool *startsAbove)
+{
+    checkInputs(observer, startTime, endTime, threshold);
+    Elevation elevation(observer, threshold);
+    auto breakpoints = computeBreakpoints(elevation, startTime, endTime);
+    breakpoints.push_back(endTime);
+    std::vector<double> crossings;
+    auto a = startTime;
+    auto fa = elevation(a);
+    *startsAbove = (fa >= 0);
+    for (auto b : breakpoints)
+    {
+        auto fb = elevation(b);
+        if ((fa >= 0) != (fb >= 0))
+        {
+            crossings.push_back(solve(elevation, a, b, fa, fb));
+        }
+        a = b;
+        fa = fb;
+    }
+    return crossings;
+}
+
+}
+
+/// Crossings
+std::vector<double> SolarCalculator::findElevationCrossings(
+    const Observer &observer,
+    const double startTime, const double endTime,
+    const double threshold)
+{
+    bool startsAbove = false;
+    return findCrossings(observer, startTime, endTime, threshold,
+                         &startsAbove);
+}
+
+/// Intervals
+std::vector<TimeInterval> SolarCalculator::findElevationIntervals(
+    const Observer &observer,
+    const double startTime, const double endTime,
+    const double threshold,
+    const ElevationRegion region)
+{
+    bool startsAbove = false;
+    auto crossings = findCrossings(observer, startTime, endTime, threshold,
+                                   &startsAbove);
+    auto inside = (region == ElevationRegion::Above) ? startsAbove :
+                                                       !startsAbove;
+    std::vector<TimeInterval> intervals;
+    auto start = startTime;
+    for (auto crossing : crossings)
+    {
+        if (inside){intervals.push_back(TimeInterval{start, crossing});}
+        start = crossing;
+        inside = !inside;
+    }
+    if (inside){intervals.push_back(TimeInterval{start, endTime});}
+    return intervals;
+}
@@ -0,0 +1,180 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <stdexcept>
+#include "solarCalculator/ephemeris.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+/// C'tor
+Ephemeris::Ephemeris(const double time) :
+    mTime(time)
+{
+    if (!isValidEpoch(time))
+    {
+        throw std::invalid_argument("Time " + std::to_string(time)
+                                  + " must be in years [-1000,2999]");
+    }
+    SOLARCALCULATOR_COUNT(EphemerisEvaluations);
+    mJulianCentury = calcTimeJulianCentFromEpoch(time);
+    mDeclination = calcSunDeclination(mJulianCentury);
+    mEquationOfTime = calcEquationOfTime(mJulianCentury);
+    mObliquity = calcObliquityCorrection(mJulianCentury);
+}
+
+/// C'tor
+Ephemeris::Ephemeris(const double time,
+                     const double declination,
+                     const double equationOfTime,
+                     const double obliquity) noexcept :
+    mTime(time),
+    mJulianCentury(calcTimeJulianCentFromEpoch(time)),
+    mDeclination(declination),
+    mEquationOfTime(equationOfTime),
+    mObliquity(obliquity)
+{
+}
+
+double Ephemeris::getTime() const noexcept
+{
+    return mTime;
+}
+
+double Ephemeris::getJulianCentury() const noexcept
+{
+    return mJulianCentury;
+}
+
+double Ephemeris::getDeclination() const noexcept
+{
+    return mDeclination;
+}
+
+double Ephemeris::getEquationOfTime() const noexcept
+{
+    return mEquationOfTime;
+}
+
+double Ephemeris::getObliquity() const noexcept
+{
+    return mObliquity;
+}
+
+///--------------------------------------------------------------------------///
+///                                 Cache                                    ///
+///--------------------------------------------------------------------------///
+
+class EphemerisCache::EphemerisCacheImpl
+{
+public:
+    /// Number of locks.  Slot i is guarded by lock i%N_LOCKS.
+    static constexpr size_t N_LOCKS = 64;
+    struct Slot
+    {
+        Ephemeris ephemeris;
+        int64_t key = 0;
+        bool valid = false;
+    };
+    EphemerisCacheImpl(const double resolution, const size_t capacity) :
+        mResolution(resolution)
+    {
+        size_t n = 1;
+        while (n < capacity){n = 2*n;}
+        mSlots.resize(n);
+        mMask = n - 1;
+    }
+    std::vector<Slot> mSlots;
+    mutable std::array<std::mutex, N_LOCKS> mMutexes;
+    double mResolution = 1;
+    size_t mMask = 0;
+};
+
+/// C'tor
+EphemerisCache::EphemerisCache(const double resolution, const size_t capacity)
+{
+    if (!(resolution > 0))
+    {
+        throw std::invalid_argument("Resolution must be positive");
+    }
+    if (capacity < 1){throw std::invalid_argument("Capacity must be positive");}
+    pImpl = std::make_unique<EphemerisCacheImpl> (resolution, capacity);
+}
+
+/// Move c'tor
+EphemerisCache::EphemerisCache(EphemerisCache &&cache) noexcept
+{
+    *this = std::move(cache);
+}
+
+/// Move assignment
+EphemerisCache& EphemerisCache::operator=(EphemerisCache &&cache) noexcept
+{
+    if (&cache == this){return *this;}
+    pImpl = std::move(cache.pImpl);
+    return *this;
+}
+
+/// Destructor
+EphemerisCache::~EphemerisCache() = default;
+
+/// Clear
+void EphemerisCache::clear() noexcept
+{
+    for (size_t i = 0; i < pImpl->mSlots.size(); ++i)
+    {
+        std::scoped_lock lock(pImpl->mMutexes[i%EphemerisCacheImpl::N_LOCKS]);
+        pImpl->mSlots[i].valid = false;
+    }
+}
+
+/// Lookup
+Ephemeris EphemerisCache::getEphemeris(const double time) const
+{
+    if (!isValidEpoch(time))
+    {
+        throw std::invalid_argument("Time " + std::to_string(time)
+                                  + " must be in years [-1000,2999]");
+    }
+    auto resolution = pImpl->mResolution;
+    auto key = static_cast<int64_t> (std::llround(time/resolution));
+    // Near the ends of the valid range the nearest multiple of the
+    // resolution can fall outside of it.  The multiple on the other side of
+    // the time is then inside since the range contains 0.
+    if (!isValidEpoch(static_cast<double> (key)*resolution))
+    {
+        key = (static_cast<double> (key)*resolution > time) ? key - 1 : key + 1;
+    }
+    // Mix the key so that consecutive times spread over the locks
+    auto hash = static_cast<uint64_t> (key)*0x9E3779B97F4A7C15ULL;
+    auto index = static_cast<size_t> (hash >> 32) & pImpl->mMask;
+    auto &slot = pImpl->mSlots[index];
+    {
+    std::scoped_lock lock(pImpl->mMutexes[index%EphemerisCacheImpl::N_LOCKS]);
+    if (slot.valid && slot.key == key)
+    {
+        SOLARCALCULATOR_COUNT(EphemerisCacheHits);
+        return slot.ephemeris;
+    }
+    }
+    SOLARCALCULATOR_COUNT(EphemerisCacheMisses);
+    // Compute outside of the lock
+    Ephemeris ephemeris(static_cast<double> (key)*resolution);
+    std::scoped_lock lock(pImpl->mMutexes[index%EphemerisCacheImpl::N_LOCKS]);
+    slot.ephemeris = ephemeris;
+    slot.key = key;
+    slot.valid = true;
+    return ephemeris;
+}
+
+double EphemerisCache::getResolution() const noexcept
+{
+    return pImpl->mResolution;
+}
+
+size_t EphemerisCache::getCapacity() const noexcept
+{
+    return pImpl->mSlots.size();
+}
@@ -0,0 +1,428 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "solarCalculator/ephemerisTable.hpp"
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+/// Declination, equation of time, and obliquity
+constexpr uint32_t N_SERIES = 3;
+constexpr uint32_t VERSION = 1;
+constexpr char MAGIC[8] = {'S', 'C', 'E', 'P', 'H', 'T', 'B', 'L'};
+
+/// The file header.  The coefficients immediately follow.
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t nSeries;
+    uint32_t nCoefficients;
+    int32_t firstYear;
+    int32_t lastYear;
+    uint32_t reserved;
+    double startTime;
+    double endTime;
+    double segmentLength;
+    uint64_t nSegments;
+    double maxDeclinationError;
+    double maxEquationOfTimeError;
+};
+static_assert(sizeof(Header) == 80, "Header must be 80 bytes");
+
+/// @result The UTC time at the start of the year clipped to the supported
+///         time range.
+double yearToEpoch(const int year)
+{
+    auto time = static_cast<double> (daysFromCivil(year, 1, 1))*86400.0;
+    return std::clamp(time, MINIMUM_EPOCH, MAXIMUM_EPOCH);
+}
+
+/// @result Sum_j c[j] T_j(x) evaluated with Clenshaw's recurrence.
+inline double clenshaw(const double *c, const int n, const double x) noexcept
+{
+    double b1 = 0;
+    double b2 = 0;
+    auto x2 = 2*x;
+    for (int j = n - 1; j >= 1; --j)
+    {
+        auto b0 = c[j] + x2*b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    return c[0] + x*b1 - b2;
+}
+
+}
+
+class EphemerisTable::EphemerisTableImpl
+{
+public:
+    ~EphemerisTableImpl()
+    {
+        unmap();
+    }
+    void unmap() noexcept
+    {
+        if (mMap){munmap(mMap, mMapSize);}
+        mMap = nullptr;
+        mMapSize = 0;
+    }
+    /// Sets the derived quantities once the header and data are available.
+    void finalize(const double *data)
+    {
+        mData = data;
+        mStartTime = mHeader.startTime;
+        mEndTime = mHeader.endTime;
+        mInverseSegmentLength = 1./mHeader.segmentLength;
+        mNCoefficients = static_cast<int> (mHeader.nCoefficients);
+        mNSegments = static_cast<size_t> (mHeader.nSegments);
+        mInitialized = true;
+    }
+    /// @result The coefficients of the segment containing the time and the
+    ///         time mapped to [-1,1] in that segment.
+    const double *locate(const double time, double *x) const noexcept
+    {
+        auto s = (time - mStartTime)*mInverseSegmentLength;
+        auto k = std::min(static_cast<size_t> (std::max(s, 0.0)),
+                          mNSegments - 1);
+        *x = 2*(s - static_cast<double> (k)) - 1;
+        return mData + k*N_SERIES*mNCoefficients;
+    }
+    Header mHeader;
+    /// Coefficients when the table was fit in memory
+    std::vector<double> mCoefficients;
+    /// The coefficients; either in mCoefficients or the mapped file
+    const double *mData = nullptr;
+    void *mMap = nullptr;
+    size_t mMapSize = 0;
+    double mStartTime = 0;
+    double mEndTime = 0;
+    double mInverseSegmentLength = 0;
+    size_t mNSegments = 0;
+    int mNCoefficients = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+EphemerisTable::EphemerisTable() :
+    pImpl(std::make_unique<EphemerisTableImpl> ())
+{
+}
+
+/// Move c'tor
+EphemerisTable::EphemerisTable(EphemerisTable &&table) noexcept
+{
+    *this = std::move(table);
+}
+
+/// Move assignment
+EphemerisTable& EphemerisTable::operator=(EphemerisTable &&table) noexcept
+{
+    if (&table == this){return *this;}
+    pImpl = std::move(table.pImpl);
+    return *this;
+}
+
+/// Destructor
+EphemerisTable::~EphemerisTable() = default;
+
+/// Clear
+void EphemerisTable::clear() noexcept
+{
+    pImpl = std::make_unique<EphemerisTableImpl> ();
+}
+
+/// Fit the table
+void EphemerisTable::initialize(const int firstYear, const int lastYear,
+                                const double segmentLength,
+                                const int nCoefficients)
+{
+    if (firstYear < -1000 || lastYear > 2999)
+    {
+        throw std::invalid_argument("Years must be in range [-1000,2999]");
+    }
+    if (firstYear > lastYear)
+    {
+        throw std::invalid_argument("firstYear = " + std::to_string(firstYear)
+                                  + " cannot exceed lastYear = "
+                                  + std::to_string(lastYear));
+    }
+    if (!(segmentLength > 0))
+    {
+        throw std::invalid_argument("Segment length must be positive");
+    }
+    if (nCoefficients < 2 || nCoefficients > 32)
+    {
+        throw std::invalid_argument("nCoefficients = "
+                                  + std::to_string(nCoefficients)
+                                  + " must be in range [2,32]");
+    }
+    auto startTime = yearToEpoch(firstYear);
+    auto endTime = yearToEpoch(lastYear + 1);
+    auto nSegments
+        = static_cast<size_t> (std::ceil((endTime - startTime)/segmentLength));
+    nSegments = std::max(nSegments, static_cast<size_t> (1));
+    auto n = nCoefficients;
+    std::vector<double> coefficients(nSegments*N_SERIES*n, 0.0);
+    // The Chebyshev nodes and the weights cos(j theta_k)
+    std::vector<double> nodes(n);
+    std::vector<double> weights(n*n);
+    for (int k = 0; k < n; ++k)
+    {
+        auto theta = M_PI*(k + 0.5)/n;
+        nodes[k] = std::cos(theta);
+        for (int j = 0; j < n; ++j)
+        {
+            weights[j*n + k] = std::cos(j*theta)*(2.0/n);
+        }
+    }
+    // The Chebyshev extrema interleave the nodes so this is where the
+    // interpolation error is largest
+    std::vector<double> extrema(n + 1);
+    for (int k = 0; k <= n; ++k){extrema[k] = std::cos(M_PI*k/n);}
+    std::vector<double> values(N_SERIES*n);
+    double maxDeclinationError = 0;
+    double maxEquationOfTimeError = 0;
+    for (size_t iSegment = 0; iSegment < nSegments; ++iSegment)
+    {
+        auto t0 = startTime + static_cast<double> (iSegment)*segmentLength;
+        for (int k = 0; k < n; ++k)
+        {
+            auto T = toJulianCentury(t0 + 0.5*(nodes[k] + 1)*segmentLength);
+            values[k]       = calcSunDeclinationBranchless(T);
+            values[n + k]   = calcEquationOfTimeBranchless(T);
+            values[2*n + k] = calcObliquityCorrection(T);
+        }
+        auto *c = coefficients.data() + iSegment*N_SERIES*n;
+        for (uint32_t iSeries = 0; iSeries < N_SERIES; ++iSeries)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                double sum = 0;
+                for (int k = 0; k < n; ++k)
+                {
+                    sum = sum + weights[j*n + k]*values[iSeries*n + k];
+                }
+                c[iSeries*n + j] = sum;
+            }
+            c[iSeries*n] = 0.5*c[iSeries*n];
+        }
+        for (const auto x : extrema)
+        {
+            auto T = toJulianCentury(t0 + 0.5*(x + 1)*segmentLength);
+            maxDeclinationError
+                = std::max(maxDeclinationError,
+                           std::abs(clenshaw(c, n, x)
+                                  - calcSunDeclinationBranchless(T)));
+            maxEquationOfTimeError
+                = std::max(maxEquationOfTimeError,
+                           std::abs(clenshaw(c + n, n, x)
+                                  - calcEquationOfTimeBranchless(T)));
+        }
+    }
+    // Fill the header
+    auto impl = std::make_unique<EphemerisTableImpl> ();
+    std::memcpy(impl->mHeader.magic, MAGIC, sizeof(MAGIC));
+    impl->mHeader.version = VERSION;
+    impl->mHeader.nSeries = N_SERIES;
+    impl->mHeader.nCoefficients = static_cast<uint32_t> (n);
+    impl->mHeader.firstYear = firstYear;
+    impl->mHeader.lastYear = lastYear;
+    impl->mHeader.reserved = 0;
+    impl->mHeader.startTime = startTime;
+    impl->mHeader.endTime = endTime;
+    impl->mHeader.segmentLength = segmentLength;
+    impl->mHeader.nSegments = nSegments;
+    impl->mHeader.maxDeclinationError = maxDeclinationError;
+    impl->mHeader.maxEquationOfTimeError = maxEquationOfTimeError;
+    impl->mCoefficients = std::move(coefficients);
+    impl->finalize(impl->mCoefficients.data());
+    pImpl = std::move(impl);
+}
+
+/// Save the table
+void EphemerisTable::save(const std::string &fileName) const
+{
+    if (!isInitialized()){throw std::runtime_error("Table not initialized");}
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open " + fileName);
+    }
+    file.write(reinterpret_cast<const char *> (&pImpl->mHeader),
+               sizeof(Header));
+    auto nBytes = pImpl->mNSegments*N_SERIES*pImpl->mNCoefficients
+                 *sizeof(double);
+    file.write(reinterpret_cast<const char *> (pImpl->mData),
+               static_cast<std::streamsize> (nBytes));
+    file.close();
+    if (!file){throw std::runtime_error("Failed to write " + fileName);}
+}
+
+/// Load the table
+void EphemerisTable::load(const std::string &fileName)
+{
+    if (!std::filesystem::exists(fileName))
+    {
+        throw std::invalid_argument(fileName + " does not exist");
+    }
+    auto fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0){throw std::runtime_error("Failed to open " + fileName);}
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("Failed to stat " + fileName);
+    }
+    auto fileSize = static_cast<size_t> (status.st_size);
+    if (fileSize < sizeof(Header))
+    {
+        close(fd);
+        throw std::runtime_error(fileName + " is too small");
+    }
+    auto map = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map " + fileName);
+    }
+    auto impl = std::make_unique<EphemerisTableImpl> ();
+    impl->mMap = map;
+    impl->mMapSize = fileSize;
+    std::memcpy(&impl->mHeader, map, sizeof(Header));
+    const auto &header = impl->mHeader;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        throw std::runtime_error(fileName + " is not an ephemeris table");
+    }
+    if (header.version != VERSION)
+    {
+        throw std::runtime_error("Unsupported version "
+                               + std::to_string(header.version));
+    }
+    if (header.nSeries != N_SERIES ||
+        header.nCoefficients < 2 || header.nCoefficients > 32 ||
+        header.nSegments < 1 || !(header.segmentLength > 0) ||
+        !(header.endTime > header.startTime) ||
+        !(header.startTime >= MINIMUM_EPOCH) ||
+        !(header.endTime <= MAXIMUM_EPOCH))
+    {
+        throw std::runtime_error(fileName + " has an invalid header");
+    }
+    // The segments must exactly cover the time range, as in initialize()
+    auto nExpected
+        = std::max(1.0, std::ceil((header.endTime - header.startTime)
+                                  /header.segmentLength));
+    if (static_cast<double> (header.nSegments) != nExpected)
+    {
+        throw std::runtime_error(fileName + " has an invalid header");
+    }
+    // Bound the segment count by the file size before multiplying so a
+    // corrupt header cannot overflow the expected size
+    auto segmentBytes = N_SERIES*static_cast<size_t> (header.nCoefficients)
+                       *sizeof(double);
+    if (header.nSegments > (fileSize - sizeof(Header))/segmentBytes)
+    {
+        throw std::runtime_error(fileName + " is too small for "
+                               + std::to_string(header.nSegments)
+                               + " segments");
+    }
+    auto nBytes = sizeof(Header) + header.nSegments*segmentBytes;
+    if (nBytes != fileSize)
+    {
+        throw std::runtime_error(fileName + " has size "
+                               + std::to_string(fileSize) + " but expected "
+                               + std::to_string(nBytes));
+    }
+    impl->finalize(reinterpret_cast<const double *>
+                   (static_cast<const char *> (map) + sizeof(Header)));
+    pImpl = std::move(impl);
+}
+
+/// Initialized?
+bool EphemerisTable::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Contains time?
+bool EphemerisTable::contains(const double time) const noexcept
+{
+    return pImpl->mInitialized &&
+           time >= pImpl->mStartTime && time < pImpl->mEndTime;
+}
+
+/// Evaluate
+void EphemerisTable::evaluate(const double time,
+                              double *declination,
+                              double *equationOfTime) const noexcept
+{
+    double x;
+    const auto *c = pImpl->locate(time, &x);
+    auto n = pImpl->mNCoefficients;
+    *declination = clenshaw(c, n, x);
+    *equationOfTime = clenshaw(c + n, n, x);
+}
+
+/// Ephemeris
+Ephemeris EphemerisTable::getEphemeris(const double time) const
+{
+    if (!isInitialized()){throw std::runtime_error("Table not initialized");}
+    if (!contains(time))
+    {
+        throw std::invalid_argument("Time " + std::to_string(time)
+                                  + " must be in range ["
+                                  + std::to_string(pImpl->mStartTime) + ","
+                                  + std::to_string(pImpl->mEndTime) + ")");
+    }
+    double x;
+    const auto *c = pImpl->locate(time, &x);
+    auto n = pImpl->mNCoefficients;
+    return Ephemeris(time,
+                     clenshaw(c, n, x),
+                     clenshaw(c + n, n, x),
+                     clenshaw(c + 2*n, n, x));
+}
+
+/// Time span
+double EphemerisTable::getStartTime() const
+{
+    if (!isInitialized()){throw std::runtime_error("Table not initialized");}
+    return pImpl->mStartTime;
+}
+
+double EphemerisTable::getEndTime() const
+{
+    if (!isInitialized()){throw std::runtime_error("Table not initialized");}
+    return pImpl->mEndTime;
+}
+
+/// Errors
+double EphemerisTable::getMaximumDeclinationError() const
+{
+    if (!isInitialized()){throw std::runtime_error("Table not initialized");}
+    return pImpl->mHeader.maxDeclinationError;
+}
+
+double EphemerisTable::getMaximumEquationOfTimeError() const
+{
+    if (!isInitialized()){throw std::runtime_error("Table not initialized");}
+    return pImpl->mHeader.maxEquationOfTimeError;
+}
@@ -0,0 +1,213 @@
+#ifndef PRIVATE_SOLARCALCULATOR_FAST_KERNELS_HPP
+#define PRIVATE_SOLARCALCULATOR_FAST_KERNELS_HPP
+#include <cmath>
+#include "kernels.hpp"
+/// The fast accuracy tier.  These are the branchless kernels with libm's
+/// sin, cos, tan, asin, and acos replaced by short polynomials and floor,
+/// fmin, and fmax replaced by selects.  This is straight-line code, so with
+/// the -fno-trapping-math and -fno-math-errno that CMakeLists.txt sets for
+/// batch.cpp GCC vectorizes the batch loops calling these at -O3 (the
+/// Release default); at -O2 it does not.  The polynomials are:
+///   sin/cos: Cephes' minimax polynomials on [-45,45] degrees with the
+///            argument reduced exactly by multiples of 90 degrees
+///            (|error| ~ 1.e-16),
+///   acos:    Abramowitz and Stegun 4.4.46 (|error| < 2.e-8 radians).
+/// The arccosine dominates so the resulting angles differ from the exact
+/// tier by ~1.e-6 degrees; see Accuracy::Fast for the documented bounds.
+namespace SolarCalculator::Kernels::Fast
+{
+
+constexpr double PI = 3.14159265358979323846;
+
+/// @result x rounded to the nearest integer.  Adding and subtracting
+///         1.5*2^52 rounds in the default rounding mode; this is exact for
+///         |x| < 2^51.
+inline double round(const double x)
+{
+    constexpr double MAGIC = 6755399441055744.0;
+    return (x + MAGIC) - MAGIC;
+}
+
+/// @result std::floor(x) for |x| < 2^51.
+inline double floor(const double x)
+{
+    auto r = round(x);
+    return (r > x) ? r - 1.0 : r;
+}
+
+/// @result x clamped to [-1,1].
+inline double clamp(const double x)
+{
+    return (x < -1.0) ? -1.0 : ((x > 1.0) ? 1.0 : x);
+}
+
+/// @sa Kernels::calcGeomMeanLongSunBranchless()
+inline double calcGeomMeanLongSun(const double t)
+{
+    auto L0 = 280.46646 + t*(36000.76983 + t*(0.0003032));
+    return L0 - 360.0*floor(L0/360.0);
+}
+
+/// @sa Kernels::calcMinutesOfDayFromEpoch()
+inline double calcMinutesOfDayFromEpoch(const double epoch)
+{
+    return (epoch - 86400.0*floor(epoch/86400.0))/60.0;
+}
+
+/// @sa Kernels::calcHourAngleBranchless()
+inline double calcHourAngle(const double minutesOfDay,
+                            const double longitude,
+                            const double eqTime)
+{
+    auto hourAngle = (minutesOfDay + eqTime + 4.0*longitude)/4.0 - 180.0;
+    return hourAngle - 360.0*floor((hourAngle + 180.0)/360.0);
+}
+
+/// @brief Computes the sine and cosine of an angle in degrees.
+inline void sinCosDeg(const double degrees, double *sine, double *cosine)
+{
+    // Multiples of 90 degrees are exact so the reduction is exact
+    auto quadrant = round(degrees/90.0);
+    auto x = degToRad(degrees - 90.0*quadrant);
+    auto x2 = x*x;
+    auto s = x + x*x2*(-1.66666666666666307295e-1
+                     + x2*(8.33333333332211858878e-3
+                     + x2*(-1.98412698295895385996e-4
+                     + x2*(2.75573136213857245213e-6
+                     + x2*(-2.50507477628578072866e-8
+                     + x2*1.58962301576546568060e-10)))));
+    auto c = 1.0 - 0.5*x2 + x2*x2*(4.16666666666665929218e-2
+                                 + x2*(-1.38888888888730564116e-3
+                                 + x2*(2.48015872888517045348e-5
+                                 + x2*(-2.75573141792967388112e-7
+                                 + x2*(2.08757008419747316778e-9
+                                 + x2*(-1.13585365213876817300e-11))))));
+    // Rotate by the quadrant in [0,4)
+    auto q = quadrant - 4.0*floor(0.25*quadrant);
+    auto swap = (q == 1.0 || q == 3.0);
+    auto sinValue = swap ? c : s;
+    auto cosValue = swap ? s : c;
+    *sine = (q >= 2.0) ? -sinValue : sinValue;
+    *cosine = (q == 1.0 || q == 2.0) ? -cosValue : cosValue;
+}
+
+inline double sinDeg(const double degrees)
+{
+    double s, c;
+    sinCosDeg(degrees, &s, &c);
+    return s;
+}
+
+inline double cosDeg(const double degrees)
+{
+    double s, c;
+    sinCosDeg(degrees, &s, &c);
+    return c;
+}
+
+/// @result The arccosine in radians of x in [-1,1].
+inline double acos(const double x)
+{
+    auto a = std::fabs(x);
+    auto p = 1.5707963050 + a*(-0.2145988016
+                          + a*(0.0889789874
+                          + a*(-0.0501743046
+                          + a*(0.0308918810
+                          + a*(-0.0170881256
+                          + a*(0.0066700901
+                          + a*(-0.0012624911)))))));
+    auto r = std::sqrt(1.0 - a)*p;
+    return (x < 0) ? PI - r : r;
+}
+
+/// @result The arcsine in radians of x in [-1,1].
+inline double asin(const double x)
+{
+    return 0.5*PI - acos(x);
+}
+
+inline double calcObliquityCorrection(const double t)
+{
+    return calcMeanObliquityOfEcliptic(t)
+         + 0.00256*cosDeg(125.04 - 1934.136*t);
+}
+
+/// @result The equation of time in minutes.
+/// @sa Kernels::calcEquationOfTimeFromAngles()
+inline double calcEquationOfTimeFromAngles(const double t,
+                                           const double l0, const double m)
+{
+    auto epsilon = calcObliquityCorrection(t);
+    auto e = calcEccentricityEarthOrbit(t);
+    double sinHalf, cosHalf;
+    sinCosDeg(0.5*epsilon, &sinHalf, &cosHalf);
+    auto y = sinHalf/cosHalf;
+    y *= y;
+    double sin2l0, cos2l0, sinm, cosm;
+    sinCosDeg(2.0*l0, &sin2l0, &cos2l0);
+    sinCosDeg(m, &sinm, &cosm);
+    auto sin4l0 = 2.0*sin2l0*cos2l0;
+    auto sin2m = 2.0*sinm*cosm;
+    auto Etime = y*sin2l0 - 2.0*e*sinm + 4.0*e*y*sinm*cos2l0
+               - 0.5*y*y*sin4l0 - 1.25*e*e*sin2m;
+    return radToDeg(Etime)*4.0;
+}
+
+/// @result The solar declination in degrees.
+/// @sa Kernels::calcSunDeclinationFromAngles()
+inline double calcSunDeclinationFromAngles(const double t,
+                                           const double l0, const double m)
+{
+    double sinm, cosm;
+    sinCosDeg(m, &sinm, &cosm);
+    auto sin2m = 2.0*sinm*cosm;
+    auto sin3m = sinm*(3.0 - 4.0*sinm*sinm);
+    auto C = sinm*(1.914602 - t*(0.004817 + 0.000014*t))
+           + sin2m*(0.019993 - 0.000101*t) + sin3m*0.000289;
+    auto lambda = l0 + C - 0.00569 - 0.00478*sinDeg(125.04 - 1934.136*t);
+    auto sint = sinDeg(calcObliquityCorrection(t))*sinDeg(lambda);
+    return radToDeg(asin(sint));
+}
+
+/// @result The refraction correction in degrees.
+/// @sa Kernels::calcRefractionMasked()
+inline double calcRefractionMasked(const double elev)
+{
+    double s, c;
+    sinCosDeg(elev, &s, &c);
+    auto te = s/c;
+    auto te3 = te*te*te;
+    auto high = 58.1/te - 0.07/te3 + 0.000086/(te3*te*te);
+    auto low = 1735.0
+             + elev*(-518.2 + elev*(103.4 + elev*(-12.79 + elev*0.711)));
+    auto negative = -20.774/te;
+    auto correction = (elev > 5.0) ? high : ((elev > -0.575) ? low : negative);
+    return (elev > 85.0) ? 0.0 : correction/3600.0;
+}
+
+/// @brief Computes the azimuth and refraction corrected elevation.
+/// @sa Kernels::calcAzElFromCosines()
+inline void calcAzElFromCosines(const double cosHourAngle,
+                                const double hourAngleSign,
+                                const double sinLat, const double cosLat,
+                                const double sinDec, const double cosDec,
+                                double *azimuth, double *elevation)
+{
+    auto csz = sinLat*sinDec + cosLat*cosDec*cosHourAngle;
+    csz = clamp(csz);
+    auto zenithRad = acos(csz);
+    auto sinZenith = std::sqrt(1.0 - csz*csz);
+    auto azDenom = cosLat*sinZenith;
+    auto azRad = (sinLat*csz - sinDec)/azDenom;
+    azRad = clamp(azRad);
+    auto az = 180.0 - radToDeg(acos(azRad));
+    az = (hourAngleSign > 0.0) ? -az : az;
+    auto polarAz = (sinLat > 0.0) ? 180.0 : 0.0;
+    az = (std::abs(azDenom) > 0.001) ? az : polarAz;
+    *azimuth = (az < 0.0) ? az + 360.0 : az;
+    auto exoatmElevation = 90.0 - radToDeg(zenithRad);
+    *elevation = exoatmElevation + calcRefractionMasked(exoatmElevation);
+}
+
+}
+#endif
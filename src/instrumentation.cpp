@@ -0,0 +1,223 @@
+#include <cmath>
+#include <algorithm>
+#include "solarCalculator/instrumentation.hpp"
+#include "instrumentationMacros.hpp"
+#ifdef SOLARCALCULATOR_INSTRUMENTATION
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+using namespace SolarCalculator::Instrumentation;
+
+#ifdef SOLARCALCULATOR_INSTRUMENTATION
+namespace
+{
+
+/// Tracks the live threads' blocks.  A thread's counts are folded into
+/// mRetired when it exits.  Resetting subtracts a baseline rather than
+/// writing to the threads' blocks, which only their owners write.
+class Registry
+{
+public:
+    void add(Detail::Block *block)
+    {
+        std::scoped_lock lock(mMutex);
+        mBlocks.push_back(block);
+    }
+    void remove(Detail::Block *block)
+    {
+        std::scoped_lock lock(mMutex);
+        accumulate(*block, &mRetired);
+        mBlocks.erase(std::remove(mBlocks.begin(), mBlocks.end(), block),
+                      mBlocks.end());
+    }
+    Snapshot snapshot()
+    {
+        std::scoped_lock lock(mMutex);
+        auto result = sum();
+        for (int i = 0; i < NUMBER_OF_COUNTERS; ++i)
+        {
+            result.counts[i] = result.counts[i] - mBaseline.counts[i];
+        }
+        for (int i = 0; i < NUMBER_OF_TIMERS; ++i)
+        {
+            for (int j = 0; j < NUMBER_OF_BINS; ++j)
+            {
+                result.histograms[i][j] = result.histograms[i][j]
+                                        - mBaseline.histograms[i][j];
+            }
+        }
+        return result;
+    }
+    void reset()
+    {
+        std::scoped_lock lock(mMutex);
+        mBaseline = sum();
+    }
+private:
+    static void accumulate(const Detail::Block &block, Snapshot *result)
+    {
+        for (int i = 0; i < NUMBER_OF_COUNTERS; ++i)
+        {
+            result->counts[i] = result->counts[i]
+                + block.counts[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < NUMBER_OF_TIMERS; ++i)
+        {
+            for (int j = 0; j < NUMBER_OF_BINS; ++j)
+            {
+                result->histograms[i][j] = result->histograms[i][j]
+                    + block.histograms[i][j].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    /// The totals since the process started.
+    Snapshot sum() const
+    {
+        auto result = mRetired;
+        for (const auto *block : mBlocks){accumulate(*block, &result);}
+        return result;
+    }
+    std::mutex mMutex;
+    std::vector<Detail::Block *> mBlocks;
+    Snapshot mRetired;
+    Snapshot mBaseline;
+};
+
+Registry &getRegistry()
+{
+    // Never destroyed so that threads exiting after main() can still
+    // unregister.
+    static auto *registry = new Registry();
+    return *registry;
+}
+
+/// Registers the thread's block on creation and folds its counts into the
+/// registry on thread exit.
+class ThreadBlock
+{
+public:
+    ThreadBlock()
+    {
+        getRegistry().add(&mBlock);
+    }
+    ~ThreadBlock()
+    {
+        getRegistry().remove(&mBlock);
+    }
+    ThreadBlock(const ThreadBlock &) = delete;
+    ThreadBlock& operator=(const ThreadBlock &) = delete;
+    Detail::Block mBlock;
+};
+
+}
+
+Detail::Block &Detail::getThreadBlock()
+{
+    thread_local ThreadBlock block;
+    return block.mBlock;
+}
+#endif
+
+/// Counts
+uint64_t Snapshot::getCount(const Counter counter) const noexcept
+{
+    return counts[static_cast<int> (counter)];
+}
+
+const std::array<uint64_t, NUMBER_OF_BINS>&
+    Snapshot::getHistogram(const Timer timer) const noexcept
+{
+    return histograms[static_cast<int> (timer)];
+}
+
+uint64_t Snapshot::getNumberOfSamples(const Timer timer) const noexcept
+{
+    uint64_t n = 0;
+    for (auto count : getHistogram(timer)){n = n + count;}
+    return n;
+}
+
+double Snapshot::getPercentile(const Timer timer,
+                               const double percentile) const noexcept
+{
+    auto n = getNumberOfSamples(timer);
+    if (n == 0){return 0;}
+    auto target = std::clamp(percentile, 0.0, 100.0)/100.0
+                 *static_cast<double> (n);
+    const auto &histogram = getHistogram(timer);
+    uint64_t cumulative = 0;
+    for (int bin = 0; bin < NUMBER_OF_BINS; ++bin)
+    {
+        cumulative = cumulative + histogram[bin];
+        if (histogram[bin] > 0 && static_cast<double> (cumulative) >= target)
+        {
+            return std::ldexp(1.0, bin + 1);
+        }
+    }
+    return std::ldexp(1.0, NUMBER_OF_BINS);
+}
+
+/// Enabled?
+bool SolarCalculator::Instrumentation::isEnabled() noexcept
+{
+#ifdef SOLARCALCULATOR_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Snapshot
+Snapshot SolarCalculator::Instrumentation::snapshot()
+{
+#ifdef SOLARCALCULATOR_INSTRUMENTATION
+    return getRegistry().snapshot();
+#else
+    return Snapshot {};
+#endif
+}
+
+/// Reset
+void SolarCalculator::Instrumentation::reset()
+{
+#ifdef SOLARCALCULATOR_INSTRUMENTATION
+    getRegistry().reset();
+#endif
+}
+
+/// Names
+const char *SolarCalculator::Instrumentation::toString(
+    const Counter counter) noexcept
+{
+    switch (counter)
+    {
+        case Counter::EphemerisEvaluations: return "EphemerisEvaluations";
+        case Counter::PositionEvaluations: return "PositionEvaluations";
+        case Counter::RiseSetSolves: return "RiseSetSolves";
+        case Counter::RiseSetSearches: return "RiseSetSearches";
+        case Counter::PolarJumps: return "PolarJumps";
+        case Counter::NaNResults: return "NaNResults";
+        case Counter::SunCacheHits: return "SunCacheHits";
+        case Counter::SunCacheMisses: return "SunCacheMisses";
+        case Counter::EphemerisCacheHits: return "EphemerisCacheHits";
+        case Counter::EphemerisCacheMisses: return "EphemerisCacheMisses";
+        case Counter::BatchRows: return "BatchRows";
+        case Counter::AlmanacRows: return "AlmanacRows";
+    }
+    return "Unknown";
+}
+
+const char *SolarCalculator::Instrumentation::toString(
+    const Timer timer) noexcept
+{
+    switch (timer)
+    {
+        case Timer::SunUpdate: return "SunUpdate";
+        case Timer::RiseSetSearch: return "RiseSetSearch";
+        case Timer::Batch: return "Batch";
+        case Timer::Almanac: return "Almanac";
+    }
+    return "Unknown";
+}
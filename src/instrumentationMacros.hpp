@@ -0,0 +1,86 @@
+#ifndef SOLARCALCULATOR_INSTRUMENTATION_MACROS_HPP
+#define SOLARCALCULATOR_INSTRUMENTATION_MACROS_HPP
+#include "solarCalculator/instrumentation.hpp"
+/// The recording sites.  Without SOLARCALCULATOR_INSTRUMENTATION these
+/// expand to nothing and their arguments are not evaluated.
+#ifdef SOLARCALCULATOR_INSTRUMENTATION
+#include <atomic>
+#include <chrono>
+namespace SolarCalculator::Instrumentation::Detail
+{
+/// One thread's counters.  Only the owning thread writes so the updates
+/// are relaxed loads and stores rather than read-modify-writes.
+struct Block
+{
+    std::array<std::atomic<uint64_t>, NUMBER_OF_COUNTERS> counts{};
+    std::array<std::array<std::atomic<uint64_t>, NUMBER_OF_BINS>,
+               NUMBER_OF_TIMERS> histograms{};
+};
+
+/// @result The calling thread's counters.
+Block &getThreadBlock();
+
+inline void increment(std::atomic<uint64_t> &value, const uint64_t n)
+{
+    value.store(value.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+
+inline void count(const Counter counter, const uint64_t n = 1)
+{
+    increment(getThreadBlock().counts[static_cast<int> (counter)], n);
+}
+
+inline void record(const Timer timer, const uint64_t nanoseconds)
+{
+    int bin = 0;
+    for (auto t = nanoseconds >> 1; t != 0 && bin < NUMBER_OF_BINS - 1;
+         t >>= 1)
+    {
+        bin = bin + 1;
+    }
+    increment(getThreadBlock().histograms[static_cast<int> (timer)][bin], 1);
+}
+
+/// Records the lifetime of the object in the timer's histogram.
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const Timer timer) :
+        mStart(std::chrono::steady_clock::now()),
+        mTimer(timer)
+    {
+    }
+    ~ScopedTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - mStart;
+        record(mTimer, static_cast<uint64_t> (
+            std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed)
+           .count()));
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer& operator=(const ScopedTimer &) = delete;
+private:
+    std::chrono::steady_clock::time_point mStart;
+    Timer mTimer;
+};
+}
+#define SOLARCALCULATOR_CONCATENATE_(a, b) a##b
+#define SOLARCALCULATOR_CONCATENATE(a, b) SOLARCALCULATOR_CONCATENATE_(a, b)
+#define SOLARCALCULATOR_COUNT(counter) \
+    ::SolarCalculator::Instrumentation::Detail::count( \
+        ::SolarCalculator::Instrumentation::Counter::counter)
+#define SOLARCALCULATOR_COUNT_N(counter, n) \
+    ::SolarCalculator::Instrumentation::Detail::count( \
+        ::SolarCalculator::Instrumentation::Counter::counter, \
+        static_cast<uint64_t> (n))
+#define SOLARCALCULATOR_TIME_SCOPE(timer) \
+    ::SolarCalculator::Instrumentation::Detail::ScopedTimer \
+        SOLARCALCULATOR_CONCATENATE(solarCalculatorTimer, __LINE__)( \
+            ::SolarCalculator::Instrumentation::Timer::timer)
+#else
+#define SOLARCALCULATOR_COUNT(counter) static_cast<void> (0)
+#define SOLARCALCULATOR_COUNT_N(counter, n) static_cast<void> (0)
+#define SOLARCALCULATOR_TIME_SCOPE(timer) static_cast<void> (0)
+#endif
+#endif
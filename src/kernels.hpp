@@ -0,0 +1,866 @@
+#ifndef SOLARCALCULATOR_KERNELS_HPP
+#define SOLARCALCULATOR_KERNELS_HPP
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <utility>
+#include "solarCalculator/julianDate.hpp"
+#include "instrumentationMacros.hpp"
+/// @brief The NOAA solar calculator formulas shared by the library's
+///        translation units.  This header is private and is not installed.
+/// @note Translation units including this must be compiled with
+///       -fno-fast-math.
+namespace SolarCalculator::Kernels
+{
+
+///--------------------------------------------------------------------------///
+///                              Angle Conversions                           ///
+///--------------------------------------------------------------------------///
+
+template<typename T>
+inline T radToDeg(const T angleRad)
+{
+    return (static_cast<T> (180)*angleRad)/static_cast<T> (M_PI);
+}
+
+template<typename T>
+inline T degToRad(const T angleDeg)
+{
+    return (static_cast<T> (M_PI)*angleDeg)/static_cast<T> (180);
+}
+
+///--------------------------------------------------------------------------///
+///                                Earth's tilt                              ///
+///--------------------------------------------------------------------------///
+template<typename T>
+inline T calcEccentricityEarthOrbit(const T t)
+{
+    return T(0.016708634) - t*(T(0.000042037) + T(0.0000001267)*t); // Unitless
+}
+
+template<typename T>
+inline T calcMeanObliquityOfEcliptic(const T t)
+{
+    T seconds = T(21.448) - t*(T(46.8150) + t*(T(0.00059) - t*(T(0.001813))));
+    T e0 = T(23.0) + (T(26.0) + (seconds/T(60.0)))/T(60.0);
+    return e0; // in degrees
+}
+
+template<typename T>
+inline T calcObliquityCorrection(const T t)
+{
+    auto e0 = calcMeanObliquityOfEcliptic(t);
+    auto omega = T(125.04) - T(1934.136) * t;
+    auto e = e0 + T(0.00256) * std::cos(degToRad(omega));
+    return e; // in degrees
+}
+
+inline double calcRefraction(const double elev)
+{
+    double correction = 0;
+    if (elev > 85.0)
+    {
+        correction = 0.0;
+    }
+    else
+    {
+        auto te = std::tan(degToRad(elev));
+        if (elev > 5.0)
+        {
+            correction = 58.1/te - 0.07/(te*te*te) + 0.000086/(te*te*te*te*te);
+        }
+        else if (elev > -0.575)
+        {
+            correction = 1735.0
+                 + elev*(-518.2 + elev*(103.4 + elev*(-12.79 + elev*0.711)));
+        }
+        else
+        {
+            correction = -20.774/te;
+        }
+        correction = correction/3600.0;
+    }
+    return correction;
+}
+
+///--------------------------------------------------------------------------///
+///                                Sun's geometry                            ///
+///--------------------------------------------------------------------------///
+inline double calcGeomMeanLongSun(const double t)
+{
+    auto L0 = 280.46646 + t*(36000.76983 + t*(0.0003032));
+    while (L0 > 360.0)
+    {
+        L0 -= 360.0;
+    }
+    while (L0 < 0.0)
+    {
+        L0 += 360.0;
+    }
+    return L0; // in degrees
+}
+
+/// @result The geometric mean longitude in degrees in [0,360).  Unlike
+///         calcGeomMeanLongSun() the cost does not depend on the time.
+inline double calcGeomMeanLongSunBranchless(const double t)
+{
+    auto L0 = 280.46646 + t*(36000.76983 + t*(0.0003032));
+    return L0 - 360.0*std::floor(L0/360.0); // in degrees
+}
+
+
+template<typename T>
+inline T calcGeomMeanAnomalySun(const T t)
+{
+    return T(357.52911) + t*(T(35999.05029) - T(0.0001537)*t); // In degrees
+}
+
+/// @result The equation of center given the Julian century and the
+///         sun's mean anomaly (degrees).
+template<typename T>
+inline T calcSunEqOfCenterFromAnomaly(const T t, const T m)
+{
+    auto mrad = degToRad(m);
+    auto sinm = std::sin(mrad);
+    auto sin2m = std::sin(2*mrad); //mrad + mrad);
+    auto sin3m = std::sin(3*mrad); //mrad + mrad + mrad);
+    auto C = sinm*(T(1.914602) - t*(T(0.004817) + T(0.000014)*t))
+           + sin2m*(T(0.019993) - T(0.000101)*t) + sin3m*T(0.000289);
+    return C; // in degrees
+}
+
+inline double calcSunEqOfCenter(const double t)
+{
+    return calcSunEqOfCenterFromAnomaly(t, calcGeomMeanAnomalySun(t));
+}
+
+inline double calcSunTrueLong(const double t)
+{
+    auto l0 = calcGeomMeanLongSun(t);
+    auto c = calcSunEqOfCenter(t);
+    auto O = l0 + c;
+    return O; // in degrees
+}
+
+inline double calcSunApparentLong(const double t)
+{
+    auto o = calcSunTrueLong(t);
+    auto omega = 125.04 - 1934.136*t;
+    auto lambda = o - 0.00569 - 0.00478*std::sin(degToRad(omega));
+    return lambda; // in degrees
+}
+
+inline double calcSunDeclination(const double t)
+{
+   auto e = calcObliquityCorrection(t);
+   auto lambda = calcSunApparentLong(t);
+   auto sint = std::sin(degToRad(e))*std::sin(degToRad(lambda));
+   auto theta = radToDeg(std::asin(sint));
+   return theta; // in degrees
+}
+
+/// Equation of time
+inline double calcEquationOfTime(const double t)
+{
+    auto epsilon = calcObliquityCorrection(t);
+    auto l0 = calcGeomMeanLongSun(t);
+    auto e = calcEccentricityEarthOrbit(t);
+    auto m = calcGeomMeanAnomalySun(t);
+
+    auto y = std::tan(degToRad(epsilon)/2.0);
+    y *= y;
+
+    auto sin2l0 = std::sin(2.0*degToRad(l0));
+    auto sinm   = std::sin(degToRad(m));
+    auto cos2l0 = std::cos(2.0*degToRad(l0));
+    auto sin4l0 = std::sin(4.0*degToRad(l0));
+    auto sin2m  = std::sin(2.0*degToRad(m));
+
+    auto Etime = y*sin2l0 - 2.0*e*sinm + 4.0*e*y*sinm*cos2l0
+               - 0.5*y*y*sin4l0 - 1.25*e*e*sin2m;
+    return radToDeg(Etime)*4.0;	// in minutes of time
+}
+
+///--------------------------------------------------------------------------///
+///                            Sunrise/Sunset                                ///
+///--------------------------------------------------------------------------///
+
+/// @result The cosine of the hour angle at which the sun's center is at the
+///         given zenith angle (degrees).  If this exceeds 1 then the sun
+///         never rises that high and if it is less than -1 then the sun
+///         never sets that low.
+inline double calcCosHourAngle(const double lat, const double solarDec,
+                               const double zenith)
+{
+    auto latRad = degToRad(lat);
+    auto sdRad  = degToRad(solarDec);
+    return (std::cos(degToRad(zenith))/(std::cos(latRad)*std::cos(sdRad))
+          - std::tan(latRad)*std::tan(sdRad));
+}
+
+inline std::pair<double, double> 
+    calcAzEl(const double T, const double localtime,
+             const double latitude, const double longitude, const int zone,
+             const double eqTime, const double theta)
+{
+    auto solarTimeFix = eqTime + 4.0*longitude - 60.0*zone;
+    //auto earthRadVec = calcSunRadVector(T);
+    auto trueSolarTime = localtime + solarTimeFix;
+    while (trueSolarTime > 1440)
+    {
+        trueSolarTime -= 1440;
+    }
+    auto hourAngle = trueSolarTime/4.0 - 180.0;
+    if (hourAngle < -180)
+    {
+        hourAngle += 360.0;
+    }
+    auto haRad = degToRad(hourAngle);
+    auto csz = std::sin(degToRad(latitude))*std::sin(degToRad(theta))
+             + std::cos(degToRad(latitude))
+              *std::cos(degToRad(theta))*std::cos(haRad);
+    if (csz > 1.0)
+    {
+        csz = 1.0;
+    }
+    else if (csz < -1.0)
+    { 
+       csz = -1.0;
+    }
+    auto zenith = radToDeg(std::acos(csz));
+    auto azDenom = std::cos(degToRad(latitude))*std::sin(degToRad(zenith));
+    double azimuth = 0;
+    if (std::abs(azDenom) > 0.001)
+    {
+        auto azRad = ((std::sin(degToRad(latitude))
+                      *std::cos(degToRad(zenith))) - std::sin(degToRad(theta)))
+                     /azDenom;
+        if (std::abs(azRad) > 1.0)
+        {
+            if (azRad < 0)
+            {
+                azRad = -1.0;
+            }
+            else
+            {
+                azRad = 1.0;
+            }
+        }
+        azimuth = 180.0 - radToDeg(std::acos(azRad));
+        if (hourAngle > 0.0)
+        {
+            azimuth = -azimuth;
+        }
+    }
+    else
+    {
+        if (latitude > 0.0)
+        {
+            azimuth = 180.0;
+	}
+        else
+        { 
+            azimuth = 0.0;
+	}
+    }
+    if (azimuth < 0.0)
+    {
+        azimuth += 360.0;
+    }
+    auto exoatmElevation = 90.0 - zenith;
+    // Atmospheric Refraction correction
+    auto refractionCorrection = calcRefraction(exoatmElevation);
+    auto solarZen = zenith - refractionCorrection;
+    auto elevation = 90.0 - solarZen;
+    return std::pair<double, double> (azimuth, elevation);
+}
+
+///--------------------------------------------------------------------------///
+///                             Rise/Set Epochs                              ///
+///--------------------------------------------------------------------------///
+/// These solve for rise/set times on a local mean solar day.  Day k at
+/// longitude lon (degrees east) runs from local mean midnight,
+/// (k - lon/360)*86400 seconds from the epoch, to the next local mean
+/// midnight.  Working in local days guarantees the sun transits once per
+/// day, unlike UTC days.
+
+/// @result The longitude in degrees wrapped to [-180,180).
+inline double wrapLongitude(const double longitude)
+{
+    return longitude - 360.0*std::floor((longitude + 180.0)/360.0);
+}
+
+/// @result The local mean solar day containing the time.
+inline int64_t calcLocalDay(const double epoch, const double longitude)
+{
+    return static_cast<int64_t>
+           (std::floor(epoch/86400.0 + wrapLongitude(longitude)/360.0));
+}
+
+/// @result The local mean midnight starting the local day.
+inline double calcLocalMidnight(const int64_t day, const double longitude)
+{
+    return (static_cast<double> (day) - wrapLongitude(longitude)/360.0)
+          *86400.0;
+}
+
+/// The NOAA formulas as a source of the time-only terms for the rise/set
+/// solvers.  Other sources (e.g., interpolated tables) provide the same two
+/// functions of the epochal time.
+struct AnalyticEphemeris
+{
+    /// @result The equation of time in minutes.
+    [[nodiscard]] double equationOfTime(const double epoch) const
+    {
+        return calcEquationOfTime(toJulianCentury(epoch));
+    }
+    /// @result The solar declination in degrees.
+    [[nodiscard]] double declination(const double epoch) const
+    {
+        return calcSunDeclination(toJulianCentury(epoch));
+    }
+};
+
+/// @result The time of solar transit nearest the given time.
+template<typename E>
+inline double calcTransitEpoch(const double epoch, const double longitude,
+                               const E &ephemeris)
+{
+    auto day = calcLocalDay(epoch, longitude);
+    auto meanNoon = calcLocalMidnight(day, longitude) + 43200.0;
+    auto noon = meanNoon;
+    for (int i = 0; i < 2; ++i)
+    {
+        noon = meanNoon - 60.0*ephemeris.equationOfTime(noon);
+    }
+    return noon;
+}
+
+inline double calcTransitEpoch(const double epoch, const double longitude)
+{
+    return calcTransitEpoch(epoch, longitude, AnalyticEphemeris {});
+}
+
+/// @brief Solves for the times on the given local day at which the sun's
+///        center crosses the zenith angle.  The crossings are refined
+///        twice with the ephemeris re-evaluated at the current estimate.
+/// @param[in] day        The local mean solar day.
+/// @param[in] latitude   The latitude in degrees.
+/// @param[in] longitude  The longitude in degrees.
+/// @param[in] zenith     The zenith angle in degrees.  For sunrise and
+///                       sunset this is 90.833.
+/// @param[out] rise      The time the sun rises through the zenith angle.
+/// @param[out] set       The time the sun sets through the zenith angle.
+/// @param[out] noon      The time of solar transit.
+/// @param[in] ephemeris  The source of the equation of time and
+///                       declination, e.g., \c AnalyticEphemeris.
+/// @result 0 if the crossings exist, -1 if the sun never rises to the
+///         zenith angle (rise = set = noon), and +1 if the sun never sets
+///         below the zenith angle (rise and set are the day's bounds).
+template<typename E>
+inline int calcRiseSetEpochs(const int64_t day,
+                             const double latitude, const double longitude,
+                             const double zenith,
+                             double *rise, double *set, double *noon,
+                             const E &ephemeris)
+{
+    SOLARCALCULATOR_COUNT(RiseSetSolves);
+    auto midnight = calcLocalMidnight(day, longitude);
+    auto meanNoon = midnight + 43200.0;
+    *noon = calcTransitEpoch(meanNoon, longitude, ephemeris);
+    auto solarDec = ephemeris.declination(*noon);
+    auto cosHourAngle = calcCosHourAngle(latitude, solarDec, zenith);
+    if (cosHourAngle > 1.0)
+    {
+        *rise = *noon;
+        *set = *noon;
+        return -1;
+    }
+    if (cosHourAngle < -1.0)
+    {
+        *rise = midnight;
+        *set = midnight + 86400.0;
+        return 1;
+    }
+    // Hour angle in seconds of time (240 s per degree)
+    auto halfDay = 240.0*radToDeg(std::acos(cosHourAngle));
+    *rise = *noon - halfDay;
+    *set  = *noon + halfDay;
+    for (int i = 0; i < 2; ++i)
+    {
+        for (auto *t : {rise, set})
+        {
+            auto eqTime = ephemeris.equationOfTime(*t);
+            auto c = calcCosHourAngle(latitude, ephemeris.declination(*t),
+                                      zenith);
+            c = std::fmin(std::fmax(c, -1.0), 1.0);
+            auto hourAngle = 240.0*radToDeg(std::acos(c));
+            auto transit = meanNoon - 60.0*eqTime;
+            *t = (t == rise) ? transit - hourAngle : transit + hourAngle;
+        }
+    }
+    return 0;
+}
+
+inline int calcRiseSetEpochs(const int64_t day,
+                             const double latitude, const double longitude,
+                             const double zenith,
+                             double *rise, double *set, double *noon)
+{
+    return calcRiseSetEpochs(day, latitude, longitude, zenith,
+                             rise, set, noon, AnalyticEphemeris {});
+}
+
+///--------------------------------------------------------------------------///
+///                          Next/Previous Crossings                         ///
+///--------------------------------------------------------------------------///
+/// At high latitudes the sun may not rise (or set) for months.  Rather than
+/// solving day after day until it does, the search below jumps to the end
+/// of the polar night (or midnight sun).  Whether the sun rises on a day is
+/// a threshold on the declination at transit, the declination is
+/// asin(sin(obliquity)*sin(apparent longitude)), and the apparent longitude
+/// advances ~0.9856 degrees per day, so the day the threshold is crossed
+/// follows from the apparent longitude with two Newton corrections.  The
+/// cost is therefore bounded regardless of the latitude.
+
+/// @result The sun's apparent longitude in degrees.
+inline double calcSunApparentLongBranchless(const double t)
+{
+    return calcGeomMeanLongSunBranchless(t) + calcSunEqOfCenter(t)
+         - 0.00569 - 0.00478*std::sin(degToRad(125.04 - 1934.136*t));
+}
+
+/// @result The declination in degrees beyond which the polar state of the
+///         given kind (see calcRiseSetEpochs()) persists.  The state
+///         persists while sign*(declination - threshold) > 0.
+inline double calcPolarThreshold(const int kind, const double latitude,
+                                 const double zenith, double *sign)
+{
+    auto north = (latitude >= 0);
+    if (kind < 0)
+    {
+        // Never rises: |latitude - declination| > zenith
+        *sign = north ? -1.0 : 1.0;
+        return north ? latitude - zenith : latitude + zenith;
+    }
+    // Never sets: |latitude + declination| > 180 - zenith
+    *sign = north ? 1.0 : -1.0;
+    return north ? (180.0 - zenith) - latitude : zenith - 180.0 - latitude;
+}
+
+/// @result The estimated number of days (in the given direction) from the
+///         time until the declination next reaches the threshold.  This
+///         is 366 if the declination never reaches the threshold.
+inline double calcDaysToDeclination(const double epoch,
+                                    const double threshold,
+                                    const int direction)
+{
+    constexpr double rate = 36000.76983/36525.0; // degrees per day
+    auto t = toJulianCentury(epoch);
+    auto lambda = calcSunApparentLongBranchless(t);
+    auto sinLambda = std::sin(degToRad(threshold))
+                    /std::sin(degToRad(calcObliquityCorrection(t)));
+    if (std::abs(sinLambda) > 1.0){return 366.0;}
+    auto lambdaA = radToDeg(std::asin(sinLambda));
+    auto days = 366.0;
+    double target = 0;
+    for (auto root : {lambdaA, 180.0 - lambdaA})
+    {
+        auto delta = (direction > 0) ? root - lambda : lambda - root;
+        delta = delta - 360.0*std::floor(delta/360.0);
+        if (delta/rate < days)
+        {
+            days = delta/rate;
+            target = root;
+        }
+    }
+    // Refine with the apparent longitude at the estimate.  The correction
+    // is signed so an overshoot steps back rather than a year ahead.
+    for (int i = 0; i < 2; ++i)
+    {
+        auto estimate = epoch + direction*days*86400.0;
+        auto delta = target - calcSunApparentLongBranchless(
+                                  toJulianCentury(estimate));
+        delta = delta - 360.0*std::floor(delta/360.0 + 0.5);
+        days = days + direction*delta/rate;
+    }
+    return days;
+}
+
+/// @result The first local day in the direction from the given polar day
+///         whose kind differs.  The kind of that day is returned in
+///         newKind.
+template<typename E>
+inline int64_t calcPolarStateEnd(const int64_t day, const int kind,
+                                 const double latitude,
+                                 const double longitude,
+                                 const double zenith, const int direction,
+                                 const E &ephemeris, int *newKind)
+{
+    SOLARCALCULATOR_COUNT(PolarJumps);
+    double sign = 0;
+    auto threshold = calcPolarThreshold(kind, latitude, zenith, &sign);
+    auto meanNoon = calcLocalMidnight(day, longitude) + 43200.0;
+    auto days = calcDaysToDeclination(meanNoon, threshold, direction);
+    auto step = static_cast<int64_t> (std::ceil(std::fmax(days, 1.0)));
+    auto candidate = day + direction*step;
+    // Refine: candidate must differ and its predecessor must not
+    double rise = 0;
+    double set = 0;
+    double noon = 0;
+    auto candidateKind = calcRiseSetEpochs(candidate, latitude, longitude,
+                                           zenith, &rise, &set, &noon,
+                                           ephemeris);
+    for (int i = 0; i < 3 && candidateKind == kind; ++i)
+    {
+        candidate = candidate + direction;
+        candidateKind = calcRiseSetEpochs(candidate, latitude, longitude,
+                                          zenith, &rise, &set, &noon,
+                                          ephemeris);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        auto previous = candidate - direction;
+        if (previous == day){break;}
+        auto previousKind = calcRiseSetEpochs(previous, latitude, longitude,
+                                              zenith, &rise, &set, &noon,
+                                              ephemeris);
+        if (previousKind == kind){break;}
+        candidate = previous;
+        candidateKind = previousKind;
+    }
+    *newKind = candidateKind;
+    return candidate;
+}
+
+/// @brief Finds the next (or previous) time the sun's center crosses the
+///        zenith angle while rising (or setting).  The number of rise/set
+///        solves is bounded even in the polar night or midnight sun.
+/// @param[in] epoch      The UTC time in seconds from the epoch.
+/// @param[in] latitude   The latitude in degrees.
+/// @param[in] longitude  The longitude in degrees.
+/// @param[in] zenith     The zenith angle in degrees, e.g., 90.833.
+/// @param[in] rise       True for a rise and false for a set.
+/// @param[in] next       True for the first crossing after the time and
+///                       false for the last crossing before the time.
+/// @param[in] ephemeris  The source of the equation of time and
+///                       declination.
+/// @result The time of the crossing.  This is NaN if no crossing was found,
+///         e.g., the latitude never experiences one.
+template<typename E>
+inline double calcNextRiseSetEpoch(const double epoch,
+                                   const double latitude,
+                                   const double longitude,
+                                   const double zenith,
+                                   const bool rise, const bool next,
+                                   const E &ephemeris)
+{
+    SOLARCALCULATOR_COUNT(RiseSetSearches);
+    constexpr int maximumIterations = 8;
+    const int direction = next ? 1 : -1;
+    auto day = calcLocalDay(epoch, longitude);
+    double riseTime = 0;
+    double setTime = 0;
+    double noon = 0;
+    auto kind = calcRiseSetEpochs(day, latitude, longitude, zenith,
+                                  &riseTime, &setTime, &noon, ephemeris);
+    for (int iteration = 0; iteration < maximumIterations; ++iteration)
+    {
+        if (kind == 0)
+        {
+            auto time = rise ? riseTime : setTime;
+            if ((next && time > epoch) || (!next && time < epoch))
+            {
+                return time;
+            }
+            day = day + direction;
+            kind = calcRiseSetEpochs(day, latitude, longitude, zenith,
+                                     &riseTime, &setTime, &noon, ephemeris);
+            continue;
+        }
+        int newKind = 0;
+        auto newDay = calcPolarStateEnd(day, kind, latitude, longitude,
+                                        zenith, direction, ephemeris,
+                                        &newKind);
+        if (newKind == -kind)
+        {
+            // Near the poles the sun can go directly from never rising to
+            // never setting.  The crossing is when the declination passes
+            // the threshold of the earlier state.
+            auto before = next ? kind : newKind;
+            if ((rise && before < 0) || (!rise && before > 0))
+            {
+                double sign = 0;
+                auto threshold = calcPolarThreshold(before, latitude, zenith,
+                                                    &sign);
+                auto t0 = calcTransitEpoch(
+                              calcLocalMidnight(newDay - direction, longitude)
+                            + 43200.0, longitude, ephemeris);
+                auto t1 = calcTransitEpoch(
+                              calcLocalMidnight(newDay, longitude) + 43200.0,
+                              longitude, ephemeris);
+                auto d0 = ephemeris.declination(t0) - threshold;
+                auto d1 = ephemeris.declination(t1) - threshold;
+                auto time = (d1 != d0) ? t0 - d0*(t1 - t0)/(d1 - d0) : t0;
+                if ((next && time > epoch) || (!next && time < epoch))
+                {
+                    return time;
+                }
+            }
+        }
+        day = newDay;
+        kind = calcRiseSetEpochs(day, latitude, longitude, zenith,
+                                 &riseTime, &setTime, &noon, ephemeris);
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+inline double calcNextRiseSetEpoch(const double epoch,
+                                   const double latitude,
+                                   const double longitude,
+                                   const double zenith,
+                                   const bool rise, const bool next)
+{
+    return calcNextRiseSetEpoch(epoch, latitude, longitude, zenith,
+                                rise, next, AnalyticEphemeris {});
+}
+
+///--------------------------------------------------------------------------///
+///                             Branchless Kernels                           ///
+///--------------------------------------------------------------------------///
+/// These are branch-free versions of the above used by the batch solvers.
+/// Loops (while/if) are replaced by floors and selects so that a block of
+/// rows can be processed as a structure of arrays without data-dependent
+/// branches.  The trigonometric calls are not vectorized.
+
+/// @result True indicates the epochal time is in the years [-1000,2999].
+inline bool isValidEpoch(const double epoch)
+{
+    return isValidTime(epoch);
+}
+
+/// @result The Julian century corresponding to the UTC epochal time.
+inline double calcTimeJulianCentFromEpoch(const double epoch)
+{
+    return toJulianCentury(epoch);
+}
+
+/// @result The minutes into the UTC day of the epochal time.
+inline double calcMinutesOfDayFromEpoch(const double epoch)
+{
+    return (epoch - 86400.0*std::floor(epoch/86400.0))/60.0;
+}
+
+/// @result The equation of time in minutes given the Julian century and the
+///         sun's geometric mean longitude and mean anomaly in degrees.
+template<typename T>
+inline T calcEquationOfTimeFromAngles(const T t, const T l0, const T m)
+{
+    auto epsilon = calcObliquityCorrection(t);
+    auto e = calcEccentricityEarthOrbit(t);
+
+    auto y = std::tan(degToRad(epsilon)/T(2.0));
+    y *= y;
+
+    auto sin2l0 = std::sin(T(2.0)*degToRad(l0));
+    auto sinm   = std::sin(degToRad(m));
+    auto cos2l0 = std::cos(T(2.0)*degToRad(l0));
+    auto sin4l0 = std::sin(T(4.0)*degToRad(l0));
+    auto sin2m  = std::sin(T(2.0)*degToRad(m));
+
+    auto Etime = y*sin2l0 - T(2.0)*e*sinm + T(4.0)*e*y*sinm*cos2l0
+               - T(0.5)*y*y*sin4l0 - T(1.25)*e*e*sin2m;
+    return radToDeg(Etime)*T(4.0); // in minutes of time
+}
+
+/// @result The solar declination in degrees given the Julian century and
+///         the sun's geometric mean longitude and mean anomaly in degrees.
+template<typename T>
+inline T calcSunDeclinationFromAngles(const T t, const T l0, const T m)
+{
+    auto e = calcObliquityCorrection(t);
+    auto lambda = l0 + calcSunEqOfCenterFromAnomaly(t, m)
+                - T(0.00569)
+                - T(0.00478)*std::sin(degToRad(T(125.04) - T(1934.136)*t));
+    auto sint = std::sin(degToRad(e))*std::sin(degToRad(lambda));
+    return radToDeg(std::asin(sint)); // in degrees
+}
+
+inline double calcEquationOfTimeBranchless(const double t)
+{
+    return calcEquationOfTimeFromAngles(t,
+                                        calcGeomMeanLongSunBranchless(t),
+                                        calcGeomMeanAnomalySun(t));
+}
+
+inline double calcSunDeclinationBranchless(const double t)
+{
+    return calcSunDeclinationFromAngles(t,
+                                        calcGeomMeanLongSunBranchless(t),
+                                        calcGeomMeanAnomalySun(t));
+}
+
+/// Refraction where the three elevation regimes are evaluated and the
+/// applicable one is selected with masks.
+template<typename T>
+inline T calcRefractionMasked(const T elev)
+{
+    auto te = std::tan(degToRad(elev));
+    auto te3 = te*te*te;
+    auto high = T(58.1)/te - T(0.07)/te3 + T(0.000086)/(te3*te*te);
+    auto low = T(1735.0)
+             + elev*(T(-518.2) + elev*(T(103.4)
+             + elev*(T(-12.79) + elev*T(0.711))));
+    auto negative = T(-20.774)/te;
+    auto correction = (elev > T(5.0)) ?
+                      high : ((elev > T(-0.575)) ? low : negative);
+    return (elev > T(85.0)) ? T(0.0) : correction/T(3600.0);
+}
+
+/// @result The hour angle in degrees in the range [-180,180) given the
+///         minutes into the UTC day.
+template<typename T>
+inline T calcHourAngleBranchless(const T minutesOfDay,
+                                 const T longitude,
+                                 const T eqTime)
+{
+    auto hourAngle = (minutesOfDay + eqTime + T(4.0)*longitude)/T(4.0)
+                   - T(180.0);
+    return hourAngle - T(360.0)*std::floor((hourAngle + T(180.0))/T(360.0));
+}
+
+/// @brief Branch-free version of calcAzEl for a zone of 0 where the hour
+///        angle and declination are given as sines and cosines.
+/// @param[in] cosHourAngle  The cosine of the hour angle.
+/// @param[in] hourAngleSign Any quantity with the sign of the sine of the
+///                          hour angle, e.g., the hour angle in [-180,180).
+/// @param[in] sinLat        The sine of the latitude.
+/// @param[in] cosLat        The cosine of the latitude.
+/// @param[in] sinDec        The sine of the solar declination.
+/// @param[in] cosDec        The cosine of the solar declination.
+/// @param[out] azimuth      The azimuth in degrees.
+/// @param[out] elevation    The refraction corrected elevation in degrees.
+template<typename T>
+inline void calcAzElFromCosines(const T cosHourAngle,
+                                const T hourAngleSign,
+                                const T sinLat, const T cosLat,
+                                const T sinDec, const T cosDec,
+                                T *azimuth, T *elevation)
+{
+    auto csz = sinLat*sinDec + cosLat*cosDec*cosHourAngle;
+    csz = std::fmin(std::fmax(csz, T(-1.0)), T(1.0));
+    auto zenithRad = std::acos(csz);
+    auto zenith = radToDeg(zenithRad);
+    auto azDenom = cosLat*std::sin(zenithRad);
+    auto azRad = (sinLat*csz - sinDec)/azDenom;
+    azRad = std::fmin(std::fmax(azRad, T(-1.0)), T(1.0));
+    auto az = T(180.0) - radToDeg(std::acos(azRad));
+    az = (hourAngleSign > T(0.0)) ? -az : az;
+    auto polarAz = (sinLat > T(0.0)) ? T(180.0) : T(0.0);
+    az = (std::abs(azDenom) > T(0.001)) ? az : polarAz;
+    *azimuth = (az < T(0.0)) ? az + T(360.0) : az;
+    auto exoatmElevation = T(90.0) - zenith;
+    *elevation = exoatmElevation + calcRefractionMasked(exoatmElevation);
+}
+
+/// @result The refraction corrected elevation in degrees given the cosine
+///         of the solar zenith angle.  This matches the elevation of
+///         calcAzElFromCosines().
+template<typename T>
+inline T calcElevationFromCosZenith(T cosZenith)
+{
+    cosZenith = std::fmin(std::fmax(cosZenith, T(-1.0)), T(1.0));
+    auto exoatmElevation = T(90.0) - radToDeg(std::acos(cosZenith));
+    return exoatmElevation + calcRefractionMasked(exoatmElevation);
+}
+
+/// @brief Branch-free version of calcAzEl for a zone of 0.
+/// @param[in] hourAngle  The hour angle in degrees.
+/// @param[in] sinLat     The sine of the latitude.
+/// @param[in] cosLat     The cosine of the latitude.
+/// @param[in] theta      The solar declination in degrees.
+/// @param[out] azimuth   The azimuth in degrees.
+/// @param[out] elevation The refraction corrected elevation in degrees.
+template<typename T>
+inline void calcAzElBranchless(const T hourAngle,
+                               const T sinLat, const T cosLat,
+                               const T theta,
+                               T *azimuth, T *elevation)
+{
+    calcAzElFromCosines(std::cos(degToRad(hourAngle)), hourAngle,
+                        sinLat, cosLat,
+                        std::sin(degToRad(theta)), std::cos(degToRad(theta)),
+                        azimuth, elevation);
+}
+
+///--------------------------------------------------------------------------///
+///                        Split Julian Date Kernels                         ///
+///--------------------------------------------------------------------------///
+/// Single precision cannot resolve the time of day once it is added to the
+/// day number (a float32 ulp is 0.03 days at the year 3000) and the mean
+/// longitude and anomaly advance ~1 degree per day.  These kernels carry
+/// the time as whole UTC days plus the fraction of the day.  The whole-day
+/// part of the two fast angles is reduced modulo 360 in double precision;
+/// everything else is evaluated in the scalar type T.
+
+/// @brief A UTC time split into whole days and the fraction of the day.
+template<typename T>
+struct SplitDate
+{
+    /// UTC days since Jan 1 2000 (i.e., the day of J2000.0).
+    int64_t day{0};
+    /// The fraction of the UTC day in [0,1].
+    T fraction{0};
+};
+
+/// @result The epochal time split into whole days and the fraction of the
+///         day.
+template<typename T>
+inline SplitDate<T> splitEpoch(const double epoch)
+{
+    auto day = std::floor(epoch/86400.0);
+    SplitDate<T> date;
+    date.day = static_cast<int64_t> (day) - 10957;
+    date.fraction = static_cast<T> ((epoch - 86400.0*day)/86400.0);
+    return date;
+}
+
+/// @result The Julian century.  This is accurate enough for the slowly
+///         varying terms (eccentricity, obliquity, and the quadratic terms).
+template<typename T>
+inline T calcTimeJulianCentSplit(const SplitDate<T> &date)
+{
+    return ((static_cast<T> (date.day) - T(0.5)) + date.fraction)/T(36525.0);
+}
+
+/// @brief Computes the sun's geometric mean longitude in [0,360) and mean
+///        anomaly in degrees.
+template<typename T>
+inline void calcMeanAnglesSplit(const SplitDate<T> &date, const T t,
+                                T *l0, T *m)
+{
+    constexpr double longitudeRate = 36000.76983/36525.0; // deg/day
+    constexpr double anomalyRate = 35999.05029/36525.0;   // deg/day
+    auto days = static_cast<double> (date.day) - 0.5;
+    auto l0Day = 280.46646 + longitudeRate*days;
+    auto mDay = 357.52911 + anomalyRate*days;
+    l0Day = l0Day - 360.0*std::floor(l0Day/360.0);
+    mDay = mDay - 360.0*std::floor(mDay/360.0);
+    auto longitude = static_cast<T> (l0Day)
+                   + static_cast<T> (longitudeRate)*date.fraction
+                   + T(0.0003032)*t*t;
+    *l0 = longitude - T(360.0)*std::floor(longitude/T(360.0));
+    *m = static_cast<T> (mDay)
+       + static_cast<T> (anomalyRate)*date.fraction
+       - T(0.0001537)*t*t;
+}
+
+/// @result The minutes into the UTC day.
+template<typename T>
+inline T calcMinutesOfDaySplit(const SplitDate<T> &date)
+{
+    return date.fraction*T(1440.0);
+}
+
+}
+#endif
@@ -1,13 +1,14 @@
 #include <string>
+#include <stdexcept>
 #include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
 
 using namespace SolarCalculator;
 
 class Location::LocationImpl
 {
 public:
-    double mLatitude = 0;
-    double mLongitude = 0;
+    Observer mObserver;
     bool mHaveLatitude = false;
     bool mHaveLongitude = false;
 };
@@ -26,6 +27,12 @@ Location::Location(const double latitude, const double longitude) :
     setLongitude(longitude);
 }
 
+/// C'tor
+Location::Location(const Observer &observer) :
+    Location(observer.latitude, observer.longitude)
+{
+}
+
 /// Copy c'tor
 Location::Location(const Location &location)
 {
@@ -61,8 +68,7 @@ Location::~Location() = default;
 /// Clears class
 void Location::clear() noexcept
 {
-    pImpl->mLatitude = 0;
-    pImpl->mLongitude = 0;
+    pImpl->mObserver = Observer{};
     pImpl->mHaveLatitude = false;
     pImpl->mHaveLongitude = false;
 }
@@ -75,14 +81,14 @@ void Location::setLatitude(const double latitude)
         throw std::invalid_argument("Latitude = " + std::to_string(latitude)
                                   + " must be in range [-90,90]");
     }
-    pImpl->mLatitude = latitude;
+    pImpl->mObserver.latitude = latitude;
     pImpl->mHaveLatitude = true;
 }
 
 double Location::getLatitude() const
 {
     if (!haveLatitude()){throw std::invalid_argument("Latitude not set");}
-    return pImpl->mLatitude;
+    return pImpl->mObserver.latitude;
 }
 
 bool Location::haveLatitude() const noexcept
@@ -101,17 +107,25 @@ void Location::setLongitude(const double longitude)
     auto lonWork = longitude;
     while (lonWork < 0){lonWork = lonWork + 360;}
     while (lonWork > 360){lonWork = lonWork - 360;}
-    pImpl->mLongitude = lonWork;
+    pImpl->mObserver.longitude = lonWork;
     pImpl->mHaveLongitude = true;
 }
 
 double Location::getLongitude() const
 {
     if (!haveLongitude()){throw std::invalid_argument("Longitude not set");}
-    return pImpl->mLongitude;
+    return pImpl->mObserver.longitude;
 }
 
 bool Location::haveLongitude() const noexcept
 {
     return pImpl->mHaveLongitude;
 }
+
+/// Observer
+Observer Location::getObserver() const
+{
+    if (!haveLatitude()){throw std::runtime_error("Latitude not set");}
+    if (!haveLongitude()){throw std::runtime_error("Longitude not set");}
+    return pImpl->mObserver;
+}
@@ -0,0 +1,270 @@
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include "solarCalculator/parallelEngine.hpp"
+#include "solarCalculator/batch.hpp"
+
+using namespace SolarCalculator;
+
+namespace
+{
+
+/// Each thread's queue of chunks is the range [next, end).  The owner takes
+/// chunks from the front and thieves take from the back.  This is aligned
+/// to a cache line so the threads do not falsely share their queues.
+struct alignas(64) ChunkQueue
+{
+    std::mutex mutex;
+    size_t next = 0;
+    size_t end = 0;
+};
+
+/// The engine whose chunk function is running on this thread.  Calling back
+/// into it would wait on its call mutex forever.
+thread_local const void *tRunningEngine = nullptr;
+
+}
+
+class ParallelEngine::ParallelEngineImpl
+{
+public:
+    explicit ParallelEngineImpl(const int nThreads) :
+        mQueues(static_cast<size_t> (nThreads))
+    {
+        for (int i = 1; i < nThreads; ++i)
+        {
+            mThreads.emplace_back(&ParallelEngineImpl::workerLoop, this, i);
+        }
+    }
+    ~ParallelEngineImpl()
+    {
+        mStop = true;
+        mGeneration.fetch_add(1);
+        mGeneration.notify_all();
+        for (auto &thread : mThreads){thread.join();}
+    }
+    /// Background thread
+    void workerLoop(const int index)
+    {
+        uint64_t generation = 0;
+        while (true)
+        {
+            mGeneration.wait(generation);
+            if (mStop){return;}
+            generation = mGeneration.load();
+            run(index);
+            mThreadsToFinish.fetch_sub(1);
+            mThreadsToFinish.notify_one();
+        }
+    }
+    /// Takes a chunk from the front of this thread's queue
+    bool popLocal(const int index, size_t *chunk)
+    {
+        auto &queue = mQueues[static_cast<size_t> (index)];
+        std::scoped_lock lock(queue.mutex);
+        if (queue.next < queue.end)
+        {
+            *chunk = queue.next;
+            queue.next = queue.next + 1;
+            return true;
+        }
+        return false;
+    }
+    /// Steals the back half of another thread's queue
+    bool steal(const int index, size_t *chunk)
+    {
+        auto nThreads = static_cast<int> (mQueues.size());
+        for (int offset = 1; offset < nThreads; ++offset)
+        {
+            auto &victim
+                = mQueues[static_cast<size_t> ((index + offset)%nThreads)];
+            size_t begin = 0;
+            size_t end = 0;
+            {
+            std::scoped_lock lock(victim.mutex);
+            if (victim.next >= victim.end){continue;}
+            auto nRemaining = victim.end - victim.next;
+            begin = victim.end - (nRemaining + 1)/2;
+            end = victim.end;
+            victim.end = begin;
+            }
+            *chunk = begin;
+            auto &queue = mQueues[static_cast<size_t> (index)];
+            std::scoped_lock lock(queue.mutex);
+            queue.next = begin + 1;
+            queue.end = end;
+            return true;
+        }
+        return false;
+    }
+    /// Processes chunks until there is no work left to take or a chunk
+    /// has thrown
+    void run(const int index)
+    {
+        auto *previousEngine = tRunningEngine;
+        tRunningEngine = this;
+        auto grainSize = mGrainSize.load(std::memory_order_relaxed);
+        size_t chunk = 0;
+        while (!mFailed.load(std::memory_order_relaxed) &&
+               (popLocal(index, &chunk) || steal(index, &chunk)))
+        {
+            auto begin = chunk*grainSize;
+            auto end = std::min(mRows, begin + grainSize);
+            try
+            {
+                (*mFunction)(begin, end, index);
+            }
+            catch (...)
+            {
+                std::scoped_lock lock(mExceptionMutex);
+                if (!mException){mException = std::current_exception();}
+                mFailed.store(true, std::memory_order_relaxed);
+            }
+        }
+        tRunningEngine = previousEngine;
+    }
+    /// @throws std::runtime_error if called from a chunk function.
+    void checkNotRunning() const
+    {
+        if (tRunningEngine == this)
+        {
+            throw std::runtime_error(
+                "The engine cannot be used from within its chunk function");
+        }
+    }
+    std::vector<ChunkQueue> mQueues;
+    std::vector<std::thread> mThreads;
+    std::mutex mCallMutex;
+    std::mutex mExceptionMutex;
+    std::exception_ptr mException{nullptr};
+    const ChunkFunction *mFunction{nullptr};
+    /// Incremented to start a job (or to stop)
+    std::atomic<uint64_t> mGeneration{0};
+    /// Number of background threads still working on the job
+    std::atomic<int> mThreadsToFinish{0};
+    std::atomic<bool> mStop{false};
+    /// A chunk threw so no more chunks are started
+    std::atomic<bool> mFailed{false};
+    size_t mRows = 0;
+    /// Only changed while holding mCallMutex
+    std::atomic<size_t> mGrainSize{1024};
+};
+
+/// C'tor
+ParallelEngine::ParallelEngine() :
+    ParallelEngine(static_cast<int> (
+        std::max(1U, std::thread::hardware_concurrency())))
+{
+}
+
+/// C'tor
+ParallelEngine::ParallelEngine(const int nThreads)
+{
+    if (nThreads < 1)
+    {
+        throw std::invalid_argument("Number of threads = "
+                                  + std::to_string(nThreads)
+                                  + " must be positive");
+    }
+    pImpl = std::make_unique<ParallelEngineImpl> (nThreads);
+}
+
+/// Destructor
+ParallelEngine::~ParallelEngine() = default;
+
+/// Number of threads
+int ParallelEngine::getNumberOfThreads() const noexcept
+{
+    return static_cast<int> (pImpl->mQueues.size());
+}
+
+/// Grain size
+void ParallelEngine::setGrainSize(const size_t grainSize)
+{
+    if (grainSize == 0){throw std::invalid_argument("Grain size is 0");}
+    pImpl->checkNotRunning();
+    std::scoped_lock lock(pImpl->mCallMutex);
+    pImpl->mGrainSize.store(grainSize, std::memory_order_relaxed);
+}
+
+size_t ParallelEngine::getGrainSize() const noexcept
+{
+    return pImpl->mGrainSize.load(std::memory_order_relaxed);
+}
+
+/// Parallel for
+void ParallelEngine::parallelFor(const size_t nRows,
+                                 const ChunkFunction &function)
+{
+    if (nRows == 0){return;}
+    pImpl->checkNotRunning();
+    std::scoped_lock callLock(pImpl->mCallMutex);
+    auto nThreads = pImpl->mQueues.size();
+    auto grainSize = pImpl->mGrainSize.load(std::memory_order_relaxed);
+    auto nChunks = (nRows + grainSize - 1)/grainSize;
+    // Deal each thread a contiguous share of the chunks
+    for (size_t i = 0; i < nThreads; ++i)
+    {
+        std::scoped_lock lock(pImpl->mQueues[i].mutex);
+        pImpl->mQueues[i].next = (i*nChunks)/nThreads;
+        pImpl->mQueues[i].end = ((i + 1)*nChunks)/nThreads;
+    }
+    pImpl->mException = nullptr;
+    pImpl->mFailed = false;
+    pImpl->mFunction = &function;
+    pImpl->mRows = nRows;
+    pImpl->mThreadsToFinish = static_cast<int> (nThreads) - 1;
+    pImpl->mGeneration.fetch_add(1);
+    pImpl->mGeneration.notify_all();
+    // The calling thread is thread 0
+    pImpl->run(0);
+    for (auto n = pImpl->mThreadsToFinish.load(); n != 0;
+         n = pImpl->mThreadsToFinish.load())
+    {
+        pImpl->mThreadsToFinish.wait(n);
+    }
+    pImpl->mFunction = nullptr;
+    if (pImpl->mException){std::rethrow_exception(pImpl->mException);}
+}
+
+/// Solar positions
+void ParallelEngine::computeSolarPositions(const size_t nRows,
+                                           const double times[],
+                                           const double latitudes[],
+                                           const double longitudes[],
+                                           double elevations[],
+                                           double azimuths[],
+                                           double declinations[],
+                                           double equationsOfTime[])
+{
+    if (nRows == 0){return;}
+    if (times == nullptr){throw std::invalid_argument("times is NULL");}
+    if (latitudes == nullptr)
+    {
+        throw std::invalid_argument("latitudes is NULL");
+    }
+    if (longitudes == nullptr)
+    {
+        throw std::invalid_argument("longitudes is NULL");
+    }
+    auto offset = [](double *pointer, const size_t i)
+    {
+        return pointer ? pointer + i : nullptr;
+    };
+    parallelFor(nRows,
+                [&](const size_t begin, const size_t end, int)
+                {
+                    SolarCalculator::computeSolarPositions(
+                        end - begin,
+                        times + begin, latitudes + begin, longitudes + begin,
+                        offset(elevations, begin),
+                        offset(azimuths, begin),
+                        offset(declinations, begin),
+                        offset(equationsOfTime, begin));
+                });
+}
@@ -0,0 +1,312 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "solarCalculator/queryClient.hpp"
+#include "solarCalculator/queryProtocol.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::QueryProtocol;
+
+namespace
+{
+
+/// Error messages longer than this indicate a corrupt response.
+constexpr uint64_t MAXIMUM_MESSAGE_LENGTH = 65536;
+
+void checkInputs(const size_t nRows,
+                 const double times[],
+                 const double latitudes[],
+                 const double longitudes[])
+{
+    if (nRows == 0){return;}
+    if (times == nullptr){throw std::invalid_argument("times is NULL");}
+    if (latitudes == nullptr)
+    {
+        throw std::invalid_argument("latitudes is NULL");
+    }
+    if (longitudes == nullptr)
+    {
+        throw std::invalid_argument("longitudes is NULL");
+    }
+}
+
+}
+
+class QueryClient::QueryClientImpl
+{
+public:
+    ~QueryClientImpl()
+    {
+        disconnect();
+    }
+    void connect(const std::string &socketPath)
+    {
+        if (socketPath.empty())
+        {
+            throw std::invalid_argument("Socket path is empty");
+        }
+        if (socketPath.size() > MAXIMUM_SOCKET_PATH_LENGTH)
+        {
+            throw std::invalid_argument("Socket path " + socketPath
+                                      + " exceeds "
+                                      + std::to_string(MAXIMUM_SOCKET_PATH_LENGTH)
+                                      + " characters");
+        }
+        disconnect();
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, socketPath.c_str(),
+                    socketPath.size() + 1);
+        mSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (mSocket < 0)
+        {
+            throw std::runtime_error("Failed to create socket: "
+                                   + std::string {std::strerror(errno)});
+        }
+        if (::connect(mSocket, reinterpret_cast<const sockaddr *> (&address),
+                      sizeof(address)) != 0)
+        {
+            auto error = errno;
+            disconnect();
+            throw std::runtime_error("Failed to connect to " + socketPath
+                                   + ": " + std::strerror(error));
+        }
+    }
+    void disconnect() noexcept
+    {
+        if (mSocket >= 0){::close(mSocket);}
+        mSocket =-1;
+    }
+    [[noreturn]] void fail(const std::string &message)
+    {
+        disconnect();
+        throw std::runtime_error(message);
+    }
+    void sendAll(const char *data, size_t nBytes)
+    {
+        while (nBytes > 0)
+        {
+            auto n = ::send(mSocket, data, nBytes, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR){continue;}
+            if (n <= 0)
+            {
+                fail("Failed to send request: "
+                   + std::string {std::strerror(errno)});
+            }
+            data = data + n;
+            nBytes = nBytes - static_cast<size_t> (n);
+        }
+    }
+    void receiveAll(char *data, size_t nBytes)
+    {
+        while (nBytes > 0)
+        {
+            auto n = ::recv(mSocket, data, nBytes, 0);
+            if (n < 0 && errno == EINTR){continue;}
+            if (n == 0){fail("Server closed the connection");}
+            if (n < 0)
+            {
+                fail("Failed to receive response: "
+                   + std::string {std::strerror(errno)});
+            }
+            data = data + n;
+            nBytes = nBytes - static_cast<size_t> (n);
+        }
+    }
+    /// Sends a request and receives its results into mResults.
+    void query(const RequestType type, const double parameter,
+               const size_t nRows,
+               const double times[],
+               const double latitudes[],
+               const double longitudes[],
+               const size_t resultSize)
+    {
+        if (mSocket < 0){throw std::runtime_error("Client is not connected");}
+        RequestHeader header;
+        header.type = static_cast<uint32_t> (type);
+        mId = mId + 1;
+        header.id = mId;
+        header.nRows = nRows;
+        header.parameter = parameter;
+        mBuffer.resize(sizeof(RequestHeader) + nRows*sizeof(Row));
+        std::memcpy(mBuffer.data(), &header, sizeof(RequestHeader));
+        auto *rows = reinterpret_cast<Row *> (mBuffer.data()
+                                            + sizeof(RequestHeader));
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            rows[i] = Row{times[i], latitudes[i], longitudes[i]};
+        }
+        sendAll(mBuffer.data(), mBuffer.size());
+        ResponseHeader response;
+        receiveAll(reinterpret_cast<char *> (&response), sizeof(response));
+        if (response.magic != MAGIC || response.id != header.id)
+        {
+            fail("Invalid response from server");
+        }
+        auto status = static_cast<Status> (response.status);
+        if (status != Status::Success)
+        {
+            if (response.messageLength > MAXIMUM_MESSAGE_LENGTH)
+            {
+                fail("Invalid response from server");
+            }
+            std::string message(response.messageLength, '\0');
+            receiveAll(message.data(), message.size());
+            if (status == Status::InvalidArgument)
+            {
+                throw std::invalid_argument(message);
+            }
+            throw std::runtime_error("Server error: " + message);
+        }
+        if (response.nRows != nRows){fail("Invalid response from server");}
+        mResults.resize(nRows*resultSize);
+        receiveAll(mResults.data(), mResults.size());
+    }
+    std::vector<char> mBuffer;
+    std::vector<char> mResults;
+    uint64_t mId = 0;
+    int mSocket =-1;
+};
+
+/// C'tor
+QueryClient::QueryClient() :
+    pImpl(std::make_unique<QueryClientImpl> ())
+{
+}
+
+/// Move c'tor
+QueryClient::QueryClient(QueryClient &&client) noexcept
+{
+    *this = std::move(client);
+}
+
+/// Move assignment
+QueryClient& QueryClient::operator=(QueryClient &&client) noexcept
+{
+    if (&client == this){return *this;}
+    pImpl = std::move(client.pImpl);
+    return *this;
+}
+
+/// Destructor
+QueryClient::~QueryClient() = default;
+
+/// Connect
+void QueryClient::connect(const std::string &socketPath)
+{
+    pImpl->connect(socketPath);
+}
+
+bool QueryClient::isConnected() const noexcept
+{
+    return pImpl->mSocket >= 0;
+}
+
+void QueryClient::disconnect() noexcept
+{
+    pImpl->disconnect();
+}
+
+/// Positions
+void QueryClient::computePositions(const size_t nRows,
+                                   const double times[],
+                                   const double latitudes[],
+                                   const double longitudes[],
+                                   double elevations[],
+                                   double azimuths[])
+{
+    checkInputs(nRows, times, latitudes, longitudes);
+    if (nRows > 0 && elevations == nullptr)
+    {
+        throw std::invalid_argument("elevations is NULL");
+    }
+    for (size_t first = 0; first < nRows; first = first + MAXIMUM_ROWS)
+    {
+        auto n = std::min(nRows - first, static_cast<size_t> (MAXIMUM_ROWS));
+        pImpl->query(RequestType::Position, 0, n, times + first,
+                     latitudes + first, longitudes + first,
+                     sizeof(PositionResult));
+        const auto *results = reinterpret_cast<const PositionResult *>
+                              (pImpl->mResults.data());
+        for (size_t i = 0; i < n; ++i)
+        {
+            elevations[first + i] = results[i].elevation;
+        }
+        if (azimuths == nullptr){continue;}
+        for (size_t i = 0; i < n; ++i)
+        {
+            azimuths[first + i] = results[i].azimuth;
+        }
+    }
+}
+
+/// Day/night
+void QueryClient::classifyDayNight(const size_t nRows,
+                                   const double times[],
+                                   const double latitudes[],
+                                   const double longitudes[],
+                                   bool isNight[],
+                                   const double depressionAngle)
+{
+    checkInputs(nRows, times, latitudes, longitudes);
+    if (nRows > 0 && isNight == nullptr)
+    {
+        throw std::invalid_argument("isNight is NULL");
+    }
+    for (size_t first = 0; first < nRows; first = first + MAXIMUM_ROWS)
+    {
+        auto n = std::min(nRows - first, static_cast<size_t> (MAXIMUM_ROWS));
+        pImpl->query(RequestType::DayNight, depressionAngle, n,
+                     times + first, latitudes + first, longitudes + first,
+                     sizeof(uint8_t));
+        for (size_t i = 0; i < n; ++i)
+        {
+            isNight[first + i] = (pImpl->mResults[i] != 0);
+        }
+    }
+}
+
+/// Rise/set
+void QueryClient::computeRiseSet(const size_t nRows,
+                                 const double times[],
+                                 const double latitudes[],
+                                 const double longitudes[],
+                                 double sunrises[],
+                                 double sunsets[],
+                                 double solarNoons[],
+                                 const double depressionAngle)
+{
+    checkInputs(nRows, times, latitudes, longitudes);
+    if (nRows > 0 && sunrises == nullptr)
+    {
+        throw std::invalid_argument("sunrises is NULL");
+    }
+    if (nRows > 0 && sunsets == nullptr)
+    {
+        throw std::invalid_argument("sunsets is NULL");
+    }
+    for (size_t first = 0; first < nRows; first = first + MAXIMUM_ROWS)
+    {
+        auto n = std::min(nRows - first, static_cast<size_t> (MAXIMUM_ROWS));
+        pImpl->query(RequestType::RiseSet, depressionAngle, n,
+                     times + first, latitudes + first, longitudes + first,
+                     sizeof(RiseSetResult));
+        const auto *results = reinterpret_cast<const RiseSetResult *>
+                              (pImpl->mResults.data());
+        for (size_t i = 0; i < n; ++i)
+        {
+            sunrises[first + i] = results[i].sunrise;
+            sunsets[first + i] = results[i].sunset;
+            if (solarNoons != nullptr)
+            {
+                solarNoons[first + i] = results[i].solarNoon;
+            }
+        }
+    }
+}
@@ -0,0 +1,869 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "solarCalculator/queryServer.hpp"
+#include "solarCalculator/queryProtocol.hpp"
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/dayNight.hpp"
+#include "solarCalculator/ephemerisTable.hpp"
+#include "solarCalculator/parallelEngine.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::QueryProtocol;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+/// Batches with at least this many rows of a type are split across threads.
+constexpr size_t PARALLEL_THRESHOLD = 16384;
+/// The number of bytes requested from a connection per read.
+constexpr size_t READ_SIZE = 65536;
+/// The most bytes read from one connection per wakeup.  This keeps a client
+/// streaming a bulk request from starving the others.
+constexpr size_t MAXIMUM_READ_PER_WAKEUP = 16*1024*1024;
+/// Above this many bytes of partial requests across all connections only
+/// the connection furthest into its request is read; the others wait.  This
+/// exceeds the largest request so that connection can always finish it.
+constexpr size_t MAXIMUM_BUFFERED_BYTES = 256*1024*1024;
+static_assert(MAXIMUM_BUFFERED_BYTES > sizeof(RequestHeader)
+                                     + MAXIMUM_ROWS*sizeof(Row),
+              "The buffer cap must hold the largest request");
+/// The most rows of one request answered per batch.  A bulk request is
+/// answered a slice at a time so the requests that arrive meanwhile, even
+/// on other connections, are not stuck behind it.
+constexpr size_t SLICE_ROWS = 16384;
+/// The number of rise/set results retained.  This is a power of 2.
+constexpr size_t RISE_SET_CACHE_SIZE = 65536;
+
+struct Connection
+{
+    std::vector<char> input;
+    std::vector<char> output;
+    size_t outputOffset = 0;
+    int fd = -1;
+    /// A malformed header was received or the peer shut down its end.  No
+    /// more requests are read and the connection is closed once the
+    /// responses are sent.
+    bool closing = false;
+    /// The peer hung up or the socket failed.
+    bool failed = false;
+    /// The number of this connection's requests not yet answered.
+    size_t nPending = 0;
+    /// An earlier request is unfinished so this batch's responses wait.
+    bool blocked = false;
+};
+
+struct Request
+{
+    Connection *connection = nullptr;
+    RequestHeader header;
+    std::vector<Row> rows;
+    std::vector<char> results;
+    std::string message;
+    /// The rows answered so far.
+    size_t nAnswered = 0;
+    Status status = Status::Success;
+    /// @result The end of the next slice of rows to answer.
+    [[nodiscard]] size_t sliceEnd() const noexcept
+    {
+        return std::min(rows.size(), nAnswered + SLICE_ROWS);
+    }
+    /// @result True indicates the response can be sent.
+    [[nodiscard]] bool isFinished() const noexcept
+    {
+        return status != Status::Success || nAnswered == rows.size();
+    }
+};
+
+struct RiseSetSlot
+{
+    RiseSetResult result;
+    double latitude = 0;
+    double longitude = 0;
+    double zenith = 0;
+    int64_t day = 0;
+    bool valid = false;
+};
+
+uint64_t toBits(const double x)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(double));
+    return bits;
+}
+
+void setNonBlocking(const int fd)
+{
+    auto flags = ::fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        throw std::runtime_error("Failed to make descriptor nonblocking: "
+                               + std::string {std::strerror(errno)});
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+sockaddr_un makeAddress(const std::string &socketPath)
+{
+    if (socketPath.empty())
+    {
+        throw std::invalid_argument("Socket path is empty");
+    }
+    if (socketPath.size() > MAXIMUM_SOCKET_PATH_LENGTH)
+    {
+        throw std::invalid_argument("Socket path " + socketPath
+                                  + " exceeds "
+                                  + std::to_string(MAXIMUM_SOCKET_PATH_LENGTH)
+                                  + " characters");
+    }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    return address;
+}
+
+/// @result An empty string if the request is valid; otherwise, the reason
+///         it is not.
+std::string validate(const RequestHeader &header, const std::vector<Row> &rows)
+{
+    auto type = static_cast<RequestType> (header.type);
+    if (type != RequestType::Position && type != RequestType::DayNight &&
+        type != RequestType::RiseSet)
+    {
+        return "Request type " + std::to_string(header.type)
+             + " is not supported";
+    }
+    if (type != RequestType::Position &&
+        !(header.parameter >= -90 && header.parameter <= 90))
+    {
+        return "Depression angle = " + std::to_string(header.parameter)
+             + " must be in range [-90,90]";
+    }
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        if (!isValidTime(rows[i].time))
+        {
+            return "Row " + std::to_string(i) + ": time "
+                 + std::to_string(rows[i].time)
+                 + " must be in years [-1000,2999]";
+        }
+        if (!(rows[i].latitude >= -90 && rows[i].latitude <= 90))
+        {
+            return "Row " + std::to_string(i) + ": latitude = "
+                 + std::to_string(rows[i].latitude)
+                 + " must be in range [-90,90]";
+        }
+        if (!(rows[i].longitude >= -540 && rows[i].longitude < 540))
+        {
+            return "Row " + std::to_string(i) + ": longitude = "
+                 + std::to_string(rows[i].longitude)
+                 + " must be in range [-540,540)";
+        }
+    }
+    return std::string {};
+}
+
+void appendBytes(std::vector<char> *buffer, const void *data,
+                 const size_t nBytes)
+{
+    const auto *bytes = static_cast<const char *> (data);
+    buffer->insert(buffer->end(), bytes, bytes + nBytes);
+}
+
+}
+
+class QueryServer::QueryServerImpl
+{
+public:
+    QueryServerImpl() :
+        mRiseSetCache(RISE_SET_CACHE_SIZE),
+        mReadBuffer(READ_SIZE)
+    {
+    }
+    ~QueryServerImpl()
+    {
+        stop();
+    }
+    void start(const std::string &socketPath,
+               const int firstYear, const int lastYear)
+    {
+        if (mRunning){throw std::runtime_error("Server is already running");}
+        auto address = makeAddress(socketPath);
+        mTable.initialize(firstYear, lastYear);
+        if (!mEngine){mEngine = std::make_unique<ParallelEngine> ();}
+        mClassifier.clear();
+        for (auto &slot : mRiseSetCache){slot.valid = false;}
+        mRequests = 0;
+        mBatches = 0;
+        mSocketPath = socketPath;
+        try
+        {
+            openListener(address, socketPath);
+            int pipeDescriptors[2];
+            if (::pipe(pipeDescriptors) != 0)
+            {
+                throw std::runtime_error("Failed to create wake pipe: "
+                                       + std::string {std::strerror(errno)});
+            }
+            mWakeRead = pipeDescriptors[0];
+            mWakeWrite = pipeDescriptors[1];
+            setNonBlocking(mWakeRead);
+            setNonBlocking(mWakeWrite);
+            mThread = std::thread(&QueryServerImpl::run, this);
+        }
+        catch (...)
+        {
+            closeDescriptors();
+            throw;
+        }
+        mRunning = true;
+    }
+    void stop() noexcept
+    {
+        if (!mRunning){return;}
+        char byte = 0;
+        while (::write(mWakeWrite, &byte, 1) < 0 && errno == EINTR){}
+        if (mThread.joinable()){mThread.join();}
+        for (auto &connection : mConnections){::close(connection->fd);}
+        mConnections.clear();
+        mPending.clear();
+        closeDescriptors();
+        mRunning = false;
+    }
+    /// Binds the listener.  A path that is already a live socket is in use
+    /// by another server and is left alone; anything else there is stale.
+    void openListener(const sockaddr_un &address, const std::string &socketPath)
+    {
+        auto probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0)
+        {
+            auto inUse
+                = (::connect(probe, reinterpret_cast<const sockaddr *> (&address),
+                             sizeof(address)) == 0);
+            ::close(probe);
+            if (inUse)
+            {
+                throw std::runtime_error("Socket " + socketPath
+                                       + " is in use by another server");
+            }
+        }
+        ::unlink(socketPath.c_str());
+        mListener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (mListener < 0)
+        {
+            throw std::runtime_error("Failed to create socket: "
+                                   + std::string {std::strerror(errno)});
+        }
+        if (::bind(mListener, reinterpret_cast<const sockaddr *> (&address),
+                   sizeof(address)) != 0)
+        {
+            throw std::runtime_error("Failed to bind " + socketPath + ": "
+                                   + std::string {std::strerror(errno)});
+        }
+        mBound = true;
+        if (::listen(mListener, SOMAXCONN) != 0)
+        {
+            throw std::runtime_error("Failed to listen on " + socketPath + ": "
+                                   + std::string {std::strerror(errno)});
+        }
+        setNonBlocking(mListener);
+    }
+    void closeDescriptors() noexcept
+    {
+        for (auto *fd : {&mListener, &mWakeRead, &mWakeWrite})
+        {
+            if (*fd >= 0){::close(*fd);}
+            *fd = -1;
+        }
+        if (mBound){::unlink(mSocketPath.c_str());}
+        mBound = false;
+    }
+    /// I/O thread
+    void run()
+    {
+        std::vector<pollfd> descriptors;
+        while (true)
+        {
+            descriptors.clear();
+            descriptors.push_back(pollfd{mWakeRead, POLLIN, 0});
+            descriptors.push_back(pollfd{mListener, POLLIN, 0});
+            // Apply backpressure when partial requests hold too much memory
+            size_t nBuffered = 0;
+            const Connection *largest = nullptr;
+            for (const auto &connection : mConnections)
+            {
+                nBuffered = nBuffered + connection->input.size();
+                if (!largest ||
+                    connection->input.size() > largest->input.size())
+                {
+                    largest = connection.get();
+                }
+            }
+            bool throttle = (nBuffered >= MAXIMUM_BUFFERED_BYTES);
+            for (const auto &connection : mConnections)
+            {
+                bool read = !connection->closing &&
+                            (!throttle || connection.get() == largest);
+                short events = read ? POLLIN : 0;
+                if (connection->outputOffset < connection->output.size())
+                {
+                    events = static_cast<short> (events | POLLOUT);
+                }
+                descriptors.push_back(pollfd{connection->fd, events, 0});
+            }
+            // Unfinished requests are answered after a look at the sockets
+            int timeOut = mPending.empty() ? -1 : 0;
+            if (::poll(descriptors.data(), descriptors.size(), timeOut) < 0)
+            {
+                if (errno == EINTR){continue;}
+                return;
+            }
+            if (descriptors[0].revents != 0){return;}
+            for (size_t i = 0; i < mConnections.size(); ++i)
+            {
+                auto revents = descriptors[i + 2].revents;
+                auto *connection = mConnections[i].get();
+                if (revents & (POLLIN | POLLHUP | POLLERR))
+                {
+                    receive(connection);
+                }
+                if (revents & POLLOUT){flush(connection);}
+            }
+            if (!mPending.empty()){answer();}
+            dropFailedRequests();
+            // Retire closed connections
+            size_t nKeep = 0;
+            for (auto &connection : mConnections)
+            {
+                bool done = connection->failed ||
+                            (connection->closing &&
+                             connection->nPending == 0 &&
+                             connection->outputOffset ==
+                             connection->output.size());
+                if (done)
+                {
+                    ::close(connection->fd);
+                    continue;
+                }
+                mConnections[nKeep] = std::move(connection);
+                nKeep = nKeep + 1;
+            }
+            mConnections.resize(nKeep);
+            if (descriptors[1].revents & POLLIN){accept();}
+        }
+    }
+    void accept()
+    {
+        while (true)
+        {
+            auto fd = ::accept(mListener, nullptr, nullptr);
+            if (fd < 0)
+            {
+                if (errno == EINTR){continue;}
+                return;
+            }
+            try
+            {
+                setNonBlocking(fd);
+            }
+            catch (const std::exception &)
+            {
+                ::close(fd);
+                continue;
+            }
+            auto connection = std::make_unique<Connection> ();
+            connection->fd = fd;
+            mConnections.push_back(std::move(connection));
+        }
+    }
+    /// Reads what is available and queues every complete request.
+    void receive(Connection *connection)
+    {
+        if (connection->closing){return;}
+        auto &input = connection->input;
+        size_t nRead = 0;
+        bool hungUp = false;
+        while (nRead < MAXIMUM_READ_PER_WAKEUP)
+        {
+            auto n = ::recv(connection->fd, mReadBuffer.data(),
+                            mReadBuffer.size(), 0);
+            if (n > 0)
+            {
+                input.insert(input.end(), mReadBuffer.data(),
+                             mReadBuffer.data() + n);
+                nRead = nRead + static_cast<size_t> (n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR){continue;}
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){break;}
+            if (n < 0)
+            {
+                connection->failed = true;
+                return;
+            }
+            // The peer hung up, perhaps only its write side, so answer the
+            // requests that arrived before closing
+            hungUp = true;
+            break;
+        }
+        size_t offset = 0;
+        while (input.size() - offset >= sizeof(RequestHeader))
+        {
+            Request request;
+            std::memcpy(&request.header, input.data() + offset,
+                        sizeof(RequestHeader));
+            if (request.header.magic != MAGIC ||
+                request.header.nRows > MAXIMUM_ROWS)
+            {
+                // The stream cannot be resynchronized
+                request.connection = connection;
+                request.status = Status::InvalidArgument;
+                request.message = request.header.magic != MAGIC ?
+                                  "Invalid magic number" :
+                                  "Number of rows exceeds "
+                                + std::to_string(MAXIMUM_ROWS);
+                mPending.push_back(std::move(request));
+                connection->nPending = connection->nPending + 1;
+                connection->closing = true;
+                input.clear();
+                return;
+            }
+            auto nRows = static_cast<size_t> (request.header.nRows);
+            auto frameSize = sizeof(RequestHeader) + nRows*sizeof(Row);
+            // The buffer grows as the rows arrive rather than from the
+            // header's claim
+            if (input.size() - offset < frameSize){break;}
+            request.connection = connection;
+            request.rows.resize(nRows);
+            if (nRows > 0)
+            {
+                std::memcpy(request.rows.data(),
+                            input.data() + offset + sizeof(RequestHeader),
+                            nRows*sizeof(Row));
+            }
+            request.message = validate(request.header, request.rows);
+            if (!request.message.empty())
+            {
+                request.status = Status::InvalidArgument;
+            }
+            mPending.push_back(std::move(request));
+            connection->nPending = connection->nPending + 1;
+            offset = offset + frameSize;
+        }
+        input.erase(input.begin(),
+                    input.begin() + static_cast<std::ptrdiff_t> (offset));
+        if (hungUp)
+        {
+            connection->closing = true;
+            input.clear();
+        }
+    }
+    /// Sends what the socket will take.
+    void flush(Connection *connection)
+    {
+        auto &output = connection->output;
+        while (connection->outputOffset < output.size())
+        {
+            auto n = ::send(connection->fd,
+                            output.data() + connection->outputOffset,
+                            output.size() - connection->outputOffset,
+                            MSG_NOSIGNAL);
+            if (n > 0)
+            {
+                connection->outputOffset = connection->outputOffset
+                                         + static_cast<size_t> (n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR){continue;}
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){return;}
+            connection->failed = true;
+            return;
+        }
+        output.clear();
+        connection->outputOffset = 0;
+    }
+    /// Answers the next slice of every pending request as one batch and
+    /// responds to the finished ones.
+    void answer()
+    {
+        try
+        {
+            answerPositions();
+        }
+        catch (const std::exception &e)
+        {
+            fail(RequestType::Position, e.what());
+        }
+        for (auto &request : mPending)
+        {
+            if (request.isFinished()){continue;}
+            try
+            {
+                auto type = static_cast<RequestType> (request.header.type);
+                if (type == RequestType::DayNight)
+                {
+                    answerDayNight(&request);
+                }
+                else if (type == RequestType::RiseSet)
+                {
+                    answerRiseSet(&request);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                request.status = Status::InternalError;
+                request.message = e.what();
+            }
+        }
+        for (auto &request : mPending)
+        {
+            if (!request.isFinished()){request.nAnswered = request.sliceEnd();}
+            request.connection->blocked = false;
+        }
+        mBatches.fetch_add(1, std::memory_order_relaxed);
+        // Responses go out in the order the requests arrived on each
+        // connection
+        size_t nKeep = 0;
+        for (size_t i = 0; i < mPending.size(); ++i)
+        {
+            auto &request = mPending[i];
+            auto *connection = request.connection;
+            if (!request.isFinished() || connection->blocked)
+            {
+                connection->blocked = true;
+                if (i != nKeep){mPending[nKeep] = std::move(request);}
+                nKeep = nKeep + 1;
+                continue;
+            }
+            respond(request);
+        }
+        mPending.resize(nKeep);
+    }
+    /// Sends the response to a finished request.
+    void respond(const Request &request)
+    {
+        auto *connection = request.connection;
+        connection->nPending = connection->nPending - 1;
+        if (connection->failed){return;}
+        mRequests.fetch_add(1, std::memory_order_relaxed);
+        ResponseHeader header;
+        header.status = static_cast<uint32_t> (request.status);
+        header.id = request.header.id;
+        if (request.status == Status::Success)
+        {
+            header.nRows = request.header.nRows;
+            appendBytes(&connection->output, &header, sizeof(header));
+            appendBytes(&connection->output, request.results.data(),
+                        request.results.size());
+        }
+        else
+        {
+            header.messageLength = request.message.size();
+            appendBytes(&connection->output, &header, sizeof(header));
+            appendBytes(&connection->output, request.message.data(),
+                        request.message.size());
+        }
+        flush(connection);
+    }
+    /// Discards the requests of connections that failed so the
+    /// connections can be retired.
+    void dropFailedRequests()
+    {
+        size_t nKeep = 0;
+        for (size_t i = 0; i < mPending.size(); ++i)
+        {
+            auto *connection = mPending[i].connection;
+            if (connection->failed)
+            {
+                connection->nPending = connection->nPending - 1;
+                continue;
+            }
+            if (i != nKeep){mPending[nKeep] = std::move(mPending[i]);}
+            nKeep = nKeep + 1;
+        }
+        mPending.resize(nKeep);
+    }
+    void fail(const RequestType type, const std::string &message)
+    {
+        for (auto &request : mPending)
+        {
+            if (!request.isFinished() &&
+                static_cast<RequestType> (request.header.type) == type)
+            {
+                request.status = Status::InternalError;
+                request.message = message;
+            }
+        }
+    }
+    /// Concatenates the next slice of position rows of every request.
+    /// Rows in the ephemeris table are interpolated and the others are
+    /// computed exactly; both sets are evaluated in parallel when large.
+    void answerPositions()
+    {
+        for (auto *group : {&mTableRows, &mExactRows}){group->clear();}
+        for (auto &request : mPending)
+        {
+            if (request.isFinished() ||
+                static_cast<RequestType> (request.header.type)
+                != RequestType::Position)
+            {
+                continue;
+            }
+            if (request.nAnswered == 0)
+            {
+                request.results.resize(request.rows.size()
+                                      *sizeof(PositionResult));
+            }
+            auto *results
+                = reinterpret_cast<PositionResult *> (request.results.data());
+            for (size_t i = request.nAnswered; i < request.sliceEnd(); ++i)
+            {
+                const auto &row = request.rows[i];
+                auto *group = mTable.contains(row.time) ?
+                              &mTableRows : &mExactRows;
+                group->add(row, results + i);
+            }
+        }
+        for (auto *group : {&mTableRows, &mExactRows})
+        {
+            auto nRows = group->times.size();
+            if (nRows == 0){continue;}
+            group->elevations.resize(nRows);
+            group->azimuths.resize(nRows);
+            const bool useTable = (group == &mTableRows);
+            auto compute = [&](const size_t first, const size_t last, int)
+            {
+                if (useTable)
+                {
+                    computeSolarPositions(mTable, last - first,
+                                          group->times.data() + first,
+                                          group->latitudes.data() + first,
+                                          group->longitudes.data() + first,
+                                          group->elevations.data() + first,
+                                          group->azimuths.data() + first);
+                }
+                else
+                {
+                    computeSolarPositions(last - first,
+                                          group->times.data() + first,
+                                          group->latitudes.data() + first,
+                                          group->longitudes.data() + first,
+                                          group->elevations.data() + first,
+                                          group->azimuths.data() + first);
+                }
+            };
+            if (nRows >= PARALLEL_THRESHOLD)
+            {
+                mEngine->parallelFor(nRows, compute);
+            }
+            else
+            {
+                compute(0, nRows, 0);
+            }
+            for (size_t i = 0; i < nRows; ++i)
+            {
+                group->destinations[i]->elevation = group->elevations[i];
+                group->destinations[i]->azimuth = group->azimuths[i];
+            }
+        }
+    }
+    void answerDayNight(Request *request)
+    {
+        auto first = request->nAnswered;
+        auto nRows = request->sliceEnd() - first;
+        mTimes.resize(nRows);
+        mLatitudes.resize(nRows);
+        mLongitudes.resize(nRows);
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            const auto &row = request->rows[first + i];
+            mTimes[i] = row.time;
+            mLatitudes[i] = row.latitude;
+            mLongitudes[i] = row.longitude;
+        }
+        auto isNight = std::make_unique<bool[]> (nRows);
+        auto depressionAngle = request->header.parameter;
+        // The classifier is thread-safe
+        auto classify = [&](const size_t first, const size_t last, int)
+        {
+            mClassifier.classify(last - first, mTimes.data() + first,
+                                 mLatitudes.data() + first,
+                                 mLongitudes.data() + first,
+                                 isNight.get() + first, depressionAngle);
+        };
+        if (nRows >= PARALLEL_THRESHOLD)
+        {
+            mEngine->parallelFor(nRows, classify);
+        }
+        else
+        {
+            classify(0, nRows, 0);
+        }
+        if (first == 0){request->results.resize(request->rows.size());}
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            request->results[first + i] = isNight[i] ? 1 : 0;
+        }
+    }
+    void answerRiseSet(Request *request)
+    {
+        auto zenith = 90 + request->header.parameter;
+        if (request->nAnswered == 0)
+        {
+            request->results.resize(request->rows.size()
+                                   *sizeof(RiseSetResult));
+        }
+        auto *results
+            = reinterpret_cast<RiseSetResult *> (request->results.data());
+        for (size_t i = request->nAnswered; i < request->sliceEnd(); ++i)
+        {
+            const auto &row = request->rows[i];
+            results[i] = computeRiseSet(row.time, row.latitude, row.longitude,
+                                        zenith);
+        }
+    }
+    /// Rise and set of the local day from a direct-mapped cache.  Only the
+    /// I/O thread touches the cache so it is not locked.
+    RiseSetResult computeRiseSet(const double time, const double latitude,
+                                 const double longitude, const double zenith)
+    {
+        auto lon = wrapLongitude(longitude);
+        auto day = calcLocalDay(time, lon);
+        uint64_t hash = toBits(latitude)*0x9E3779B97F4A7C15ULL;
+        hash = (hash ^ toBits(lon))*0xC2B2AE3D27D4EB4FULL;
+        hash = (hash ^ toBits(zenith))*0x165667B19E3779F9ULL;
+        hash = (hash ^ static_cast<uint64_t> (day))*0x9E3779B97F4A7C15ULL;
+        auto &slot = mRiseSetCache[static_cast<size_t> (hash >> 32)
+                                   & (RISE_SET_CACHE_SIZE - 1)];
+        if (slot.valid && slot.day == day && slot.latitude == latitude &&
+            slot.longitude == lon && slot.zenith == zenith)
+        {
+            return slot.result;
+        }
+        RiseSetResult result;
+        auto kind = calcRiseSetEpochs(day, latitude, lon, zenith,
+                                      &result.sunrise, &result.sunset,
+                                      &result.solarNoon);
+        if (kind != 0)
+        {
+            result.sunrise = std::numeric_limits<double>::quiet_NaN();
+            result.sunset = result.sunrise;
+        }
+        slot.result = result;
+        slot.latitude = latitude;
+        slot.longitude = lon;
+        slot.zenith = zenith;
+        slot.day = day;
+        slot.valid = true;
+        return result;
+    }
+
+    /// The position rows evaluated by one method and where their results go.
+    struct PositionGroup
+    {
+        void clear()
+        {
+            times.clear();
+            latitudes.clear();
+            longitudes.clear();
+            destinations.clear();
+        }
+        void add(const Row &row, PositionResult *destination)
+        {
+            times.push_back(row.time);
+            latitudes.push_back(row.latitude);
+            longitudes.push_back(row.longitude);
+            destinations.push_back(destination);
+        }
+        std::vector<double> times;
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+        std::vector<double> elevations;
+        std::vector<double> azimuths;
+        std::vector<PositionResult *> destinations;
+    };
+
+    EphemerisTable mTable;
+    DayNightClassifier mClassifier;
+    std::unique_ptr<ParallelEngine> mEngine;
+    std::vector<RiseSetSlot> mRiseSetCache;
+    std::vector<std::unique_ptr<Connection>> mConnections;
+    std::vector<Request> mPending;
+    std::vector<char> mReadBuffer;
+    PositionGroup mTableRows;
+    PositionGroup mExactRows;
+    std::vector<double> mTimes;
+    std::vector<double> mLatitudes;
+    std::vector<double> mLongitudes;
+    std::string mSocketPath;
+    std::thread mThread;
+    std::atomic<uint64_t> mRequests{0};
+    std::atomic<uint64_t> mBatches{0};
+    std::atomic<bool> mRunning{false};
+    int mListener = -1;
+    int mWakeRead = -1;
+    int mWakeWrite = -1;
+    bool mBound = false;
+};
+
+/// C'tor
+QueryServer::QueryServer() :
+    pImpl(std::make_unique<QueryServerImpl> ())
+{
+}
+
+/// Destructor
+QueryServer::~QueryServer() = default;
+
+/// Start
+void QueryServer::start(const std::string &socketPath,
+                        const int firstYear, const int lastYear)
+{
+    pImpl->start(socketPath, firstYear, lastYear);
+}
+
+/// Running?
+bool QueryServer::isRunning() const noexcept
+{
+    return pImpl->mRunning;
+}
+
+/// Socket path
+std::string QueryServer::getSocketPath() const
+{
+    if (!isRunning()){throw std::runtime_error("Server is not running");}
+    return pImpl->mSocketPath;
+}
+
+/// Stop
+void QueryServer::stop() noexcept
+{
+    pImpl->stop();
+}
+
+/// Statistics
+uint64_t QueryServer::getNumberOfRequests() const noexcept
+{
+    return pImpl->mRequests.load(std::memory_order_relaxed);
+}
+
+uint64_t QueryServer::getNumberOfBatches() const noexcept
+{
+    return pImpl->mBatches.load(std::memory_order_relaxed);
+}
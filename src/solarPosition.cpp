@@ -0,0 +1,171 @@
+#include <cmath>
+#include <limits>
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "kernels.hpp"
+#include "fastKernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+SolarPosition makeNaN() noexcept
+{
+    constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+    return SolarPosition{nan, nan, nan, nan};
+}
+
+/// Computes the azimuth and elevation given the time-only terms.
+void computeAzimuthElevation(const double time,
+                             const double latitude,
+                             const double longitude,
+                             SolarPosition *position) noexcept
+{
+    constexpr int tz = 0;
+    // calcAzEl expects a longitude in [0,360)
+    auto lon = longitude - 360.0*std::floor(longitude/360.0);
+    auto T = toJulianCentury(time);
+    auto azel = calcAzEl(T, calcMinutesOfDayFromEpoch(time), latitude, lon, tz,
+                         position->equationOfTime, position->declination);
+    position->azimuth = azel.first;
+    position->elevation = azel.second;
+}
+
+/// Computes the azimuth and elevation at a site given the time-only terms.
+void computeAzimuthElevation(const double time,
+                             const Site &site,
+                             SolarPosition *position) noexcept
+{
+    auto hourAngle = calcHourAngleBranchless(calcMinutesOfDayFromEpoch(time),
+                                             site.longitude,
+                                             position->equationOfTime);
+    auto decRad = degToRad(position->declination);
+    calcAzElFromCosines(std::cos(degToRad(hourAngle)), hourAngle,
+                        site.sinLatitude, site.cosLatitude,
+                        std::sin(decRad), std::cos(decRad),
+                        &position->azimuth, &position->elevation);
+}
+
+}
+
+/// Position
+SolarPosition SolarCalculator::computePosition(
+    const double time, const double latitude, const double longitude) noexcept
+{
+    if (!isValidTime(time) || !(latitude >= -90 && latitude <= 90))
+    {
+        return makeNaN();
+    }
+    SOLARCALCULATOR_COUNT(PositionEvaluations);
+    SolarPosition position;
+    auto T = toJulianCentury(time);
+    position.equationOfTime = calcEquationOfTime(T);
+    position.declination = calcSunDeclination(T);
+    computeAzimuthElevation(time, latitude, longitude, &position);
+    return position;
+}
+
+SolarPosition SolarCalculator::computePosition(
+    const double time, const Observer &observer) noexcept
+{
+    return computePosition(time, observer.latitude, observer.longitude);
+}
+
+SolarPosition SolarCalculator::computePosition(
+    const double time,
+    const Observer &observer,
+    const Accuracy accuracy) noexcept
+{
+    if (accuracy == Accuracy::Exact){return computePosition(time, observer);}
+    if (!isValidTime(time) ||
+        !(observer.latitude >= -90 && observer.latitude <= 90))
+    {
+        return makeNaN();
+    }
+    SOLARCALCULATOR_COUNT(PositionEvaluations);
+    SolarPosition position;
+    auto T = calcTimeJulianCentFromEpoch(time);
+    auto l0 = Fast::calcGeomMeanLongSun(T);
+    auto m = calcGeomMeanAnomalySun(T);
+    position.equationOfTime = Fast::calcEquationOfTimeFromAngles(T, l0, m);
+    position.declination = Fast::calcSunDeclinationFromAngles(T, l0, m);
+    auto hourAngle
+        = Fast::calcHourAngle(Fast::calcMinutesOfDayFromEpoch(time),
+                              observer.longitude, position.equationOfTime);
+    double sinLat, cosLat, sinDec, cosDec;
+    Fast::sinCosDeg(observer.latitude, &sinLat, &cosLat);
+    Fast::sinCosDeg(position.declination, &sinDec, &cosDec);
+    Fast::calcAzElFromCosines(Fast::cosDeg(hourAngle), hourAngle,
+                              sinLat, cosLat, sinDec, cosDec,
+                              &position.azimuth, &position.elevation);
+    return position;
+}
+
+SolarPosition SolarCalculator::computePosition(
+    const double time,
+    const Ephemeris &ephemeris,
+    const Observer &observer) noexcept
+{
+    if (!(observer.latitude >= -90 && observer.latitude <= 90))
+    {
+        return makeNaN();
+    }
+    SOLARCALCULATOR_COUNT(PositionEvaluations);
+    SolarPosition position;
+    position.equationOfTime = ephemeris.getEquationOfTime();
+    position.declination = ephemeris.getDeclination();
+    computeAzimuthElevation(time, observer.latitude, observer.longitude,
+                            &position);
+    return position;
+}
+
+SolarPosition SolarCalculator::computePosition(
+    const double time,
+    const StationSet &stations,
+    const size_t site) noexcept
+{
+    if (!isValidTime(time) || site >= stations.size()){return makeNaN();}
+    SOLARCALCULATOR_COUNT(PositionEvaluations);
+    SolarPosition position;
+    auto T = toJulianCentury(time);
+    position.equationOfTime = calcEquationOfTime(T);
+    position.declination = calcSunDeclination(T);
+    computeAzimuthElevation(time, stations.getSites()[site], &position);
+    return position;
+}
+
+SolarPosition SolarCalculator::computePosition(
+    const double time,
+    const Ephemeris &ephemeris,
+    const StationSet &stations,
+    const size_t site) noexcept
+{
+    if (site >= stations.size()){return makeNaN();}
+    SOLARCALCULATOR_COUNT(PositionEvaluations);
+    SolarPosition position;
+    position.equationOfTime = ephemeris.getEquationOfTime();
+    position.declination = ephemeris.getDeclination();
+    computeAzimuthElevation(time, stations.getSites()[site], &position);
+    return position;
+}
+
+/// Subsolar point
+Observer SolarCalculator::computeSubsolarPoint(const double time) noexcept
+{
+    if (!isValidTime(time))
+    {
+        constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+        return Observer{nan, nan};
+    }
+    auto T = calcTimeJulianCentFromEpoch(time);
+    auto eqTime = calcEquationOfTimeBranchless(T);
+    // The hour angle is zero at the subsolar longitude
+    auto longitude =-calcHourAngleBranchless(calcMinutesOfDayFromEpoch(time),
+                                             0.0, eqTime);
+    if (longitude >= 180){longitude = longitude - 360;}
+    return Observer{calcSunDeclinationBranchless(T), longitude};
+}
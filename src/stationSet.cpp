@@ -0,0 +1,199 @@
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+#include <stdexcept>
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+class StationSet::StationSetImpl
+{
+public:
+    /// The hot data
+    std::vector<Site> mSites;
+    /// The Earth-centered unit vectors as a structure of arrays
+    std::vector<double> mUnitX;
+    std::vector<double> mUnitY;
+    std::vector<double> mUnitZ;
+    /// The cold data
+    std::vector<std::string> mNames;
+    std::unordered_map<std::string, size_t> mIndices;
+};
+
+/// C'tor
+StationSet::StationSet() :
+    pImpl(std::make_unique<StationSetImpl> ())
+{
+}
+
+/// Copy c'tor
+StationSet::StationSet(const StationSet &stations)
+{
+    *this = stations;
+}
+
+/// Move c'tor
+StationSet::StationSet(StationSet &&stations) noexcept
+{
+    *this = std::move(stations);
+}
+
+/// Copy assignment
+StationSet& StationSet::operator=(const StationSet &stations)
+{
+    if (&stations == this){return *this;}
+    pImpl = std::make_unique<StationSetImpl> (*stations.pImpl);
+    return *this;
+}
+
+/// Move assignment
+StationSet& StationSet::operator=(StationSet &&stations) noexcept
+{
+    if (&stations == this){return *this;}
+    pImpl = std::move(stations.pImpl);
+    return *this;
+}
+
+/// Destructor
+StationSet::~StationSet() = default;
+
+/// Clear
+void StationSet::clear() noexcept
+{
+    pImpl->mSites.clear();
+    pImpl->mUnitX.clear();
+    pImpl->mUnitY.clear();
+    pImpl->mUnitZ.clear();
+    pImpl->mNames.clear();
+    pImpl->mIndices.clear();
+}
+
+/// Add
+size_t StationSet::add(const Observer &observer, const std::string &name)
+{
+    if (!(observer.latitude >= -90 && observer.latitude <= 90))
+    {
+        throw std::invalid_argument("Latitude = "
+                                  + std::to_string(observer.latitude)
+                                  + " must be in range [-90,90]");
+    }
+    if (!(observer.longitude >= -540 && observer.longitude < 540))
+    {
+        throw std::invalid_argument("Longitude = "
+                                  + std::to_string(observer.longitude)
+                                  + " must be in range [-540,540)");
+    }
+    if (!name.empty() && haveSite(name))
+    {
+        throw std::invalid_argument(name + " already registered");
+    }
+    Site site;
+    site.latitude = observer.latitude;
+    site.longitude = observer.longitude
+                   - 360.0*std::floor(observer.longitude/360.0);
+    site.sinLatitude = std::sin(degToRad(observer.latitude));
+    site.cosLatitude = std::cos(degToRad(observer.latitude));
+    auto lonRad = degToRad(site.longitude);
+    auto index = pImpl->mSites.size();
+    pImpl->mSites.push_back(site);
+    pImpl->mUnitX.push_back(site.cosLatitude*std::cos(lonRad));
+    pImpl->mUnitY.push_back(site.cosLatitude*std::sin(lonRad));
+    pImpl->mUnitZ.push_back(site.sinLatitude);
+    pImpl->mNames.push_back(name);
+    if (!name.empty()){pImpl->mIndices.insert(std::pair{name, index});}
+    return index;
+}
+
+size_t StationSet::add(const Location &location, const std::string &name)
+{
+    if (!location.haveLatitude())
+    {
+        throw std::invalid_argument("Latitude not set");
+    }
+    if (!location.haveLongitude())
+    {
+        throw std::invalid_argument("Longitude not set");
+    }
+    return add(location.getObserver(), name);
+}
+
+/// Reserve
+void StationSet::reserve(const size_t nSites)
+{
+    pImpl->mSites.reserve(nSites);
+    pImpl->mUnitX.reserve(nSites);
+    pImpl->mUnitY.reserve(nSites);
+    pImpl->mUnitZ.reserve(nSites);
+    pImpl->mNames.reserve(nSites);
+}
+
+/// Size
+size_t StationSet::size() const noexcept
+{
+    return pImpl->mSites.size();
+}
+
+/// Sites
+const Site& StationSet::getSite(const size_t index) const
+{
+    if (index >= size())
+    {
+        throw std::invalid_argument("Site index " + std::to_string(index)
+                                  + " must be less than "
+                                  + std::to_string(size()));
+    }
+    return pImpl->mSites[index];
+}
+
+const Site *StationSet::getSites() const noexcept
+{
+    return pImpl->mSites.data();
+}
+
+/// Unit vectors
+const double *StationSet::getUnitVectorsX() const noexcept
+{
+    return pImpl->mUnitX.data();
+}
+
+const double *StationSet::getUnitVectorsY() const noexcept
+{
+    return pImpl->mUnitY.data();
+}
+
+const double *StationSet::getUnitVectorsZ() const noexcept
+{
+    return pImpl->mUnitZ.data();
+}
+
+/// Names
+std::string StationSet::getName(const size_t index) const
+{
+    if (index >= size())
+    {
+        throw std::invalid_argument("Site index " + std::to_string(index)
+                                  + " must be less than "
+                                  + std::to_string(size()));
+    }
+    return pImpl->mNames[index];
+}
+
+size_t StationSet::getIndex(const std::string &name) const
+{
+    auto it = pImpl->mIndices.find(name);
+    if (it == pImpl->mIndices.end())
+    {
+        throw std::invalid_argument(name + " not registered");
+    }
+    return it->second;
+}
+
+bool StationSet::haveSite(const std::string &name) const noexcept
+{
+    return pImpl->mIndices.find(name) != pImpl->mIndices.end();
+}
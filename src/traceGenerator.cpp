@@ -0,0 +1,289 @@
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "solarCalculator/traceGenerator.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "kernels.hpp"
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Kernels;
+
+namespace
+{
+
+/// The time-only terms at an interpolation knot.
+struct Knot
+{
+    double sinDec = 0;
+    double cosDec = 1;
+    double eqTime = 0;
+};
+
+Knot evaluateKnot(const double time)
+{
+    auto T = calcTimeJulianCentFromEpoch(time);
+    auto decRad = degToRad(calcSunDeclinationBranchless(T));
+    Knot knot;
+    knot.sinDec = std::sin(decRad);
+    knot.cosDec = std::cos(decRad);
+    knot.eqTime = calcEquationOfTimeBranchless(T);
+    return knot;
+}
+
+}
+
+class TraceGenerator::TraceGeneratorImpl
+{
+public:
+    /// @result The time of the k'th sample.
+    [[nodiscard]] double getTime(const int64_t k) const noexcept
+    {
+        return mStartTime + static_cast<double> (k)*mSamplingPeriod;
+    }
+    /// Begins a new interpolation segment at the current sample.  The
+    /// segment is halved until the linear interpolant of the declination
+    /// and equation of time at the segment's midpoint is within tolerance.
+    void startSegment()
+    {
+        auto tA = getTime(mIndex);
+        auto knotA = mHaveSegment ? mKnotB : evaluateKnot(tA);
+        auto m = mSegmentLength;
+        Knot knotB;
+        double error = 0;
+        while (true)
+        {
+            knotB = evaluateKnot(getTime(mIndex + m));
+            auto knotM = evaluateKnot(tA + 0.5*static_cast<double> (m)
+                                         *mSamplingPeriod);
+            auto decError
+                = std::max(std::abs(knotM.sinDec
+                                  - 0.5*(knotA.sinDec + knotB.sinDec)),
+                           std::abs(knotM.cosDec
+                                  - 0.5*(knotA.cosDec + knotB.cosDec)));
+            // Equation of time is in minutes; 4 minutes per degree
+            auto hourAngleError
+                = std::abs(knotM.eqTime - 0.5*(knotA.eqTime + knotB.eqTime))
+                 /4.0;
+            error = std::max(radToDeg(decError), hourAngleError);
+            if (error <= mTolerance || m == 1){break;}
+            m = std::max(m/2, static_cast<int64_t> (1));
+        }
+        // The error grows quadratically with the segment length so there is
+        // room to double the next segment
+        mSegmentLength = m;
+        if (error < mTolerance/8)
+        {
+            mSegmentLength = std::min(2*m, mMaxSegmentLength);
+        }
+        auto rm = 1.0/static_cast<double> (m);
+        mSinDec = knotA.sinDec;
+        mCosDec = knotA.cosDec;
+        mDeltaSinDec = (knotB.sinDec - knotA.sinDec)*rm;
+        mDeltaCosDec = (knotB.cosDec - knotA.cosDec)*rm;
+        // Reseed the hour angle exactly then rotate it by a fixed step
+        auto hourAngle
+            = calcHourAngleBranchless(calcMinutesOfDayFromEpoch(tA),
+                                      mLongitude, knotA.eqTime);
+        mCosHourAngle = std::cos(degToRad(hourAngle));
+        mSinHourAngle = std::sin(degToRad(hourAngle));
+        auto step = mSamplingPeriod/240.0
+                  + (knotB.eqTime - knotA.eqTime)*rm/4.0;
+        mCosStep = std::cos(degToRad(step));
+        mSinStep = std::sin(degToRad(step));
+        mKnotB = knotB;
+        mSegmentEnd = mIndex + m;
+        mHaveSegment = true;
+    }
+    /// Fills samples in the current segment.
+    void fill(const int64_t nSamples, double elevations[], double azimuths[])
+    {
+        double azimuth;
+        for (int64_t i = 0; i < nSamples; ++i)
+        {
+            calcAzElFromCosines(mCosHourAngle, mSinHourAngle,
+                                mSinLatitude, mCosLatitude,
+                                mSinDec, mCosDec,
+                                &azimuth, &elevations[i]);
+            if (azimuths){azimuths[i] = azimuth;}
+            // Advance
+            auto cosHourAngle = mCosHourAngle*mCosStep
+                              - mSinHourAngle*mSinStep;
+            mSinHourAngle = mSinHourAngle*mCosStep + mCosHourAngle*mSinStep;
+            mCosHourAngle = cosHourAngle;
+            mSinDec = mSinDec + mDeltaSinDec;
+            mCosDec = mCosDec + mDeltaCosDec;
+        }
+        mIndex = mIndex + nSamples;
+    }
+
+    Knot mKnotB;
+    double mStartTime = 0;
+    double mSamplingPeriod = 1;
+    double mTolerance = DEFAULT_TOLERANCE;
+    double mLongitude = 0;
+    double mSinLatitude = 0;
+    double mCosLatitude = 1;
+    double mSinDec = 0;
+    double mCosDec = 1;
+    double mDeltaSinDec = 0;
+    double mDeltaCosDec = 0;
+    double mCosHourAngle = 1;
+    double mSinHourAngle = 0;
+    double mCosStep = 1;
+    double mSinStep = 0;
+    /// The index of the next sample
+    int64_t mIndex = 0;
+    /// The index of the sample ending the current segment
+    int64_t mSegmentEnd = 0;
+    /// The number of samples in the next segment
+    int64_t mSegmentLength = 1;
+    /// Segments never exceed a day
+    int64_t mMaxSegmentLength = 1;
+    bool mHaveSegment = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+TraceGenerator::TraceGenerator() :
+    pImpl(std::make_unique<TraceGeneratorImpl> ())
+{
+}
+
+/// Copy c'tor
+TraceGenerator::TraceGenerator(const TraceGenerator &generator)
+{
+    *this = generator;
+}
+
+/// Move c'tor
+TraceGenerator::TraceGenerator(TraceGenerator &&generator) noexcept
+{
+    *this = std::move(generator);
+}
+
+/// Copy assignment
+TraceGenerator& TraceGenerator::operator=(const TraceGenerator &generator)
+{
+    if (&generator == this){return *this;}
+    pImpl = std::make_unique<TraceGeneratorImpl> (*generator.pImpl);
+    return *this;
+}
+
+/// Move assignment
+TraceGenerator&
+TraceGenerator::operator=(TraceGenerator &&generator) noexcept
+{
+    if (&generator == this){return *this;}
+    pImpl = std::move(generator.pImpl);
+    return *this;
+}
+
+/// Destructor
+TraceGenerator::~TraceGenerator() = default;
+
+/// Clear
+void TraceGenerator::clear() noexcept
+{
+    pImpl = std::make_unique<TraceGeneratorImpl> ();
+}
+
+/// Initialize
+void TraceGenerator::initialize(const Location &location,
+                                const double startTime,
+                                const double samplingPeriod,
+                                const double tolerance)
+{
+    if (!location.haveLatitude()){throw std::invalid_argument("Latitude not set");}
+    if (!location.haveLongitude()){throw std::invalid_argument("Longitude not set");}
+    auto observer = location.getObserver();
+    if (!isValidEpoch(startTime))
+    {
+        throw std::invalid_argument("Time " + std::to_string(startTime)
+                                  + " must be in years [-1000,2999]");
+    }
+    if (!(samplingPeriod > 0))
+    {
+        throw std::invalid_argument("Sampling period must be positive");
+    }
+    if (!(tolerance > 0))
+    {
+        throw std::invalid_argument("Tolerance must be positive");
+    }
+    auto impl = std::make_unique<TraceGeneratorImpl> ();
+    impl->mStartTime = startTime;
+    impl->mSamplingPeriod = samplingPeriod;
+    impl->mTolerance = tolerance;
+    impl->mLongitude = observer.longitude;
+    impl->mSinLatitude = std::sin(degToRad(observer.latitude));
+    impl->mCosLatitude = std::cos(degToRad(observer.latitude));
+    impl->mMaxSegmentLength
+        = std::max(static_cast<int64_t> (86400.0/samplingPeriod),
+                   static_cast<int64_t> (1));
+    impl->mSegmentLength
+        = std::clamp(static_cast<int64_t> (std::round(3600.0/samplingPeriod)),
+                     static_cast<int64_t> (1), impl->mMaxSegmentLength);
+    impl->mInitialized = true;
+    pImpl = std::move(impl);
+}
+
+/// Initialized?
+bool TraceGenerator::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Generate
+void TraceGenerator::generate(const size_t nSamples,
+                              double elevations[], double azimuths[])
+{
+    if (!isInitialized())
+    {
+        throw std::runtime_error("Generator not initialized");
+    }
+    if (nSamples == 0){return;}
+    if (elevations == nullptr)
+    {
+        throw std::invalid_argument("elevations is NULL");
+    }
+    auto lastIndex = pImpl->mIndex + static_cast<int64_t> (nSamples) - 1;
+    if (!isValidEpoch(pImpl->getTime(lastIndex)))
+    {
+        throw std::invalid_argument("Trace cannot extend past year 2999");
+    }
+    size_t i = 0;
+    while (i < nSamples)
+    {
+        if (!pImpl->mHaveSegment || pImpl->mIndex == pImpl->mSegmentEnd)
+        {
+            pImpl->startSegment();
+        }
+        auto nFill = std::min(static_cast<int64_t> (nSamples - i),
+                              pImpl->mSegmentEnd - pImpl->mIndex);
+        pImpl->fill(nFill, elevations + i,
+                    azimuths ? azimuths + i : nullptr);
+        i = i + static_cast<size_t> (nFill);
+    }
+}
+
+/// Next time
+double TraceGenerator::getNextTime() const
+{
+    if (!isInitialized())
+    {
+        throw std::runtime_error("Generator not initialized");
+    }
+    return pImpl->getTime(pImpl->mIndex);
+}
+
+/// Sampling period
+double TraceGenerator::getSamplingPeriod() const
+{
+    if (!isInitialized())
+    {
+        throw std::runtime_error("Generator not initialized");
+    }
+    return pImpl->mSamplingPeriod;
+}
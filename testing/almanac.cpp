@@ -0,0 +1,134 @@
+#include <vector>
+#include <cmath>
+#include "solarCalculator/almanac.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/parallelEngine.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/sun.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+StationSet makeStations()
+{
+    StationSet stations;
+    stations.add(Observer{40.77, -111.89}, "UU.CTU");
+    stations.add(Observer{71.29, -156.79}, "AK.BRW");
+    stations.add(Observer{-77.85, 166.67}, "IU.SBA");
+    stations.add(Observer{-33.9, 18.4}, "quarry");
+    stations.add(Observer{0, 179.9}, "dateline");
+    return stations;
+}
+
+TEST(Almanac, MatchesSun)
+{
+    auto stations = makeStations();
+    Almanac almanac;
+    EXPECT_FALSE(almanac.haveAlmanac());
+    EXPECT_THROW(static_cast<void> (almanac.getSunrises()), std::runtime_error);
+    EXPECT_NO_THROW(almanac.compute(stations, 2020, 2021));
+    EXPECT_TRUE(almanac.haveAlmanac());
+    EXPECT_EQ(almanac.getNumberOfSites(), stations.size());
+    ASSERT_EQ(almanac.getNumberOfDays(), 366 + 365);
+    EXPECT_EQ(almanac.getNumberOfRows(), stations.size()*(366 + 365));
+    const auto *days = almanac.getLocalDays();
+    EXPECT_EQ(days[0], 18262);  // 2020-01-01
+    EXPECT_EQ(days[almanac.getNumberOfDays() - 1], 18992); // 2021-12-31
+    const auto *sunrises = almanac.getSunrises();
+    const auto *sunsets = almanac.getSunsets();
+    const auto *noons = almanac.getSolarNoons();
+    const auto *dayLengths = almanac.getDayLengths();
+    auto nDays = almanac.getNumberOfDays();
+    int nPolarDays = 0;
+    int nPolarNights = 0;
+    for (size_t site = 0; site < stations.size(); ++site)
+    {
+        Sun sun;
+        const auto &observer = stations.getSite(site);
+        sun.setLocation(Location(observer.latitude, observer.longitude));
+        for (size_t day = 0; day < nDays; ++day)
+        {
+            auto row = site*nDays + day;
+            // Local mean noon is on the local day
+            auto time = (static_cast<double> (days[day]) + 0.5
+                       - observer.longitude/360.0)*86400;
+            if (observer.longitude >= 180){time = time + 86400;}
+            sun.setTime(static_cast<int64_t> (time));
+            EXPECT_NEAR(noons[row], sun.getSolarNoon(), 1.e-3);
+            if (std::isnan(sun.getSunrise()))
+            {
+                EXPECT_TRUE(std::isnan(sunrises[row]));
+                EXPECT_TRUE(std::isnan(sunsets[row]));
+                EXPECT_TRUE(dayLengths[row] == 0 || dayLengths[row] == 86400);
+                if (dayLengths[row] == 0){nPolarNights = nPolarNights + 1;}
+                if (dayLengths[row] > 0){nPolarDays = nPolarDays + 1;}
+            }
+            else
+            {
+                EXPECT_NEAR(sunrises[row], sun.getSunrise(), 1.e-3);
+                EXPECT_NEAR(sunsets[row], sun.getSunset(), 1.e-3);
+                EXPECT_NEAR(dayLengths[row], sunsets[row] - sunrises[row],
+                            1.e-6);
+            }
+        }
+    }
+    EXPECT_GT(nPolarDays, 0);
+    EXPECT_GT(nPolarNights, 0);
+    // Parallel results are identical
+    ParallelEngine engine(3);
+    engine.setGrainSize(100);
+    Almanac parallelAlmanac;
+    parallelAlmanac.compute(stations, 2020, 2021, engine);
+    ASSERT_EQ(parallelAlmanac.getNumberOfRows(), almanac.getNumberOfRows());
+    for (size_t row = 0; row < almanac.getNumberOfRows(); ++row)
+    {
+        EXPECT_EQ(parallelAlmanac.getSolarNoons()[row], noons[row]);
+        EXPECT_EQ(parallelAlmanac.getDayLengths()[row], dayLengths[row]);
+    }
+    // Copy
+    auto copy = almanac;
+    EXPECT_EQ(copy.getSunsets()[10], sunsets[10]);
+    copy.clear();
+    EXPECT_FALSE(copy.haveAlmanac());
+}
+
+TEST(Almanac, NegativeYears)
+{
+    StationSet stations;
+    stations.add(Observer{40.77, -111.89}, "UU.CTU");
+    // 2 BCE is a common year and 1 BCE is a leap year
+    Almanac almanac;
+    almanac.compute(stations, -1, 0);
+    ASSERT_EQ(almanac.getNumberOfDays(), 365 + 366);
+    const auto *days = almanac.getLocalDays();
+    EXPECT_EQ(days[0], -719893);  // -0001-01-01
+    EXPECT_EQ(days[365], -719528); // 0000-01-01
+    EXPECT_EQ(days[almanac.getNumberOfDays() - 1], -719163); // 0000-12-31
+    // The first supported day
+    almanac.compute(stations, -1000, -1000);
+    EXPECT_EQ(static_cast<double> (almanac.getLocalDays()[0])*86400,
+              MINIMUM_EPOCH);
+    EXPECT_FALSE(std::isnan(almanac.getSolarNoons()[0]));
+}
+
+TEST(Almanac, Errors)
+{
+    Almanac almanac;
+    StationSet empty;
+    EXPECT_THROW(almanac.compute(empty, 2020, 2020), std::invalid_argument);
+    auto stations = makeStations();
+    EXPECT_THROW(almanac.compute(stations, 2021, 2020),
+                 std::invalid_argument);
+    EXPECT_THROW(almanac.compute(stations, -1001, 2020),
+                 std::invalid_argument);
+    EXPECT_THROW(almanac.compute(stations, 2020, 3000),
+                 std::invalid_argument);
+    EXPECT_FALSE(almanac.haveAlmanac());
+}
+
+}
@@ -0,0 +1,346 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/sun.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(Batch, MatchesSun)
+{
+    const size_t nRows = 1000;
+    std::mt19937 generator(8675309);
+    std::uniform_int_distribution<int64_t> timeDist(-93724214400 + 86400,
+                                                    32503680000 - 86400);
+    std::uniform_real_distribution<double> latDist(-90, 90);
+    std::uniform_real_distribution<double> lonDist(-540, 539.99);
+    std::vector<double> times(nRows), latitudes(nRows), longitudes(nRows);
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        times[i] = static_cast<double> (timeDist(generator));
+        latitudes[i] = latDist(generator);
+        longitudes[i] = lonDist(generator);
+    }
+    // Make sure the salt lake city examples are in there
+    times[0] = 1622042345;
+    latitudes[0] = 40.77;
+    longitudes[0] = -111.89;
+    std::vector<double> elevations(nRows), azimuths(nRows),
+                        declinations(nRows), equationsOfTime(nRows);
+    EXPECT_NO_THROW(computeSolarPositions(nRows, times.data(),
+                                          latitudes.data(), longitudes.data(),
+                                          elevations.data(), azimuths.data(),
+                                          declinations.data(),
+                                          equationsOfTime.data()));
+    EXPECT_NEAR(elevations[0], 35.09, 0.01);
+    EXPECT_NEAR(azimuths[0], 91.2, 0.1);
+    Sun sun;
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        sun.setLocation(Location(latitudes[i], longitudes[i]));
+        sun.setTime(static_cast<int64_t> (times[i]));
+        EXPECT_NEAR(elevations[i], sun.getElevation(), 1.e-6);
+        // Azimuth is ill-conditioned when the sun is at the zenith
+        if (elevations[i] < 89.9)
+        {
+            auto dAz = std::abs(azimuths[i] - sun.getAzimuth());
+            EXPECT_NEAR(std::min(dAz, 360 - dAz), 0, 1.e-6);
+        }
+        EXPECT_NEAR(declinations[i], sun.getDeclination(), 1.e-8);
+        EXPECT_NEAR(equationsOfTime[i], sun.getEquationOfTime(), 1.e-8);
+    }
+    // Only ask for elevation
+    std::vector<double> elevationsOnly(nRows);
+    computeSolarPositions(nRows, times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevationsOnly.data());
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        EXPECT_NEAR(elevationsOnly[i], elevations[i], 1.e-14);
+    }
+}
+
+TEST(Batch, SinglePrecision)
+{
+    const size_t nRows = 20000;
+    std::mt19937 generator(8675309);
+    std::uniform_real_distribution<double> timeDist(-93724214400 + 86400,
+                                                    32503680000 - 86400);
+    std::uniform_real_distribution<float> latDist(-90, 90);
+    std::uniform_real_distribution<float> lonDist(-540, 539.99);
+    std::vector<double> times(nRows), latitudes(nRows), longitudes(nRows);
+    std::vector<float> latitudesFloat(nRows), longitudesFloat(nRows);
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        times[i] = timeDist(generator);
+        latitudesFloat[i] = latDist(generator);
+        longitudesFloat[i] = lonDist(generator);
+        latitudes[i] = latitudesFloat[i];
+        longitudes[i] = longitudesFloat[i];
+    }
+    std::vector<double> elevations(nRows), azimuths(nRows),
+                        declinations(nRows), equationsOfTime(nRows);
+    std::vector<float> elevationsFloat(nRows), azimuthsFloat(nRows),
+                       declinationsFloat(nRows), equationsOfTimeFloat(nRows);
+    computeSolarPositions(nRows, times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevations.data(), azimuths.data(),
+                          declinations.data(), equationsOfTime.data());
+    EXPECT_NO_THROW(computeSolarPositionsFloat(nRows, times.data(),
+                                               latitudesFloat.data(),
+                                               longitudesFloat.data(),
+                                               elevationsFloat.data(),
+                                               azimuthsFloat.data(),
+                                               declinationsFloat.data(),
+                                               equationsOfTimeFloat.data()));
+    // These are the documented accuracies
+    double sumSquares = 0;
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        auto elevationError = elevationsFloat[i] - elevations[i];
+        sumSquares = sumSquares + elevationError*elevationError;
+        EXPECT_NEAR(elevationsFloat[i], elevations[i], 2.e-3);
+        EXPECT_NEAR(declinationsFloat[i], declinations[i], 5.e-5);
+        EXPECT_NEAR(equationsOfTimeFloat[i], equationsOfTime[i], 5.e-5);
+        if (std::abs(elevations[i]) < 80 &&
+            std::abs(latitudes[i]) < 89 &&
+            azimuths[i] > 5 && azimuths[i] < 355 &&
+            std::abs(azimuths[i] - 180) > 5)
+        {
+            EXPECT_NEAR(azimuthsFloat[i], azimuths[i], 1.e-2);
+        }
+    }
+    EXPECT_LT(std::sqrt(sumSquares/nRows), 5.e-5);
+    // Single elevations
+    std::vector<float> elevationsOnly(nRows);
+    computeSolarPositionsFloat(nRows, times.data(),
+                               latitudesFloat.data(), longitudesFloat.data(),
+                               elevationsOnly.data());
+    EXPECT_TRUE(std::equal(elevationsOnly.begin(), elevationsOnly.end(),
+                           elevationsFloat.begin()));
+    float badLatitude = 91;
+    float longitude = 0;
+    float elevation = 0;
+    EXPECT_THROW(computeSolarPositionsFloat(1, times.data(), &badLatitude,
+                                            &longitude, &elevation),
+                 std::invalid_argument);
+}
+
+TEST(Batch, Accuracy)
+{
+    const size_t nRows = 50000;
+    std::mt19937 generator(8675309);
+    std::uniform_real_distribution<double> timeDist(-93724214400 + 86400,
+                                                    32503680000 - 86400);
+    std::uniform_real_distribution<double> latDist(-90, 90);
+    std::uniform_real_distribution<double> lonDist(-540, 539.99);
+    std::vector<double> times(nRows), latitudes(nRows), longitudes(nRows);
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        times[i] = timeDist(generator);
+        latitudes[i] = latDist(generator);
+        longitudes[i] = lonDist(generator);
+    }
+    std::vector<double> elevations(nRows), azimuths(nRows),
+                        declinations(nRows), equationsOfTime(nRows);
+    computeSolarPositions(nRows, times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevations.data(), azimuths.data(),
+                          declinations.data(), equationsOfTime.data());
+    // The exact tier is the default path
+    std::vector<double> elevationsExact(nRows), azimuthsExact(nRows),
+                        declinationsExact(nRows), equationsOfTimeExact(nRows);
+    computeSolarPositions(Accuracy::Exact, nRows, times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevationsExact.data(), azimuthsExact.data(),
+                          declinationsExact.data(),
+                          equationsOfTimeExact.data());
+    EXPECT_EQ(elevationsExact, elevations);
+    EXPECT_EQ(azimuthsExact, azimuths);
+    EXPECT_EQ(declinationsExact, declinations);
+    EXPECT_EQ(equationsOfTimeExact, equationsOfTime);
+    // The fast tier is within the documented bounds
+    std::vector<double> elevationsFast(nRows), azimuthsFast(nRows),
+                        declinationsFast(nRows), equationsOfTimeFast(nRows);
+    EXPECT_NO_THROW(computeSolarPositions(Accuracy::Fast, nRows, times.data(),
+                                          latitudes.data(), longitudes.data(),
+                                          elevationsFast.data(),
+                                          azimuthsFast.data(),
+                                          declinationsFast.data(),
+                                          equationsOfTimeFast.data()));
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        EXPECT_NEAR(elevationsFast[i], elevations[i], 5.e-6);
+        EXPECT_NEAR(declinationsFast[i], declinations[i], 2.e-6);
+        EXPECT_NEAR(equationsOfTimeFast[i], equationsOfTime[i], 1.e-8);
+        auto azimuthError = std::abs(azimuthsFast[i] - azimuths[i]);
+        azimuthError = std::min(azimuthError, 360 - azimuthError);
+        EXPECT_LT(azimuthError,
+                  std::abs(elevations[i]) < 89 ? 1.e-4 : 1.e-3);
+        // Per-call selection matches per-batch selection
+        if (i%100 == 0)
+        {
+            auto position = computePosition(times[i],
+                                            Observer{latitudes[i],
+                                                     longitudes[i]},
+                                            Accuracy::Fast);
+            EXPECT_NEAR(position.elevation, elevationsFast[i], 1.e-12);
+            EXPECT_NEAR(position.azimuth, azimuthsFast[i], 1.e-9);
+        }
+    }
+    double badLatitude = 91;
+    double elevation = 0;
+    EXPECT_THROW(computeSolarPositions(Accuracy::Fast, 1, times.data(),
+                                       &badLatitude, longitudes.data(),
+                                       &elevation),
+                 std::invalid_argument);
+}
+
+TEST(Batch, Errors)
+{
+    double time = 1622042345;
+    double latitude = 40.77;
+    double longitude = -111.89;
+    double elevation = 0;
+    EXPECT_NO_THROW(computeSolarPositions(0, nullptr, nullptr, nullptr,
+                                          nullptr));
+    EXPECT_THROW(computeSolarPositions(1, nullptr, &latitude, &longitude,
+                                       &elevation),
+                 std::invalid_argument);
+    double badLatitude = 91;
+    EXPECT_THROW(computeSolarPositions(1, &time, &badLatitude, &longitude,
+                                       &elevation),
+                 std::invalid_argument);
+    double badTime = 32503680000;
+    EXPECT_THROW(computeSolarPositions(1, &badTime, &latitude, &longitude,
+                                       &elevation),
+                 std::invalid_argument);
+}
+
+
+TEST(Batch, Grid)
+{
+    // Utah at 0.05 degrees plus a polar and a wrapped column
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    for (int i = 0; i <= 100; ++i){latitudes.push_back(37 + 0.05*i);}
+    for (int j = 0; j <= 100; ++j){longitudes.push_back(-114 + 0.05*j);}
+    latitudes.push_back(90);
+    latitudes.push_back(-90);
+    longitudes.push_back(359);
+    auto nLat = latitudes.size();
+    auto nLon = longitudes.size();
+    for (const double time : {1622042345.0, 1575507986.5, -5.e10, 3.e10})
+    {
+        std::vector<double> elevations(nLat*nLon);
+        std::vector<double> azimuths(nLat*nLon);
+        std::vector<double> elevationsOnly(nLat*nLon);
+        computeSolarPositionGrid(time, nLat, latitudes.data(),
+                                 nLon, longitudes.data(),
+                                 elevations.data(), azimuths.data());
+        computeSolarPositionGrid(time, nLat, latitudes.data(),
+                                 nLon, longitudes.data(),
+                                 elevationsOnly.data());
+        // Flatten the grid and compare with the catalog solver
+        std::vector<double> times(nLat*nLon, time);
+        std::vector<double> rowLatitudes(nLat*nLon);
+        std::vector<double> rowLongitudes(nLat*nLon);
+        for (size_t i = 0; i < nLat; ++i)
+        {
+            for (size_t j = 0; j < nLon; ++j)
+            {
+                rowLatitudes[i*nLon + j] = latitudes[i];
+                rowLongitudes[i*nLon + j] = longitudes[j];
+            }
+        }
+        std::vector<double> elevationsRef(nLat*nLon);
+        std::vector<double> azimuthsRef(nLat*nLon);
+        computeSolarPositions(times.size(), times.data(),
+                              rowLatitudes.data(), rowLongitudes.data(),
+                              elevationsRef.data(), azimuthsRef.data());
+        for (size_t k = 0; k < elevations.size(); ++k)
+        {
+            EXPECT_NEAR(elevations[k], elevationsRef[k], 1.e-12);
+            EXPECT_NEAR(elevationsOnly[k], elevationsRef[k], 1.e-12);
+            EXPECT_NEAR(azimuths[k], azimuthsRef[k], 1.e-10);
+        }
+    }
+    // Errors
+    double elevation = 0;
+    double latitude = 40;
+    double longitude = -111;
+    double badLatitude = 91;
+    double badLongitude = 540;
+    EXPECT_NO_THROW(computeSolarPositionGrid(1622042345, 0, nullptr,
+                                             0, nullptr, nullptr));
+    EXPECT_THROW(computeSolarPositionGrid(1622042345, 1, nullptr,
+                                          1, &longitude, &elevation),
+                 std::invalid_argument);
+    EXPECT_THROW(computeSolarPositionGrid(1622042345, 1, &badLatitude,
+                                          1, &longitude, &elevation),
+                 std::invalid_argument);
+    EXPECT_THROW(computeSolarPositionGrid(1622042345, 1, &latitude,
+                                          1, &badLongitude, &elevation),
+                 std::invalid_argument);
+    EXPECT_THROW(computeSolarPositionGrid(32503680000, 1, &latitude,
+                                          1, &longitude, &elevation),
+                 std::invalid_argument);
+}
+
+
+TEST(Batch, OneTimeManySites)
+{
+    const size_t nSites = 5000;
+    std::mt19937 generator(2718);
+    std::uniform_real_distribution<double> latDist(-90, 90);
+    std::uniform_real_distribution<double> lonDist(-540, 540);
+    std::vector<double> latitudes(nSites);
+    std::vector<double> longitudes(nSites);
+    StationSet stations;
+    for (size_t i = 0; i < nSites; ++i)
+    {
+        latitudes[i] = latDist(generator);
+        longitudes[i] = lonDist(generator);
+        stations.add(Observer{latitudes[i], longitudes[i]});
+    }
+    for (const double time : {1622042345.0, -9.e10, 3.2e10, 0.5})
+    {
+        std::vector<double> times(nSites, time);
+        std::vector<double> elevationsRef(nSites);
+        computeSolarPositions(nSites, times.data(), latitudes.data(),
+                              longitudes.data(), elevationsRef.data());
+        std::vector<double> elevations(nSites);
+        computeElevations(time, nSites, latitudes.data(), longitudes.data(),
+                          elevations.data());
+        std::vector<double> elevationsFromVectors(nSites);
+        computeElevations(time, stations, elevationsFromVectors.data());
+        for (size_t i = 0; i < nSites; ++i)
+        {
+            EXPECT_NEAR(elevations[i], elevationsRef[i], 1.e-12);
+            EXPECT_NEAR(elevationsFromVectors[i], elevationsRef[i], 1.e-6);
+        }
+    }
+    // Errors
+    double elevation = 0;
+    double latitude = 91;
+    double longitude = 0;
+    EXPECT_NO_THROW(computeElevations(0, StationSet {}, nullptr));
+    EXPECT_THROW(computeElevations(0, stations, nullptr),
+                 std::invalid_argument);
+    EXPECT_THROW(computeElevations(1.e15, stations, &elevation),
+                 std::invalid_argument);
+    EXPECT_THROW(computeElevations(0, 1, &latitude, &longitude, &elevation),
+                 std::invalid_argument);
+    EXPECT_THROW(computeElevations(0, 1, nullptr, &longitude, &elevation),
+                 std::invalid_argument);
+}
+
+}
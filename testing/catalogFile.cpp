@@ -0,0 +1,164 @@
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include "solarCalculator/catalogFile.hpp"
+#include "solarCalculator/batch.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+void fill(CatalogFile &catalog)
+{
+    auto nRows = catalog.getNumberOfRows();
+    auto *times = catalog.getMutableFloat64Column("time");
+    auto *latitudes = catalog.getMutableFloat64Column("latitude");
+    auto *longitudes = catalog.getMutableFloat64Column("longitude");
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        times[i] = 1262304000 + 3721.*static_cast<double> (i);
+        latitudes[i] =-89 + static_cast<double> ((7*i)%179);
+        longitudes[i] =-180 + static_cast<double> ((13*i)%360);
+    }
+}
+
+TEST(CatalogFile, CreateAnnotateOpen)
+{
+    const std::string fileName{"catalogFile.bin"};
+    const size_t nRows = 1003;
+    CatalogFile catalog;
+    EXPECT_FALSE(catalog.isOpen());
+    EXPECT_THROW(static_cast<void> (catalog.getNumberOfRows()),
+                 std::runtime_error);
+    catalog.create(fileName, nRows,
+                   {{"time", ColumnType::Float64},
+                    {"latitude", ColumnType::Float64},
+                    {"longitude", ColumnType::Float64}});
+    EXPECT_TRUE(catalog.isOpen());
+    EXPECT_TRUE(catalog.isWritable());
+    EXPECT_EQ(catalog.getNumberOfRows(), nRows);
+    fill(catalog);
+    EXPECT_NO_THROW(annotateCatalog(catalog));
+    auto names = catalog.getColumnNames();
+    ASSERT_EQ(names.size(), 5);
+    EXPECT_EQ(names[3], "elevation");
+    EXPECT_EQ(names[4], "azimuth");
+    catalog.close();
+    EXPECT_FALSE(catalog.isOpen());
+
+    CatalogFile reader;
+    reader.open(fileName);
+    EXPECT_FALSE(reader.isWritable());
+    ASSERT_EQ(reader.getNumberOfRows(), nRows);
+    EXPECT_EQ(reader.getColumnType("azimuth"), ColumnType::Float64);
+    EXPECT_THROW(static_cast<void> (reader.getMutableFloat64Column("time")),
+                 std::runtime_error);
+    EXPECT_THROW(reader.addColumn("flag", ColumnType::Int64),
+                 std::runtime_error);
+    const auto *times = reader.getFloat64Column("time");
+    const auto *latitudes = reader.getFloat64Column("latitude");
+    const auto *longitudes = reader.getFloat64Column("longitude");
+    const auto *elevations = reader.getFloat64Column("elevation");
+    const auto *azimuths = reader.getFloat64Column("azimuth");
+    EXPECT_EQ(reinterpret_cast<uintptr_t> (times)%64, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t> (azimuths)%64, 0);
+    std::vector<double> elevationsRef(nRows), azimuthsRef(nRows);
+    computeSolarPositions(nRows, times, latitudes, longitudes,
+                          elevationsRef.data(), azimuthsRef.data());
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        EXPECT_EQ(elevations[i], elevationsRef[i]);
+        EXPECT_EQ(azimuths[i], azimuthsRef[i]);
+    }
+
+    // Re-annotating in place does not add columns
+    CatalogFile writer;
+    writer.open(fileName, true);
+    writer.getMutableFloat64Column("elevation")[0] = 999;
+    annotateCatalog(writer);
+    EXPECT_EQ(writer.getColumnNames().size(), 5);
+    EXPECT_EQ(writer.getFloat64Column("elevation")[0], elevationsRef[0]);
+    // Add an integer column
+    writer.addColumn("flag", ColumnType::Int64);
+    EXPECT_THROW(writer.addColumn("flag", ColumnType::Int64),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (writer.getFloat64Column("flag")),
+                 std::invalid_argument);
+    auto *flags = writer.getMutableInt64Column("flag");
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        EXPECT_EQ(flags[i], 0);
+        flags[i] = static_cast<int64_t> (i) - 500;
+    }
+    writer.flush();
+    writer.close();
+
+    reader.open(fileName);
+    EXPECT_EQ(reader.getColumnType("flag"), ColumnType::Int64);
+    EXPECT_EQ(reader.getInt64Column("flag")[nRows - 1], 502);
+    EXPECT_EQ(reader.getFloat64Column("azimuth")[nRows - 1],
+              azimuthsRef[nRows - 1]);
+    reader.close();
+    std::filesystem::remove(fileName);
+}
+
+TEST(CatalogFile, Errors)
+{
+    const std::string fileName{"catalogFileErrors.bin"};
+    CatalogFile catalog;
+    EXPECT_THROW(catalog.open("this/file/does/not/exist.bin"),
+                 std::invalid_argument);
+    EXPECT_THROW(catalog.create(fileName, 10, {{"", ColumnType::Float64}}),
+                 std::invalid_argument);
+    EXPECT_THROW(catalog.create(fileName, 10,
+                                {{"aVeryLongColumnName", ColumnType::Float64}}),
+                 std::invalid_argument);
+    EXPECT_THROW(catalog.create(fileName, 10,
+                                {{"time", ColumnType::Float64},
+                                 {"time", ColumnType::Int64}}),
+                 std::invalid_argument);
+    // Missing input columns
+    catalog.create(fileName, 10, {{"time", ColumnType::Float64}});
+    EXPECT_THROW(annotateCatalog(catalog), std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (catalog.getFloat64Column("latitude")),
+                 std::invalid_argument);
+    for (size_t i = 1; i < CatalogFile::MAXIMUM_NUMBER_OF_COLUMNS; ++i)
+    {
+        catalog.addColumn("c" + std::to_string(i), ColumnType::Float64);
+    }
+    EXPECT_THROW(catalog.addColumn("extra", ColumnType::Float64),
+                 std::invalid_argument);
+    catalog.close();
+    // A row count whose column size overflows
+    auto setNumberOfRows = [&](const uint64_t nRows)
+    {
+        std::fstream file(fileName,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(24);
+        file.write(reinterpret_cast<const char *> (&nRows), sizeof(nRows));
+    };
+    setNumberOfRows(uint64_t {1} << 61);
+    EXPECT_THROW(catalog.open(fileName), std::runtime_error);
+    setNumberOfRows(10);
+    EXPECT_NO_THROW(catalog.open(fileName));
+    catalog.close();
+    // Truncated
+    auto size = std::filesystem::file_size(fileName);
+    std::filesystem::resize_file(fileName, size - 8);
+    EXPECT_THROW(catalog.open(fileName), std::runtime_error);
+    std::filesystem::resize_file(fileName, 100);
+    EXPECT_THROW(catalog.open(fileName), std::runtime_error);
+    // Not a catalog
+    {
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file << std::string(2048, 'x');
+    }
+    EXPECT_THROW(catalog.open(fileName), std::runtime_error);
+    EXPECT_FALSE(catalog.isOpen());
+    std::filesystem::remove(fileName);
+}
+
+}
@@ -0,0 +1,106 @@
+#include <vector>
+#include <random>
+#include "solarCalculator/dayNight.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(DayNight, SaltLakeCity)
+{
+    DayNightClassifier classifier;
+    Location location(40.77, -111.89);
+    // May 26, 2021 at 9:19:05 local time
+    EXPECT_FALSE(classifier.isNight(1622042345, location));
+    // Sunrise is at 06:01 local time (12:01 UTC)
+    EXPECT_TRUE(classifier.isNight(1622030400 + 60 - 4*60, location));
+    EXPECT_FALSE(classifier.isNight(1622030400 + 60 + 4*60, location));
+    // Sunset is at 20:48 local time (02:48 UTC the next day)
+    EXPECT_FALSE(classifier.isNight(1622083680 - 3*60, location));
+    EXPECT_TRUE(classifier.isNight(1622083680 + 3*60, location));
+    // Ten minutes after sunset it is night but civil twilight has not ended
+    EXPECT_FALSE(classifier.isNight(1622083680 + 10*60, location,
+                     DayNightClassifier::CIVIL_DEPRESSION_ANGLE));
+    EXPECT_TRUE(classifier.isNight(1622083680 + 10*60, location));
+    // Dec 4, 2019 at 18:06:26 local time
+    EXPECT_TRUE(classifier.isNight(1575507986, Observer{39.77, -109.89}));
+}
+
+TEST(DayNight, MatchesElevation)
+{
+    const size_t nRows = 20000;
+    std::mt19937 generator(1984);
+    std::uniform_real_distribution<double> timeDist(-1.e10, 1.e10);
+    std::uniform_real_distribution<double> latDist(-90, 90);
+    std::uniform_real_distribution<double> lonDist(-180, 180);
+    std::vector<double> times(nRows), latitudes(nRows), longitudes(nRows);
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        times[i] = timeDist(generator);
+        latitudes[i] = latDist(generator);
+        longitudes[i] = lonDist(generator);
+    }
+    DayNightClassifier classifier(1024);
+    for (auto depression : {DayNightClassifier::SUNRISE_DEPRESSION_ANGLE,
+                            DayNightClassifier::CIVIL_DEPRESSION_ANGLE,
+                            DayNightClassifier::ASTRONOMICAL_DEPRESSION_ANGLE})
+    {
+        std::unique_ptr<bool[]> isNight(new bool[nRows]);
+        classifier.classify(nRows, times.data(), latitudes.data(),
+                            longitudes.data(), isNight.get(), depression);
+        int nTested = 0;
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            // The classifier uses the geometric elevation whereas the
+            // elevation is refracted so skip rows near the threshold
+            auto position = computePosition(times[i], latitudes[i],
+                                            longitudes[i]);
+            if (std::abs(position.elevation + depression) < 1){continue;}
+            EXPECT_EQ(isNight[i], position.elevation < -depression)
+                << times[i] << " " << latitudes[i] << " " << longitudes[i];
+            nTested = nTested + 1;
+        }
+        EXPECT_GT(nTested, static_cast<int> (0.9*nRows));
+        // Repeat queries hit the cache and give the same answer
+        for (size_t i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(isNight[i],
+                      classifier.isNight(times[i],
+                                         Observer{latitudes[i], longitudes[i]},
+                                         depression));
+        }
+    }
+}
+
+TEST(DayNight, Polar)
+{
+    DayNightClassifier classifier;
+    // Longyearbyen: midnight sun in June and polar night in December
+    Observer svalbard{78.22, 15.65};
+    for (int hour = 0; hour < 24; ++hour)
+    {
+        EXPECT_FALSE(classifier.isNight(1624233600 + hour*3600, svalbard));
+        EXPECT_TRUE(classifier.isNight(1640044800 + hour*3600, svalbard));
+    }
+}
+
+TEST(DayNight, Errors)
+{
+    DayNightClassifier classifier;
+    EXPECT_THROW(DayNightClassifier(0), std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (classifier.isNight(32503680000.0,
+                                                       Observer{0, 0})),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (classifier.isNight(0, Observer{91, 0})),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (classifier.isNight(0, Location())),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (classifier.isNight(0, Observer{0, 0}, 91)),
+                 std::invalid_argument);
+}
+
+}
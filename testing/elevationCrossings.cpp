@@ -0,0 +1,132 @@
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "solarCalculator/elevationCrossings.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+/// Checks the intervals against the elevation sampled every minute.
+void checkIntervals(const Observer &observer,
+                    const double startTime, const double endTime,
+                    const double threshold)
+{
+    auto crossings = findElevationCrossings(observer, startTime, endTime,
+                                            threshold);
+    auto below = findElevationIntervals(observer, startTime, endTime,
+                                        threshold);
+    auto above = findElevationIntervals(observer, startTime, endTime,
+                                        threshold, ElevationRegion::Above);
+    EXPECT_TRUE(std::is_sorted(crossings.begin(), crossings.end()));
+    for (auto crossing : crossings)
+    {
+        EXPECT_GT(crossing, startTime);
+        EXPECT_LT(crossing, endTime);
+        EXPECT_NEAR(computePosition(crossing, observer).elevation,
+                    threshold, 1.e-4);
+    }
+    auto isInside = [](const std::vector<TimeInterval> &intervals,
+                       const double time)
+    {
+        for (const auto &interval : intervals)
+        {
+            if (time >= interval.start && time <= interval.end){return true;}
+        }
+        return false;
+    };
+    for (auto time = startTime; time <= endTime; time = time + 60)
+    {
+        auto nearCrossing = std::any_of(crossings.begin(), crossings.end(),
+                                        [time](const double crossing)
+                                        {
+                                            return std::abs(time - crossing) < 1;
+                                        });
+        if (nearCrossing){continue;}
+        auto isBelow = computePosition(time, observer).elevation < threshold;
+        EXPECT_EQ(isInside(below, time), isBelow)
+            << "latitude=" << observer.latitude << " time=" << time;
+        EXPECT_EQ(isInside(above, time), !isBelow)
+            << "latitude=" << observer.latitude << " time=" << time;
+    }
+}
+
+TEST(ElevationCrossings, SaltLakeCity)
+{
+    // May 26, 2021 from midnight MDT for two days.  The sun rises at
+    // about 12:01 and sets at about 02:48 UTC.
+    Observer observer{40.77, -111.89};
+    auto crossings = findElevationCrossings(observer, 1622008800,
+                                            1622008800 + 2*86400, -0.833);
+    ASSERT_EQ(crossings.size(), 4);
+    EXPECT_NEAR(crossings[0], 1622030460, 300);
+    EXPECT_NEAR(crossings[1], 1622083680, 300);
+    auto nights = findElevationIntervals(observer, 1622008800,
+                                         1622008800 + 2*86400, -0.833);
+    ASSERT_EQ(nights.size(), 3);
+    EXPECT_EQ(nights[0].start, 1622008800);
+    EXPECT_EQ(nights[0].end, crossings[0]);
+    EXPECT_EQ(nights[1].start, crossings[1]);
+    EXPECT_EQ(nights[2].end, 1622008800 + 2*86400);
+    checkIntervals(observer, 1622008800, 1622008800 + 2*86400, -6);
+    // Empty window
+    EXPECT_TRUE(findElevationCrossings(observer, 1622008800, 1622008800,
+                                       -6).empty());
+}
+
+TEST(ElevationCrossings, Polar)
+{
+    // Utqiagvik: the polar night (no intervals above the horizon), its end
+    // in late January, and the midnight sun.
+    Observer observer{71.29, -156.79};
+    auto day = findElevationIntervals(observer, 1608552000,
+                                      1608552000 + 10*86400, 0,
+                                      ElevationRegion::Above);
+    EXPECT_TRUE(day.empty());
+    checkIntervals(observer, 1608552000, 1608552000 + 10*86400, -6);
+    checkIntervals(observer, 1611100000, 1611100000 + 7*86400, 0);
+    auto night = findElevationIntervals(observer, 1593000000,
+                                        1593000000 + 5*86400, 0);
+    EXPECT_TRUE(night.empty());
+    // Near the pole the elevation barely changes during the day
+    checkIntervals(Observer{89.5, 20}, 1584400000, 1584400000 + 10*86400,
+                   0.1);
+}
+
+TEST(ElevationCrossings, Random)
+{
+    std::mt19937 generator(8675309);
+    std::uniform_real_distribution<double> timeDist(-5.e10, 3.e10);
+    std::uniform_real_distribution<double> latDist(-90, 90);
+    std::uniform_real_distribution<double> lonDist(-180, 180);
+    std::uniform_real_distribution<double> thresholdDist(-20, 20);
+    for (int i = 0; i < 20; ++i)
+    {
+        Observer observer{latDist(generator), lonDist(generator)};
+        auto startTime = timeDist(generator);
+        checkIntervals(observer, startTime, startTime + 3*86400,
+                       thresholdDist(generator));
+    }
+}
+
+TEST(ElevationCrossings, Errors)
+{
+    Observer observer{40, -111};
+    EXPECT_THROW(static_cast<void> (findElevationCrossings(observer, 10, 0, 0)),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (findElevationCrossings(observer, 0, 1.e15,
+                                                           0)),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (findElevationCrossings(Observer{91, 0}, 0,
+                                                           10, 0)),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (findElevationIntervals(observer, 0, 10,
+                                                           100)),
+                 std::invalid_argument);
+}
+
+}
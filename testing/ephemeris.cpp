@@ -0,0 +1,140 @@
+#include <vector>
+#include <thread>
+#include <memory>
+#include <cmath>
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/sun.hpp"
+#include "solarCalculator/location.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(Ephemeris, Ephemeris)
+{
+    Ephemeris ephemeris(1622042345);
+    EXPECT_NEAR(ephemeris.getTime(), 1622042345, 1.e-14);
+    EXPECT_NEAR(ephemeris.getEquationOfTime(), 2.9, 0.1);
+    EXPECT_NEAR(ephemeris.getDeclination(), 21.24, 0.01);
+    EXPECT_NEAR(ephemeris.getObliquity(), 23.44, 0.01);
+    EXPECT_NEAR(ephemeris.getJulianCentury(), 0.21399, 1.e-5);
+    EXPECT_THROW(Ephemeris(32503680000.0), std::invalid_argument);
+}
+
+TEST(Ephemeris, Cache)
+{
+    EXPECT_THROW(EphemerisCache(0), std::invalid_argument);
+    EXPECT_THROW(EphemerisCache(1, 0), std::invalid_argument);
+    EphemerisCache cache(1, 1000);
+    EXPECT_EQ(cache.getCapacity(), 1024);
+    EXPECT_NEAR(cache.getResolution(), 1, 1.e-14);
+    Ephemeris reference(1600718786);
+    for (int i = 0; i < 2; ++i)
+    {
+        auto ephemeris = cache.getEphemeris(1600718786);
+        EXPECT_NEAR(ephemeris.getDeclination(),
+                    reference.getDeclination(), 1.e-14);
+        EXPECT_NEAR(ephemeris.getEquationOfTime(),
+                    reference.getEquationOfTime(), 1.e-14);
+    }
+    // Quantized lookup
+    EphemerisCache coarseCache(60);
+    auto ephemeris = coarseCache.getEphemeris(1600718786);
+    EXPECT_NEAR(ephemeris.getTime(), 1600718760, 1.e-14);
+    EXPECT_THROW(static_cast<void> (coarseCache.getEphemeris(32503680000.0)),
+                 std::invalid_argument);
+}
+
+TEST(Ephemeris, CacheRangeLimits)
+{
+    // The nearest multiple of the resolution is outside of the range so
+    // the one inside is used
+    EphemerisCache minuteCache(60);
+    auto last = MAXIMUM_EPOCH - 20;
+    ASSERT_NO_THROW(Ephemeris reference(last));
+    auto ephemeris = minuteCache.getEphemeris(last);
+    EXPECT_NEAR(ephemeris.getTime(), MAXIMUM_EPOCH - 60, 1.e-14);
+    // With 13 s both ends round out of range
+    EphemerisCache cache(13);
+    for (auto time : {MINIMUM_EPOCH + 1, MAXIMUM_EPOCH - 1})
+    {
+        ephemeris = cache.getEphemeris(time);
+        EXPECT_TRUE(isValidTime(ephemeris.getTime()));
+        EXPECT_LT(std::abs(ephemeris.getTime() - time), 13);
+        EXPECT_NEAR(std::remainder(ephemeris.getTime(), 13), 0, 1.e-14);
+    }
+    EXPECT_THROW(static_cast<void> (cache.getEphemeris(MAXIMUM_EPOCH)),
+                 std::invalid_argument);
+    EXPECT_THROW(static_cast<void> (cache.getEphemeris(MINIMUM_EPOCH - 1)),
+                 std::invalid_argument);
+}
+
+TEST(Ephemeris, ThreadSafety)
+{
+    auto cache = std::make_shared<EphemerisCache> (1, 64);
+    const int nThreads = 4;
+    const int nTimes = 2000;
+    std::vector<int> nFailures(nThreads, 0);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < nThreads; ++thread)
+    {
+        threads.emplace_back([&, thread]()
+        {
+            for (int i = 0; i < nTimes; ++i)
+            {
+                double time = 1600000000 + 3600*(i%200);
+                auto ephemeris = cache->getEphemeris(time);
+                Ephemeris reference(time);
+                if (ephemeris.getDeclination() != reference.getDeclination() ||
+                    ephemeris.getTime() != time)
+                {
+                    nFailures[thread] = nFailures[thread] + 1;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads){thread.join();}
+    for (const auto &nFailure : nFailures){EXPECT_EQ(nFailure, 0);}
+}
+
+TEST(Ephemeris, SunAndBatch)
+{
+    auto cache = std::make_shared<EphemerisCache> ();
+    std::vector<double> latitudes{40.77, 39.77, 44, -33.9};
+    std::vector<double> longitudes{-111.89, -109.89, -110, 18.4};
+    std::vector<double> times(latitudes.size(), 1575507986);
+    for (size_t i = 0; i < latitudes.size(); ++i)
+    {
+        Location location(latitudes[i], longitudes[i]);
+        Sun sun;
+        sun.setLocation(location);
+        sun.setTime(1575507986);
+        Sun cachedSun;
+        cachedSun.setEphemerisCache(cache);
+        cachedSun.setLocation(location);
+        cachedSun.setTime(1575507986);
+        EXPECT_NEAR(sun.getElevation(), cachedSun.getElevation(), 1.e-8);
+        EXPECT_NEAR(sun.getAzimuth(), cachedSun.getAzimuth(), 1.e-8);
+        EXPECT_NEAR(sun.getDeclination(), cachedSun.getDeclination(), 1.e-8);
+        EXPECT_NEAR(sun.getEquationOfTime(),
+                    cachedSun.getEquationOfTime(), 1.e-8);
+    }
+    std::vector<double> elevations(times.size());
+    std::vector<double> cachedElevations(times.size());
+    computeSolarPositions(times.size(), times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevations.data());
+    computeSolarPositions(*cache, times.size(), times.data(),
+                          latitudes.data(), longitudes.data(),
+                          cachedElevations.data());
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        EXPECT_NEAR(elevations[i], cachedElevations[i], 1.e-8);
+    }
+}
+
+}
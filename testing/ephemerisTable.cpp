@@ -0,0 +1,155 @@
+#include <vector>
+#include <random>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include "solarCalculator/ephemerisTable.hpp"
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(EphemerisTable, Fit)
+{
+    EphemerisTable table;
+    EXPECT_FALSE(table.isInitialized());
+    EXPECT_THROW(table.initialize(-1001, 2000), std::invalid_argument);
+    EXPECT_THROW(table.initialize(2000, 3000), std::invalid_argument);
+    EXPECT_THROW(table.initialize(2001, 2000), std::invalid_argument);
+    EXPECT_THROW(table.initialize(2000, 2001, 0), std::invalid_argument);
+    EXPECT_THROW(table.initialize(2000, 2001, 86400, 1), std::invalid_argument);
+    table.initialize(-1000, -999);
+    EXPECT_EQ(table.getStartTime(), MINIMUM_EPOCH);
+    EXPECT_TRUE(table.contains(MINIMUM_EPOCH));
+    EXPECT_NO_THROW(static_cast<void> (table.getEphemeris(MINIMUM_EPOCH)));
+    table.initialize(2000, 2030);
+    EXPECT_TRUE(table.isInitialized());
+    EXPECT_NEAR(table.getStartTime(), 946684800, 1.e-6);
+    EXPECT_NEAR(table.getEndTime(), 1924992000, 1.e-6);
+    EXPECT_LT(table.getMaximumDeclinationError(), 1.e-9);
+    EXPECT_LT(table.getMaximumEquationOfTimeError(), 1.e-9);
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double>
+        timeDist(table.getStartTime(), table.getEndTime());
+    for (int i = 0; i < 10000; ++i)
+    {
+        auto time = timeDist(generator);
+        Ephemeris reference(time);
+        auto ephemeris = table.getEphemeris(time);
+        EXPECT_NEAR(ephemeris.getTime(), time, 1.e-14);
+        EXPECT_NEAR(ephemeris.getJulianCentury(),
+                    reference.getJulianCentury(), 1.e-14);
+        EXPECT_NEAR(ephemeris.getDeclination(),
+                    reference.getDeclination(), 1.e-9);
+        EXPECT_NEAR(ephemeris.getEquationOfTime(),
+                    reference.getEquationOfTime(), 1.e-9);
+        EXPECT_NEAR(ephemeris.getObliquity(),
+                    reference.getObliquity(), 1.e-9);
+    }
+    EXPECT_TRUE(table.contains(table.getStartTime()));
+    EXPECT_FALSE(table.contains(table.getEndTime()));
+    EXPECT_THROW(static_cast<void> (table.getEphemeris(table.getEndTime())),
+                 std::invalid_argument);
+    // Entire supported range
+    EphemerisTable fullTable;
+    fullTable.initialize(-1000, 2999);
+    EXPECT_LT(fullTable.getMaximumDeclinationError(), 1.e-8);
+    EXPECT_LT(fullTable.getMaximumEquationOfTimeError(), 1.e-8);
+    EXPECT_NO_THROW(static_cast<void> (fullTable.getEphemeris(32503679999.0)));
+}
+
+TEST(EphemerisTable, SaveLoad)
+{
+    EphemerisTable table;
+    EXPECT_THROW(table.save("ephemerisTable.bin"), std::runtime_error);
+    table.initialize(2015, 2025, 4*86400, 8);
+    auto fileName = std::string {"ephemerisTable.bin"};
+    table.save(fileName);
+    EphemerisTable loadedTable;
+    loadedTable.load(fileName);
+    EXPECT_TRUE(loadedTable.isInitialized());
+    EXPECT_NEAR(loadedTable.getStartTime(), table.getStartTime(), 1.e-14);
+    EXPECT_NEAR(loadedTable.getEndTime(), table.getEndTime(), 1.e-14);
+    EXPECT_EQ(loadedTable.getMaximumDeclinationError(),
+              table.getMaximumDeclinationError());
+    EXPECT_EQ(loadedTable.getMaximumEquationOfTimeError(),
+              table.getMaximumEquationOfTimeError());
+    for (double time = table.getStartTime(); time < table.getEndTime();
+         time = time + 86400*7.3)
+    {
+        auto ephemeris = table.getEphemeris(time);
+        auto loadedEphemeris = loadedTable.getEphemeris(time);
+        EXPECT_EQ(ephemeris.getDeclination(),
+                  loadedEphemeris.getDeclination());
+        EXPECT_EQ(ephemeris.getEquationOfTime(),
+                  loadedEphemeris.getEquationOfTime());
+        EXPECT_EQ(ephemeris.getObliquity(), loadedEphemeris.getObliquity());
+    }
+    // Moving keeps the mapping alive
+    EphemerisTable movedTable(std::move(loadedTable));
+    EXPECT_TRUE(movedTable.contains(1622042345));
+    // Corrupt headers whose sizes would overflow or whose segments would
+    // not cover the time range
+    auto corrupt = [&](const std::streamoff offset, const auto value)
+    {
+        table.save(fileName);
+        std::fstream file(fileName,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char *> (&value), sizeof(value));
+    };
+    EphemerisTable corruptTable;
+    corrupt(56, uint64_t {1} << 61);
+    EXPECT_THROW(corruptTable.load(fileName), std::runtime_error);
+    corrupt(48, 8*86400.0);
+    EXPECT_THROW(corruptTable.load(fileName), std::runtime_error);
+    corrupt(32, -1.e11);
+    EXPECT_THROW(corruptTable.load(fileName), std::runtime_error);
+    EXPECT_FALSE(corruptTable.isInitialized());
+    // Truncated file
+    std::filesystem::resize_file(fileName, 100);
+    EXPECT_THROW(loadedTable.load(fileName), std::runtime_error);
+    {
+    std::ofstream junk(fileName, std::ios::binary | std::ios::trunc);
+    junk << std::string(256, 'x');
+    }
+    EphemerisTable junkTable;
+    EXPECT_THROW(junkTable.load(fileName), std::runtime_error);
+    std::filesystem::remove(fileName);
+    EXPECT_THROW(junkTable.load(fileName), std::invalid_argument);
+}
+
+TEST(EphemerisTable, Batch)
+{
+    EphemerisTable table;
+    table.initialize(2020, 2022);
+    std::vector<double> times{1622042345, 1600718786, 1609459200};
+    std::vector<double> latitudes{40.77, 39.77, -33.9};
+    std::vector<double> longitudes{-111.89, -109.89, 18.4};
+    auto nRows = times.size();
+    std::vector<double> elevations(nRows), azimuths(nRows);
+    std::vector<double> elevationsRef(nRows), azimuthsRef(nRows);
+    computeSolarPositions(nRows, times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevationsRef.data(), azimuthsRef.data());
+    computeSolarPositions(table, nRows, times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevations.data(), azimuths.data());
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        EXPECT_NEAR(elevations[i], elevationsRef[i], 1.e-8);
+        EXPECT_NEAR(azimuths[i], azimuthsRef[i], 1.e-8);
+    }
+    times[1] = 1.e9;
+    EXPECT_THROW(computeSolarPositions(table, nRows, times.data(),
+                                       latitudes.data(), longitudes.data(),
+                                       elevations.data()),
+                 std::invalid_argument);
+}
+
+}
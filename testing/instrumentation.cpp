@@ -0,0 +1,99 @@
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "solarCalculator/instrumentation.hpp"
+#include "solarCalculator/sun.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/batch.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+using namespace SolarCalculator::Instrumentation;
+
+TEST(Instrumentation, Names)
+{
+    EXPECT_STREQ(toString(Counter::RiseSetSolves), "RiseSetSolves");
+    EXPECT_STREQ(toString(Counter::AlmanacRows), "AlmanacRows");
+    EXPECT_STREQ(toString(Timer::SunUpdate), "SunUpdate");
+    EXPECT_STREQ(toString(Timer::Almanac), "Almanac");
+}
+
+TEST(Instrumentation, Percentile)
+{
+    Snapshot snapshot;
+    EXPECT_EQ(snapshot.getPercentile(Timer::Batch, 50), 0);
+    auto &histogram = snapshot.histograms[static_cast<int> (Timer::Batch)];
+    histogram[3] = 90; // [8,16) ns
+    histogram[10] = 10; // [1024,2048) ns
+    EXPECT_EQ(snapshot.getNumberOfSamples(Timer::Batch), 100);
+    EXPECT_EQ(snapshot.getPercentile(Timer::Batch, 50), 16);
+    EXPECT_EQ(snapshot.getPercentile(Timer::Batch, 90), 16);
+    EXPECT_EQ(snapshot.getPercentile(Timer::Batch, 99), 2048);
+}
+
+TEST(Instrumentation, Counters)
+{
+    reset();
+    // Polar night in Utqiagvik
+    Sun sun;
+    sun.setLocation(Location(71.29, -156.79));
+    sun.setTime(1608552000);
+    auto sunrise = sun.getSunrise();
+    auto sunset = sun.getSunset();
+    auto elevation = sun.getElevation();
+    auto nextSunrise = sun.getNextSunrise();
+    EXPECT_TRUE(std::isnan(sunrise));
+    EXPECT_TRUE(std::isnan(sunset));
+    EXPECT_FALSE(std::isnan(elevation));
+    EXPECT_FALSE(std::isnan(nextSunrise));
+    // Batch rows on another thread are folded in when it exits
+    std::vector<double> times(100, 1608552000);
+    std::vector<double> latitudes(times.size(), 40);
+    std::vector<double> longitudes(times.size(), -111);
+    std::vector<double> elevations(times.size());
+    std::thread thread([&]()
+    {
+        computeSolarPositions(times.size(), times.data(), latitudes.data(),
+                              longitudes.data(), elevations.data());
+    });
+    thread.join();
+    auto snapshot = Instrumentation::snapshot();
+    if (!isEnabled())
+    {
+        for (int i = 0; i < NUMBER_OF_COUNTERS; ++i)
+        {
+            EXPECT_EQ(snapshot.counts[i], 0);
+        }
+        EXPECT_EQ(snapshot.getNumberOfSamples(Timer::SunUpdate), 0);
+        return;
+    }
+    EXPECT_EQ(snapshot.getCount(Counter::NaNResults), 1);
+    EXPECT_EQ(snapshot.getCount(Counter::RiseSetSearches), 1);
+    EXPECT_GE(snapshot.getCount(Counter::PolarJumps), 1);
+    // Each search ends with at least one solve on a day with a sunrise
+    EXPECT_GE(snapshot.getCount(Counter::RiseSetSolves), 3);
+    EXPECT_EQ(snapshot.getCount(Counter::EphemerisEvaluations), 1);
+    EXPECT_EQ(snapshot.getCount(Counter::PositionEvaluations), 1);
+    // Sunset reuses the sunrise.  The elevation computes the ephemeris
+    // within its own update so that is one miss and one sample.
+    EXPECT_EQ(snapshot.getCount(Counter::SunCacheHits), 1);
+    EXPECT_EQ(snapshot.getCount(Counter::SunCacheMisses), 2);
+    EXPECT_EQ(snapshot.getNumberOfSamples(Timer::SunUpdate), 2);
+    EXPECT_EQ(snapshot.getNumberOfSamples(Timer::RiseSetSearch), 1);
+    EXPECT_EQ(snapshot.getCount(Counter::BatchRows), times.size());
+    EXPECT_EQ(snapshot.getNumberOfSamples(Timer::Batch), 1);
+    EXPECT_GT(snapshot.getPercentile(Timer::Batch, 50), 0);
+
+    reset();
+    snapshot = Instrumentation::snapshot();
+    for (int i = 0; i < NUMBER_OF_COUNTERS; ++i)
+    {
+        EXPECT_EQ(snapshot.counts[i], 0);
+    }
+    EXPECT_EQ(snapshot.getNumberOfSamples(Timer::Batch), 0);
+}
+
+}
@@ -0,0 +1,48 @@
+#include "solarCalculator/julianDate.hpp"
+#include "solarCalculator/sun.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(JulianDate, Conversions)
+{
+    EXPECT_NEAR(toJulianDay(0), 2440587.5, 1.e-10);
+    EXPECT_NEAR(toJulianDay(J2000_EPOCH), J2000_JULIAN_DAY, 1.e-10);
+    EXPECT_NEAR(toJulianCentury(J2000_EPOCH), 0, 1.e-15);
+    // 2021-05-26 15:19:05 UTC
+    EXPECT_NEAR(toJulianDay(1622042345), 2459361.138252315, 1.e-8);
+    EXPECT_NEAR(fromJulianDay(toJulianDay(1622042345)), 1622042345, 1.e-4);
+    // -1000-01-01 and 3000-01-01
+    EXPECT_NEAR(toJulianDay(MINIMUM_EPOCH), 1355817.5, 1.e-10);
+    static_assert(daysFromCivil(-1000, 1, 1)*86400.0 == MINIMUM_EPOCH);
+    static_assert(daysFromCivil(3000, 1, 1)*86400.0 == MAXIMUM_EPOCH);
+    static_assert(daysFromCivil(1970, 1, 1) == 0);
+    static_assert(daysFromCivil(0, 3, 1) - daysFromCivil(0, 2, 28) == 2);
+    EXPECT_NEAR(toJulianDay(MAXIMUM_EPOCH), 2816787.5, 1.e-10);
+    // Fractional seconds resolve to better than a microsecond
+    auto dt = (toJulianCentury(1622042345.25) - toJulianCentury(1622042345))
+             *(86400.0*36525.0);
+    EXPECT_NEAR(dt, 0.25, 1.e-6);
+    constexpr double T = toJulianCentury(J2000_EPOCH + 86400*36525.0);
+    static_assert(T == 1.0);
+}
+
+TEST(JulianDate, Range)
+{
+    EXPECT_TRUE(isValidTime(MINIMUM_EPOCH));
+    EXPECT_FALSE(isValidTime(MINIMUM_EPOCH - 1));
+    EXPECT_TRUE(isValidTime(MAXIMUM_EPOCH - 1));
+    EXPECT_FALSE(isValidTime(MAXIMUM_EPOCH));
+    Sun sun;
+    EXPECT_NO_THROW(sun.setTime(static_cast<int64_t> (MINIMUM_EPOCH)));
+    EXPECT_NO_THROW(sun.setTime(static_cast<int64_t> (MAXIMUM_EPOCH) - 1));
+    EXPECT_THROW(sun.setTime(static_cast<int64_t> (MINIMUM_EPOCH) - 1),
+                 std::invalid_argument);
+    EXPECT_THROW(sun.setTime(static_cast<int64_t> (MAXIMUM_EPOCH)),
+                 std::invalid_argument);
+}
+
+}
@@ -0,0 +1,129 @@
+#include <vector>
+#include <random>
+#include <atomic>
+#include <stdexcept>
+#include "solarCalculator/parallelEngine.hpp"
+#include "solarCalculator/batch.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(ParallelEngine, ParallelFor)
+{
+    EXPECT_THROW(ParallelEngine(0), std::invalid_argument);
+    for (int nThreads = 1; nThreads <= 4; ++nThreads)
+    {
+        ParallelEngine engine(nThreads);
+        EXPECT_EQ(engine.getNumberOfThreads(), nThreads);
+        EXPECT_THROW(engine.setGrainSize(0), std::invalid_argument);
+        engine.setGrainSize(7);
+        EXPECT_EQ(engine.getGrainSize(), 7);
+        for (size_t nRows : {1, 6, 7, 8, 1000})
+        {
+            std::vector<std::atomic<int>> counts(nRows);
+            for (auto &count : counts){count = 0;}
+            engine.parallelFor(nRows,
+                               [&](size_t begin, size_t end, int thread)
+                               {
+                                   EXPECT_LE(end - begin, 7);
+                                   EXPECT_GE(thread, 0);
+                                   EXPECT_LT(thread, nThreads);
+                                   for (auto i = begin; i < end; ++i)
+                                   {
+                                       counts[i].fetch_add(1);
+                                   }
+                               });
+            for (const auto &count : counts){EXPECT_EQ(count.load(), 1);}
+        }
+        // Exceptions are forwarded to the caller and the engine is reusable
+        EXPECT_THROW(engine.parallelFor(100,
+                                        [](size_t begin, size_t, int)
+                                        {
+                                            if (begin == 49)
+                                            {
+                                                throw std::runtime_error("x");
+                                            }
+                                        }),
+                     std::runtime_error);
+        std::atomic<size_t> total{0};
+        engine.parallelFor(100, [&](size_t begin, size_t end, int)
+                                {
+                                    total.fetch_add(end - begin);
+                                });
+        EXPECT_EQ(total.load(), 100);
+        // Calling back into the engine throws rather than deadlocks
+        EXPECT_THROW(engine.parallelFor(100,
+                                        [&](size_t, size_t, int)
+                                        {
+                                            engine.parallelFor(1,
+                                                [](size_t, size_t, int){});
+                                        }),
+                     std::runtime_error);
+        EXPECT_THROW(engine.parallelFor(100,
+                                        [&](size_t, size_t, int)
+                                        {
+                                            engine.setGrainSize(3);
+                                        }),
+                     std::runtime_error);
+        EXPECT_EQ(engine.getGrainSize(), 7);
+    }
+    // No chunk starts after one throws
+    ParallelEngine serialEngine(1);
+    serialEngine.setGrainSize(1);
+    std::atomic<int> nChunks{0};
+    EXPECT_THROW(serialEngine.parallelFor(100,
+                                          [&](size_t, size_t, int)
+                                          {
+                                              nChunks.fetch_add(1);
+                                              throw std::runtime_error("x");
+                                          }),
+                 std::runtime_error);
+    EXPECT_EQ(nChunks.load(), 1);
+}
+
+TEST(ParallelEngine, Deterministic)
+{
+    const size_t nRows = 5000;
+    std::mt19937 generator(86);
+    std::uniform_real_distribution<double> timeDist(0, 2000000000);
+    std::uniform_real_distribution<double> latDist(-90, 90);
+    std::uniform_real_distribution<double> lonDist(-180, 180);
+    std::vector<double> times(nRows), latitudes(nRows), longitudes(nRows);
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        times[i] = timeDist(generator);
+        latitudes[i] = latDist(generator);
+        longitudes[i] = lonDist(generator);
+    }
+    std::vector<double> elevations(nRows), azimuths(nRows);
+    computeSolarPositions(nRows, times.data(),
+                          latitudes.data(), longitudes.data(),
+                          elevations.data(), azimuths.data());
+    for (int nThreads : {1, 2, 3, 8})
+    {
+        ParallelEngine engine(nThreads);
+        engine.setGrainSize(100);
+        std::vector<double> elevationsParallel(nRows, 0);
+        std::vector<double> declinationsParallel(nRows, 0);
+        engine.computeSolarPositions(nRows, times.data(),
+                                     latitudes.data(), longitudes.data(),
+                                     elevationsParallel.data(), nullptr,
+                                     declinationsParallel.data());
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            EXPECT_EQ(elevations[i], elevationsParallel[i]);
+        }
+    }
+    ParallelEngine engine(2);
+    latitudes[nRows - 1] = 91;
+    EXPECT_THROW(engine.computeSolarPositions(nRows, times.data(),
+                                              latitudes.data(),
+                                              longitudes.data(),
+                                              elevations.data()),
+                 std::invalid_argument);
+}
+
+}
@@ -0,0 +1,542 @@
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "solarCalculator/queryServer.hpp"
+#include "solarCalculator/queryClient.hpp"
+#include "solarCalculator/queryProtocol.hpp"
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/dayNight.hpp"
+#include "solarCalculator/almanac.hpp"
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+std::string makeSocketPath(const std::string &name)
+{
+    return "/tmp/solarCalculator-" + name + "-"
+         + std::to_string(::getpid()) + ".sock";
+}
+
+/// Connects a raw socket for sending hand-made frames.
+int connectRaw(const std::string &socketPath)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, socketPath.c_str());
+    auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0){return -1;}
+    if (::connect(fd, reinterpret_cast<const sockaddr *> (&address),
+                  sizeof(address)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool receiveAll(const int fd, void *data, size_t nBytes)
+{
+    auto *bytes = static_cast<char *> (data);
+    while (nBytes > 0)
+    {
+        auto n = ::recv(fd, bytes, nBytes, 0);
+        if (n <= 0){return false;}
+        bytes = bytes + n;
+        nBytes = nBytes - static_cast<size_t> (n);
+    }
+    return true;
+}
+
+struct Catalog
+{
+    Catalog(const size_t nRows, const double firstTime, const double lastTime,
+            const unsigned int seed) :
+        times(nRows),
+        latitudes(nRows),
+        longitudes(nRows)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> timeDist(firstTime, lastTime);
+        std::uniform_real_distribution<double> latDist(-90, 90);
+        std::uniform_real_distribution<double> lonDist(-180, 180);
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            times[i] = timeDist(generator);
+            latitudes[i] = latDist(generator);
+            longitudes[i] = lonDist(generator);
+        }
+    }
+    std::vector<double> times;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+};
+
+TEST(QueryServer, Positions)
+{
+    QueryServer server;
+    auto socketPath = makeSocketPath("positions");
+    EXPECT_FALSE(server.isRunning());
+    ASSERT_NO_THROW(server.start(socketPath, 2000, 2030));
+    EXPECT_TRUE(server.isRunning());
+    EXPECT_EQ(server.getSocketPath(), socketPath);
+    // 1990 through 2040 so some rows are outside of the table
+    const size_t nRows = 40000;
+    Catalog catalog(nRows, 631152000, 2208988800, 86);
+    std::vector<double> elevations(nRows), azimuths(nRows);
+    QueryClient client;
+    ASSERT_NO_THROW(client.connect(socketPath));
+    EXPECT_TRUE(client.isConnected());
+    EXPECT_NO_THROW(client.computePositions(nRows, catalog.times.data(),
+                                            catalog.latitudes.data(),
+                                            catalog.longitudes.data(),
+                                            elevations.data(),
+                                            azimuths.data()));
+    std::vector<double> elevationsRef(nRows), azimuthsRef(nRows);
+    computeSolarPositions(nRows, catalog.times.data(),
+                          catalog.latitudes.data(), catalog.longitudes.data(),
+                          elevationsRef.data(), azimuthsRef.data());
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        EXPECT_NEAR(elevations[i], elevationsRef[i], 1.e-5);
+        // The azimuth is ill-conditioned near the zenith and nadir
+        if (std::abs(elevationsRef[i]) < 89)
+        {
+            EXPECT_NEAR(azimuths[i], azimuthsRef[i], 1.e-4);
+        }
+    }
+    // A single row without an azimuth
+    double elevation = 0;
+    EXPECT_NO_THROW(client.computePositions(1, catalog.times.data(),
+                                            catalog.latitudes.data(),
+                                            catalog.longitudes.data(),
+                                            &elevation));
+    EXPECT_NEAR(elevation, elevations[0], 1.e-12);
+    EXPECT_NO_THROW(client.computePositions(0, nullptr, nullptr, nullptr,
+                                            nullptr));
+    EXPECT_EQ(server.getNumberOfRequests(), 2);
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+    EXPECT_NE(::access(socketPath.c_str(), F_OK), 0);
+}
+
+TEST(QueryServer, DayNight)
+{
+    QueryServer server;
+    auto socketPath = makeSocketPath("dayNight");
+    ASSERT_NO_THROW(server.start(socketPath, 2010, 2012));
+    const size_t nRows = 30000;
+    Catalog catalog(nRows, -1.e10, 1.e10, 1984);
+    QueryClient client;
+    ASSERT_NO_THROW(client.connect(socketPath));
+    DayNightClassifier classifier;
+    for (auto depression : {DayNightClassifier::SUNRISE_DEPRESSION_ANGLE,
+                            DayNightClassifier::CIVIL_DEPRESSION_ANGLE})
+    {
+        std::unique_ptr<bool[]> isNight(new bool[nRows]);
+        std::unique_ptr<bool[]> isNightRef(new bool[nRows]);
+        EXPECT_NO_THROW(client.classifyDayNight(nRows, catalog.times.data(),
+                                                catalog.latitudes.data(),
+                                                catalog.longitudes.data(),
+                                                isNight.get(), depression));
+        classifier.classify(nRows, catalog.times.data(),
+                            catalog.latitudes.data(),
+                            catalog.longitudes.data(),
+                            isNightRef.get(), depression);
+        for (size_t i = 0; i < nRows; ++i)
+        {
+            EXPECT_EQ(isNight[i], isNightRef[i]);
+        }
+    }
+}
+
+TEST(QueryServer, RiseSet)
+{
+    const std::vector<Observer> observers{Observer{40.77, -111.89},
+                                          Observer{71.29, -156.79},
+                                          Observer{-77.85, 166.67},
+                                          Observer{0, 179.9}};
+    StationSet stations;
+    for (const auto &observer : observers){stations.add(observer);}
+    Almanac almanac;
+    almanac.compute(stations, 2021, 2021);
+    auto nDays = almanac.getNumberOfDays();
+    const auto *days = almanac.getLocalDays();
+    // Query mid-morning of every local day at every station.  The almanac
+    // interpolates its ephemeris so agreement is to a few milliseconds.
+    std::vector<double> times, latitudes, longitudes;
+    for (const auto &observer : observers)
+    {
+        for (size_t day = 0; day < nDays; ++day)
+        {
+            times.push_back(static_cast<double> (days[day])*86400
+                          - observer.longitude/360*86400 + 36000);
+            latitudes.push_back(observer.latitude);
+            longitudes.push_back(observer.longitude);
+        }
+    }
+    auto nRows = times.size();
+    std::vector<double> sunrises(nRows), sunsets(nRows), noons(nRows);
+    QueryServer server;
+    auto socketPath = makeSocketPath("riseSet");
+    ASSERT_NO_THROW(server.start(socketPath));
+    QueryClient client;
+    ASSERT_NO_THROW(client.connect(socketPath));
+    // The second pass is answered from the cache
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        EXPECT_NO_THROW(client.computeRiseSet(nRows, times.data(),
+                                              latitudes.data(),
+                                              longitudes.data(),
+                                              sunrises.data(), sunsets.data(),
+                                              noons.data()));
+        for (size_t row = 0; row < nRows; ++row)
+        {
+            auto sunrise = almanac.getSunrises()[row];
+            auto sunset = almanac.getSunsets()[row];
+            EXPECT_EQ(std::isnan(sunrises[row]), std::isnan(sunrise));
+            EXPECT_EQ(std::isnan(sunsets[row]), std::isnan(sunset));
+            if (!std::isnan(sunrise))
+            {
+                EXPECT_NEAR(sunrises[row], sunrise, 5.e-3);
+                EXPECT_NEAR(sunsets[row], sunset, 5.e-3);
+            }
+            EXPECT_NEAR(noons[row], almanac.getSolarNoons()[row], 5.e-3);
+        }
+    }
+}
+
+TEST(QueryServer, Errors)
+{
+    QueryServer server;
+    QueryClient client;
+    auto socketPath = makeSocketPath("errors");
+    EXPECT_THROW(server.start(""), std::invalid_argument);
+    EXPECT_THROW(server.start(std::string(200, 'a')), std::invalid_argument);
+    EXPECT_THROW(server.start(socketPath, 2000, 1999), std::invalid_argument);
+    EXPECT_FALSE(server.isRunning());
+    EXPECT_THROW(static_cast<void> (server.getSocketPath()),
+                 std::runtime_error);
+    EXPECT_THROW(client.connect(std::string(200, 'a')),
+                 std::invalid_argument);
+    EXPECT_THROW(client.connect(socketPath), std::runtime_error);
+    EXPECT_FALSE(client.isConnected());
+    double time = 1622042345;
+    double latitude = 40.77;
+    double longitude = -111.89;
+    double elevation = 0;
+    EXPECT_THROW(client.computePositions(1, &time, &latitude, &longitude,
+                                         &elevation),
+                 std::runtime_error);
+
+    ASSERT_NO_THROW(server.start(socketPath));
+    EXPECT_THROW(server.start(socketPath), std::runtime_error);
+    QueryServer otherServer;
+    EXPECT_THROW(otherServer.start(socketPath), std::runtime_error);
+    ASSERT_NO_THROW(client.connect(socketPath));
+    EXPECT_THROW(client.computePositions(1, nullptr, &latitude, &longitude,
+                                         &elevation),
+                 std::invalid_argument);
+    EXPECT_THROW(client.computePositions(1, &time, &latitude, &longitude,
+                                         nullptr),
+                 std::invalid_argument);
+    double badLatitude = 91;
+    EXPECT_THROW(client.computePositions(1, &time, &badLatitude, &longitude,
+                                         &elevation),
+                 std::invalid_argument);
+    double badTime = 1.e12;
+    bool isNight = false;
+    EXPECT_THROW(client.classifyDayNight(1, &badTime, &latitude, &longitude,
+                                         &isNight),
+                 std::invalid_argument);
+    double sunrise = 0;
+    double sunset = 0;
+    EXPECT_THROW(client.computeRiseSet(1, &time, &latitude, &longitude,
+                                       &sunrise, &sunset, nullptr, 100),
+                 std::invalid_argument);
+    // Rejected requests do not close the connection
+    EXPECT_TRUE(client.isConnected());
+    EXPECT_NO_THROW(client.classifyDayNight(1, &time, &latitude, &longitude,
+                                            &isNight));
+    EXPECT_FALSE(isNight);
+    // A malformed header is answered and the connection closed
+    auto fd = connectRaw(socketPath);
+    ASSERT_GE(fd, 0);
+    QueryProtocol::RequestHeader header;
+    header.magic = 0;
+    header.id = 7;
+    ASSERT_EQ(::send(fd, &header, sizeof(header), 0),
+              static_cast<ssize_t> (sizeof(header)));
+    QueryProtocol::ResponseHeader response;
+    ASSERT_TRUE(receiveAll(fd, &response, sizeof(response)));
+    EXPECT_EQ(response.magic, QueryProtocol::MAGIC);
+    EXPECT_EQ(response.status,
+              static_cast<uint32_t> (QueryProtocol::Status::InvalidArgument));
+    std::string message(response.messageLength, '\0');
+    ASSERT_TRUE(receiveAll(fd, message.data(), message.size()));
+    char byte;
+    EXPECT_EQ(::recv(fd, &byte, 1, 0), 0);
+    ::close(fd);
+    // An unknown request type is rejected but the connection stays open
+    fd = connectRaw(socketPath);
+    ASSERT_GE(fd, 0);
+    header = QueryProtocol::RequestHeader {};
+    header.type = 42;
+    header.id = 8;
+    ASSERT_EQ(::send(fd, &header, sizeof(header), 0),
+              static_cast<ssize_t> (sizeof(header)));
+    ASSERT_TRUE(receiveAll(fd, &response, sizeof(response)));
+    EXPECT_EQ(response.id, 8);
+    EXPECT_EQ(response.status,
+              static_cast<uint32_t> (QueryProtocol::Status::InvalidArgument));
+    message.resize(response.messageLength);
+    ASSERT_TRUE(receiveAll(fd, message.data(), message.size()));
+    header.type = static_cast<uint32_t> (QueryProtocol::RequestType::Position);
+    header.id = 9;
+    ASSERT_EQ(::send(fd, &header, sizeof(header), 0),
+              static_cast<ssize_t> (sizeof(header)));
+    ASSERT_TRUE(receiveAll(fd, &response, sizeof(response)));
+    EXPECT_EQ(response.id, 9);
+    EXPECT_EQ(response.status,
+              static_cast<uint32_t> (QueryProtocol::Status::Success));
+    ::close(fd);
+    // Requests sent before the client shuts down its write side are
+    // answered before the connection is closed
+    fd = connectRaw(socketPath);
+    ASSERT_GE(fd, 0);
+    std::vector<char> frames;
+    for (uint64_t id : {10, 11})
+    {
+        header = QueryProtocol::RequestHeader {};
+        header.type
+            = static_cast<uint32_t> (QueryProtocol::RequestType::Position);
+        header.id = id;
+        header.nRows = 1;
+        QueryProtocol::Row row{time, latitude, longitude};
+        const auto *bytes = reinterpret_cast<const char *> (&header);
+        frames.insert(frames.end(), bytes, bytes + sizeof(header));
+        bytes = reinterpret_cast<const char *> (&row);
+        frames.insert(frames.end(), bytes, bytes + sizeof(row));
+    }
+    ASSERT_EQ(::send(fd, frames.data(), frames.size(), 0),
+              static_cast<ssize_t> (frames.size()));
+    ASSERT_EQ(::shutdown(fd, SHUT_WR), 0);
+    for (uint64_t id : {10, 11})
+    {
+        ASSERT_TRUE(receiveAll(fd, &response, sizeof(response)));
+        EXPECT_EQ(response.id, id);
+        EXPECT_EQ(response.status,
+                  static_cast<uint32_t> (QueryProtocol::Status::Success));
+        QueryProtocol::PositionResult result;
+        ASSERT_TRUE(receiveAll(fd, &result, sizeof(result)));
+        EXPECT_GT(result.elevation, 0);
+    }
+    EXPECT_EQ(::recv(fd, &byte, 1, 0), 0);
+    ::close(fd);
+    // Stopping closes the client's connection
+    server.stop();
+    EXPECT_THROW(client.classifyDayNight(1, &time, &latitude, &longitude,
+                                         &isNight),
+                 std::runtime_error);
+    EXPECT_FALSE(client.isConnected());
+}
+
+TEST(QueryServer, Coalescing)
+{
+    QueryServer server;
+    auto socketPath = makeSocketPath("coalescing");
+    ASSERT_NO_THROW(server.start(socketPath));
+    auto fd = connectRaw(socketPath);
+    ASSERT_GE(fd, 0);
+    // Three pipelined requests in one write are answered in one batch and
+    // in order.  The middle one is invalid and fails alone.
+    std::vector<char> frames;
+    auto addRequest = [&](const uint64_t id, const double latitude)
+    {
+        QueryProtocol::RequestHeader header;
+        header.type
+            = static_cast<uint32_t> (QueryProtocol::RequestType::Position);
+        header.id = id;
+        header.nRows = 1;
+        QueryProtocol::Row row{1622042345, latitude, -111.89};
+        const auto *bytes = reinterpret_cast<const char *> (&header);
+        frames.insert(frames.end(), bytes, bytes + sizeof(header));
+        bytes = reinterpret_cast<const char *> (&row);
+        frames.insert(frames.end(), bytes, bytes + sizeof(row));
+    };
+    addRequest(1, 40.77);
+    addRequest(2, 95);
+    addRequest(3, -40.77);
+    ASSERT_EQ(::send(fd, frames.data(), frames.size(), 0),
+              static_cast<ssize_t> (frames.size()));
+    for (uint64_t id = 1; id <= 3; ++id)
+    {
+        QueryProtocol::ResponseHeader response;
+        ASSERT_TRUE(receiveAll(fd, &response, sizeof(response)));
+        EXPECT_EQ(response.id, id);
+        if (id == 2)
+        {
+            EXPECT_EQ(response.status,
+                      static_cast<uint32_t>
+                      (QueryProtocol::Status::InvalidArgument));
+            std::string message(response.messageLength, '\0');
+            ASSERT_TRUE(receiveAll(fd, message.data(), message.size()));
+            continue;
+        }
+        EXPECT_EQ(response.status,
+                  static_cast<uint32_t> (QueryProtocol::Status::Success));
+        ASSERT_EQ(response.nRows, 1);
+        QueryProtocol::PositionResult result;
+        ASSERT_TRUE(receiveAll(fd, &result, sizeof(result)));
+        auto reference = computePosition(1622042345,
+                                         id == 1 ? 40.77 : -40.77, -111.89);
+        EXPECT_NEAR(result.elevation, reference.elevation, 1.e-5);
+        EXPECT_NEAR(result.azimuth, reference.azimuth, 1.e-4);
+    }
+    ::close(fd);
+    EXPECT_EQ(server.getNumberOfRequests(), 3);
+    EXPECT_EQ(server.getNumberOfBatches(), 1);
+}
+
+TEST(QueryServer, ConcurrentClients)
+{
+    QueryServer server;
+    auto socketPath = makeSocketPath("concurrent");
+    ASSERT_NO_THROW(server.start(socketPath));
+    constexpr int nClients = 8;
+    constexpr int nQueries = 200;
+    std::vector<int> nMismatches(nClients, 0);
+    std::vector<std::thread> threads;
+    for (int iClient = 0; iClient < nClients; ++iClient)
+    {
+        threads.emplace_back([&, iClient]()
+        {
+            QueryClient client;
+            client.connect(socketPath);
+            Catalog catalog(nQueries, 946684800, 1893456000,
+                            static_cast<unsigned int> (iClient));
+            for (int i = 0; i < nQueries; ++i)
+            {
+                double elevation = 0;
+                double azimuth = 0;
+                client.computePositions(1, &catalog.times[i],
+                                        &catalog.latitudes[i],
+                                        &catalog.longitudes[i],
+                                        &elevation, &azimuth);
+                auto reference = computePosition(catalog.times[i],
+                                                 catalog.latitudes[i],
+                                                 catalog.longitudes[i]);
+                if (std::abs(elevation - reference.elevation) > 1.e-5)
+                {
+                    nMismatches[iClient] = nMismatches[iClient] + 1;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads){thread.join();}
+    for (int iClient = 0; iClient < nClients; ++iClient)
+    {
+        EXPECT_EQ(nMismatches[iClient], 0);
+    }
+    EXPECT_EQ(server.getNumberOfRequests(),
+              static_cast<uint64_t> (nClients*nQueries));
+    EXPECT_LE(server.getNumberOfBatches(), server.getNumberOfRequests());
+}
+
+
+TEST(QueryServer, MixedLoad)
+{
+    QueryServer server;
+    auto socketPath = makeSocketPath("mixed");
+    ASSERT_NO_THROW(server.start(socketPath, 2000, 2001));
+    // A bulk request of rows outside of the table, i.e., computed exactly,
+    // must not hold up one-row queries from another client
+    const size_t nRows = 1 << 20;
+    Catalog catalog(nRows, 631152000, 946684800, 7);
+    std::atomic<bool> bulkDone{false};
+    double bulkDuration = 0;
+    std::thread bulk([&]()
+    {
+        QueryClient client;
+        client.connect(socketPath);
+        std::vector<double> elevations(nRows), azimuths(nRows);
+        auto start = std::chrono::steady_clock::now();
+        client.computePositions(nRows, catalog.times.data(),
+                                catalog.latitudes.data(),
+                                catalog.longitudes.data(),
+                                elevations.data(), azimuths.data());
+        std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        bulkDuration = elapsed.count();
+        bulkDone = true;
+    });
+    QueryClient client;
+    ASSERT_NO_THROW(client.connect(socketPath));
+    double maximumLatency = 0;
+    int nQueries = 0;
+    while (!bulkDone)
+    {
+        double elevation = 0;
+        double azimuth = 0;
+        auto start = std::chrono::steady_clock::now();
+        client.computePositions(1, &catalog.times[0], &catalog.latitudes[0],
+                                &catalog.longitudes[0], &elevation, &azimuth);
+        std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        maximumLatency = std::max(maximumLatency, elapsed.count());
+        nQueries = nQueries + 1;
+    }
+    bulk.join();
+    EXPECT_GT(nQueries, 0);
+    EXPECT_LT(maximumLatency, bulkDuration/4);
+    // A request pipelined behind a bulk one on the same connection is
+    // still answered after it
+    auto fd = connectRaw(socketPath);
+    ASSERT_GE(fd, 0);
+    std::vector<char> frames;
+    for (uint64_t id : {1, 2})
+    {
+        QueryProtocol::RequestHeader header;
+        header.type
+            = static_cast<uint32_t> (QueryProtocol::RequestType::Position);
+        header.id = id;
+        header.nRows = (id == 1) ? 40000 : 1;
+        const auto *bytes = reinterpret_cast<const char *> (&header);
+        frames.insert(frames.end(), bytes, bytes + sizeof(header));
+        for (size_t i = 0; i < header.nRows; ++i)
+        {
+            QueryProtocol::Row row{catalog.times[i], catalog.latitudes[i],
+                                   catalog.longitudes[i]};
+            bytes = reinterpret_cast<const char *> (&row);
+            frames.insert(frames.end(), bytes, bytes + sizeof(row));
+        }
+    }
+    ASSERT_EQ(::send(fd, frames.data(), frames.size(), 0),
+              static_cast<ssize_t> (frames.size()));
+    for (uint64_t id : {1, 2})
+    {
+        QueryProtocol::ResponseHeader response;
+        ASSERT_TRUE(receiveAll(fd, &response, sizeof(response)));
+        EXPECT_EQ(response.id, id);
+        EXPECT_EQ(response.status,
+                  static_cast<uint32_t> (QueryProtocol::Status::Success));
+        std::vector<QueryProtocol::PositionResult> results(response.nRows);
+        ASSERT_TRUE(receiveAll(fd, results.data(),
+                               results.size()*sizeof(results[0])));
+    }
+    ::close(fd);
+}
+
+}
@@ -0,0 +1,556 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <random>
+#include <charconv>
+#include <functional>
+#include <tuple>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/ephemerisTable.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/parallelEngine.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/sun.hpp"
+
+/// @brief Compares every engine against the reference dataset and reports
+///        the maximum and RMS error of each output and each engine's rows
+///        per second.  The exit code is nonzero if an error exceeds or a
+///        throughput falls below the engine's threshold.  The reference
+///        dataset is generated from the scalar implementation with
+///        --generate.
+
+using namespace SolarCalculator;
+
+namespace
+{
+
+/// The outputs that are compared.
+enum Output
+{
+    ELEVATION = 0,
+    AZIMUTH,
+    DECLINATION,
+    EQUATION_OF_TIME,
+    NUMBER_OF_OUTPUTS
+};
+
+constexpr std::array<const char *, NUMBER_OF_OUTPUTS> OUTPUT_NAMES
+{
+    "elevation", "azimuth", "declination", "equation_of_time"
+};
+
+struct Dataset
+{
+    std::vector<double> times;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::array<std::vector<double>, NUMBER_OF_OUTPUTS> outputs;
+    [[nodiscard]] size_t size() const noexcept{return times.size();}
+    void resize(const size_t n)
+    {
+        times.resize(n);
+        latitudes.resize(n);
+        longitudes.resize(n);
+        for (auto &output : outputs){output.resize(n);}
+    }
+};
+
+/// An engine fills the outputs for the dataset's rows.
+using Engine = std::function<void (const Dataset &reference,
+                                   Dataset *result)>;
+
+/// The largest permissible error of each output (degrees, or minutes for
+/// the equation of time) and the smallest permissible rows per second.
+/// The errors are the documented accuracies where an engine has them and
+/// otherwise a small multiple of the errors when the thresholds were set.
+/// The throughputs are about a quarter of those of a 2020s desktop core.
+struct Threshold
+{
+    std::array<double, NUMBER_OF_OUTPUTS> maximumError;
+    double minimumRowsPerSecond;
+};
+
+struct Options
+{
+    std::string referenceFile;
+    std::string generateFile;
+    double throughputScale = 1;
+    double seconds = 0.2;
+};
+
+/// @result The UTC time in seconds of January 1 of the year.
+int64_t yearToEpoch(const int64_t year)
+{
+    auto y = year - 1;
+    auto era = (y >= 0 ? y : y - 399)/400;
+    auto yoe = y - era*400;
+    auto doe = yoe*365 + yoe/4 - yoe/100 + 306; // March 1 to January 1
+    return (era*146097 + doe - 719468)*86400;
+}
+
+/// Fills the outputs with the scalar implementation.
+void computeWithSun(const Dataset &reference, Dataset *result)
+{
+    Sun sun;
+    Location location;
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        location.setLatitude(reference.latitudes[i]);
+        location.setLongitude(reference.longitudes[i]);
+        sun.setLocation(location);
+        sun.setTime(static_cast<int64_t> (reference.times[i]));
+        result->outputs[ELEVATION][i] = sun.getElevation();
+        result->outputs[AZIMUTH][i] = sun.getAzimuth();
+        result->outputs[DECLINATION][i] = sun.getDeclination();
+        result->outputs[EQUATION_OF_TIME][i] = sun.getEquationOfTime();
+    }
+}
+
+/// The dataset is stratified so that every 50 years of [-1000,2999] and
+/// every 10 degrees of latitude, including the poles, is sampled three
+/// times with the hours of the day cycled.  The first and last seconds of
+/// the years are appended.
+Dataset generateDataset()
+{
+    Dataset dataset;
+    std::mt19937 generator(20240229);
+    std::uniform_int_distribution<int64_t> dayDist(0, 364);
+    std::uniform_int_distribution<int64_t> secondDist(0, 3599);
+    std::uniform_real_distribution<double> lonDist(-180, 180);
+    int64_t hour = 0;
+    for (int64_t year = -1000; year < 3000; year = year + 50)
+    {
+        for (int latitude = -90; latitude <= 90; latitude = latitude + 10)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                auto time = yearToEpoch(year) + 86400*dayDist(generator)
+                          + 3600*hour + secondDist(generator);
+                hour = (hour + 7)%24;
+                dataset.times.push_back(static_cast<double> (time));
+                dataset.latitudes.push_back(latitude);
+                dataset.longitudes.push_back(
+                    std::round(lonDist(generator)*1.e4)/1.e4);
+            }
+        }
+    }
+    for (auto time : {yearToEpoch(-1000), yearToEpoch(3000) - 1})
+    {
+        dataset.times.push_back(static_cast<double> (time));
+        dataset.latitudes.push_back(40.77);
+        dataset.longitudes.push_back(-111.89);
+    }
+    auto n = dataset.times.size();
+    for (auto &output : dataset.outputs){output.resize(n);}
+    computeWithSun(dataset, &dataset);
+    return dataset;
+}
+
+void appendDouble(std::string &text, const double value)
+{
+    char buffer[64];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    text.append(buffer, ptr);
+}
+
+void writeDataset(const std::string &fileName, const Dataset &dataset)
+{
+    std::string text;
+    text.append("# Solar positions from the scalar implementation (Sun), a\n"
+                "# port of the NOAA solar calculator.  Regenerate with\n"
+                "# regressionHarness --generate FILE.  Times are UTC seconds\n"
+                "# from the epoch, angles are degrees, and the equation of\n"
+                "# time is minutes.\n");
+    text.append("time,latitude,longitude");
+    for (auto name : OUTPUT_NAMES)
+    {
+        text.push_back(',');
+        text.append(name);
+    }
+    text.push_back('\n');
+    for (size_t i = 0; i < dataset.size(); ++i)
+    {
+        appendDouble(text, dataset.times[i]);
+        text.push_back(',');
+        appendDouble(text, dataset.latitudes[i]);
+        text.push_back(',');
+        appendDouble(text, dataset.longitudes[i]);
+        for (const auto &output : dataset.outputs)
+        {
+            text.push_back(',');
+            appendDouble(text, output[i]);
+        }
+        text.push_back('\n');
+    }
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::invalid_argument("Failed to open " + fileName);
+    }
+    file << text;
+    if (!file.good())
+    {
+        throw std::runtime_error("Failed to write " + fileName);
+    }
+}
+
+/// Reads the CSV written by writeDataset().
+Dataset readDataset(const std::string &fileName)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open())
+    {
+        throw std::invalid_argument("Failed to open " + fileName);
+    }
+    Dataset dataset;
+    std::string line;
+    int lineNumber = 0;
+    bool haveHeader = false;
+    while (std::getline(file, line))
+    {
+        lineNumber = lineNumber + 1;
+        if (!line.empty() && line.back() == '\r'){line.pop_back();}
+        if (line.empty() || line[0] == '#'){continue;}
+        if (!haveHeader)
+        {
+            haveHeader = true;
+            continue;
+        }
+        std::array<double, 3 + NUMBER_OF_OUTPUTS> values;
+        std::string_view view(line);
+        size_t nValues = 0;
+        while (nValues < values.size())
+        {
+            auto comma = view.find(',');
+            auto field = view.substr(0, comma);
+            auto [ptr, ec] = std::from_chars(field.data(),
+                                             field.data() + field.size(),
+                                             values[nValues]);
+            if (ec != std::errc() || ptr != field.data() + field.size())
+            {
+                break;
+            }
+            nValues = nValues + 1;
+            if (comma == std::string_view::npos){break;}
+            view.remove_prefix(comma + 1);
+        }
+        if (nValues != values.size())
+        {
+            throw std::invalid_argument("Invalid row on line "
+                                      + std::to_string(lineNumber));
+        }
+        dataset.times.push_back(values[0]);
+        dataset.latitudes.push_back(values[1]);
+        dataset.longitudes.push_back(values[2]);
+        for (size_t k = 0; k < NUMBER_OF_OUTPUTS; ++k)
+        {
+            dataset.outputs[k].push_back(values[3 + k]);
+        }
+    }
+    if (dataset.size() == 0)
+    {
+        throw std::invalid_argument("No rows in " + fileName);
+    }
+    return dataset;
+}
+
+/// @result The engines, their names, and their thresholds.
+std::vector<std::tuple<std::string, Engine, Threshold>>
+    makeEngines(const EphemerisTable &table, ParallelEngine &parallelEngine)
+{
+    std::vector<std::tuple<std::string, Engine, Threshold>> engines;
+    engines.emplace_back("sun", computeWithSun,
+                         Threshold{{1.e-12, 1.e-12, 1.e-12, 1.e-12}, 8.e4});
+    engines.emplace_back("computePosition",
+        [](const Dataset &input, Dataset *result)
+        {
+            for (size_t i = 0; i < input.size(); ++i)
+            {
+                auto position
+                    = computePosition(input.times[i],
+                                      Observer{input.latitudes[i],
+                                               input.longitudes[i]});
+                result->outputs[ELEVATION][i] = position.elevation;
+                result->outputs[AZIMUTH][i] = position.azimuth;
+                result->outputs[DECLINATION][i] = position.declination;
+                result->outputs[EQUATION_OF_TIME][i]
+                    = position.equationOfTime;
+            }
+        },
+        Threshold{{1.e-10, 1.e-8, 1.e-12, 1.e-10}, 8.e4});
+    auto batch = [](const Accuracy accuracy)
+    {
+        return [accuracy](const Dataset &input, Dataset *result)
+        {
+            computeSolarPositions(accuracy, input.size(), input.times.data(),
+                                  input.latitudes.data(),
+                                  input.longitudes.data(),
+                                  result->outputs[ELEVATION].data(),
+                                  result->outputs[AZIMUTH].data(),
+                                  result->outputs[DECLINATION].data(),
+                                  result->outputs[EQUATION_OF_TIME].data());
+        };
+    };
+    engines.emplace_back("batch", batch(Accuracy::Exact),
+                         Threshold{{1.e-10, 1.e-8, 1.e-12, 1.e-10}, 4.e5});
+    engines.emplace_back("batchFast", batch(Accuracy::Fast),
+                         Threshold{{5.e-6, 1.e-3, 2.e-6, 1.e-8}, 1.2e6});
+    engines.emplace_back("batchFloat",
+        [](const Dataset &input, Dataset *result)
+        {
+            auto n = input.size();
+            std::vector<float> latitudes(input.latitudes.begin(),
+                                         input.latitudes.end());
+            std::vector<float> longitudes(input.longitudes.begin(),
+                                          input.longitudes.end());
+            std::array<std::vector<float>, NUMBER_OF_OUTPUTS> outputs;
+            for (auto &output : outputs){output.resize(n);}
+            computeSolarPositionsFloat(n, input.times.data(),
+                                       latitudes.data(), longitudes.data(),
+                                       outputs[ELEVATION].data(),
+                                       outputs[AZIMUTH].data(),
+                                       outputs[DECLINATION].data(),
+                                       outputs[EQUATION_OF_TIME].data());
+            for (size_t k = 0; k < NUMBER_OF_OUTPUTS; ++k)
+            {
+                std::copy(outputs[k].begin(), outputs[k].end(),
+                          result->outputs[k].begin());
+            }
+        },
+        Threshold{{2.e-3, 0.5, 5.e-5, 5.e-5}, 6.e5});
+    engines.emplace_back("batchTable",
+        [&table](const Dataset &input, Dataset *result)
+        {
+            computeSolarPositions(table, input.size(), input.times.data(),
+                                  input.latitudes.data(),
+                                  input.longitudes.data(),
+                                  result->outputs[ELEVATION].data(),
+                                  result->outputs[AZIMUTH].data(),
+                                  result->outputs[DECLINATION].data(),
+                                  result->outputs[EQUATION_OF_TIME].data());
+        },
+        Threshold{{1.e-8, 1.e-7, 1.e-8, 1.e-8}, 1.e6});
+    engines.emplace_back("parallel",
+        [&parallelEngine](const Dataset &input, Dataset *result)
+        {
+            parallelEngine.computeSolarPositions(
+                input.size(), input.times.data(),
+                input.latitudes.data(), input.longitudes.data(),
+                result->outputs[ELEVATION].data(),
+                result->outputs[AZIMUTH].data(),
+                result->outputs[DECLINATION].data(),
+                result->outputs[EQUATION_OF_TIME].data());
+        },
+        Threshold{{1.e-10, 1.e-8, 1.e-12, 1.e-10}, 4.e5});
+    return engines;
+}
+
+/// @result The absolute difference.  Azimuths are compared on the circle.
+double computeError(const size_t output,
+                    const double value, const double referenceValue)
+{
+    auto error = std::abs(value - referenceValue);
+    if (output == AZIMUTH){error = std::min(error, 360 - error);}
+    return std::isnan(error) ? HUGE_VAL : error;
+}
+
+void printUsage()
+{
+    std::cout << "Usage: regressionHarness [options] reference.csv\n\n"
+              << "Compares each engine to the reference dataset and reports\n"
+              << "the maximum and RMS error of each output and the rows per\n"
+              << "second.  The exit code is nonzero if an error or a\n"
+              << "throughput is worse than the engine's threshold.\n\n"
+              << "Options:\n"
+              << "  --generate FILE         Write the reference dataset from\n"
+              << "                          the scalar implementation to FILE\n"
+              << "                          and exit\n"
+              << "  --seconds S             Minimum timing duration per engine\n"
+              << "                          (default: 0.2)\n"
+              << "  --throughput-scale X    Multiply the throughput thresholds\n"
+              << "                          by X, e.g., for slow machines\n"
+              << "                          (default: 1)\n"
+              << "  --no-throughput         Do not check the throughput\n"
+              << "  -h, --help              Print this message\n";
+}
+
+Options parseCommandLine(int argc, char *argv[])
+{
+    Options options;
+    auto getValue = [&](int &i) -> std::string
+    {
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument(std::string {argv[i]}
+                                      + " requires a value");
+        }
+        i = i + 1;
+        return argv[i];
+    };
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument(argv[i]);
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            std::exit(EXIT_SUCCESS);
+        }
+        else if (argument == "--generate")
+        {
+            options.generateFile = getValue(i);
+        }
+        else if (argument == "--seconds")
+        {
+            options.seconds = std::stod(getValue(i));
+            if (!(options.seconds > 0))
+            {
+                throw std::invalid_argument("Seconds must be positive");
+            }
+        }
+        else if (argument == "--throughput-scale")
+        {
+            options.throughputScale = std::stod(getValue(i));
+            if (!(options.throughputScale >= 0))
+            {
+                throw std::invalid_argument(
+                    "Throughput scale cannot be negative");
+            }
+        }
+        else if (argument == "--no-throughput")
+        {
+            options.throughputScale = 0;
+        }
+        else if (!argument.empty() && argument[0] == '-')
+        {
+            throw std::invalid_argument("Unknown option " + argument);
+        }
+        else if (options.referenceFile.empty())
+        {
+            options.referenceFile = argument;
+        }
+        else
+        {
+            throw std::invalid_argument("Only one reference file is allowed");
+        }
+    }
+    if (options.generateFile.empty() && options.referenceFile.empty())
+    {
+        throw std::invalid_argument("Reference file not specified");
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    try
+    {
+        options = parseCommandLine(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (!options.generateFile.empty())
+    {
+        try
+        {
+            writeDataset(options.generateFile, generateDataset());
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    Dataset reference;
+    EphemerisTable table;
+    ParallelEngine parallelEngine;
+    try
+    {
+        reference = readDataset(options.referenceFile);
+        table.initialize(-1000, 2999);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto n = reference.size();
+    std::cout << "Reference rows: " << n << "\n\n";
+    std::printf("%-16s %-17s %12s %12s %12s\n",
+                "engine", "output", "max_error", "rms_error", "threshold");
+    bool passed = true;
+    std::vector<std::tuple<std::string, double, double>> throughputs;
+    for (auto &[name, engine, threshold] :
+         makeEngines(table, parallelEngine))
+    {
+        Dataset result;
+        result.resize(n);
+        try
+        {
+            engine(reference, &result);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << name << " failed: " << e.what() << std::endl;
+            passed = false;
+            continue;
+        }
+        for (size_t k = 0; k < NUMBER_OF_OUTPUTS; ++k)
+        {
+            double maximumError = 0;
+            double sumSquares = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto error = computeError(k, result.outputs[k][i],
+                                          reference.outputs[k][i]);
+                maximumError = std::max(maximumError, error);
+                sumSquares = sumSquares + error*error;
+            }
+            auto ok = (maximumError <= threshold.maximumError[k]);
+            passed = passed && ok;
+            std::printf("%-16s %-17s %12.3e %12.3e %12.3e%s\n",
+                        name.c_str(), OUTPUT_NAMES[k], maximumError,
+                        std::sqrt(sumSquares/static_cast<double> (n)),
+                        threshold.maximumError[k], ok ? "" : "  FAILED");
+        }
+        // Time whole passes over the dataset
+        size_t nPasses = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        while (elapsed < options.seconds)
+        {
+            engine(reference, &result);
+            nPasses = nPasses + 1;
+            elapsed = std::chrono::duration<double>
+                      (std::chrono::steady_clock::now() - start).count();
+        }
+        auto rowsPerSecond = static_cast<double> (nPasses*n)/elapsed;
+        auto minimum = threshold.minimumRowsPerSecond*options.throughputScale;
+        passed = passed && (rowsPerSecond >= minimum);
+        throughputs.emplace_back(name, rowsPerSecond, minimum);
+    }
+    std::printf("\n%-16s %16s %16s\n", "engine", "rows_per_second",
+                "threshold");
+    for (const auto &[name, rowsPerSecond, minimum] : throughputs)
+    {
+        std::printf("%-16s %16.0f %16.0f%s\n", name.c_str(), rowsPerSecond,
+                    minimum, rowsPerSecond >= minimum ? "" : "  FAILED");
+    }
+    std::cout << (passed ? "\nPASSED" : "\nFAILED") << std::endl;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,112 @@
+#include <cmath>
+#include <type_traits>
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/sun.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+static_assert(std::is_trivially_copyable<Observer>::value);
+static_assert(std::is_trivially_copyable<SolarPosition>::value);
+static_assert(std::is_trivially_copyable<Ephemeris>::value);
+
+TEST(SolarPosition, ComputePosition)
+{
+    // May 26, 2021 at 9:19:05 local time
+    auto position = computePosition(1622042345, 40.77, -111.89);
+    EXPECT_NEAR(position.elevation, 35.09, 0.01);
+    EXPECT_NEAR(position.azimuth, 91.2, 0.1);
+    EXPECT_NEAR(position.equationOfTime, 2.9, 0.1);
+    EXPECT_NEAR(position.declination, 21.24, 0.01);
+    // Observer overload with an un-normalized longitude
+    auto positionObserver = computePosition(1622042345,
+                                            Observer{40.77, -111.89 + 720});
+    EXPECT_NEAR(positionObserver.elevation, position.elevation, 1.e-10);
+    EXPECT_NEAR(positionObserver.azimuth, position.azimuth, 1.e-10);
+    // Ephemeris overload
+    Ephemeris ephemeris(1622042345);
+    auto positionEphemeris = computePosition(1622042345, ephemeris,
+                                             Observer{40.77, -111.89});
+    EXPECT_NEAR(positionEphemeris.elevation, position.elevation, 1.e-14);
+    EXPECT_NEAR(positionEphemeris.azimuth, position.azimuth, 1.e-14);
+    EXPECT_NEAR(positionEphemeris.declination, position.declination, 1.e-14);
+}
+
+TEST(SolarPosition, Accuracy)
+{
+    Observer observer{40.77, -111.89};
+    auto position = computePosition(1622042345, observer);
+    auto exact = computePosition(1622042345, observer, Accuracy::Exact);
+    EXPECT_EQ(exact.elevation, position.elevation);
+    EXPECT_EQ(exact.azimuth, position.azimuth);
+    EXPECT_EQ(exact.declination, position.declination);
+    EXPECT_EQ(exact.equationOfTime, position.equationOfTime);
+    auto fast = computePosition(1622042345, observer, Accuracy::Fast);
+    EXPECT_NEAR(fast.elevation, position.elevation, 5.e-6);
+    EXPECT_NEAR(fast.azimuth, position.azimuth, 1.e-4);
+    EXPECT_NEAR(fast.declination, position.declination, 2.e-6);
+    EXPECT_NEAR(fast.equationOfTime, position.equationOfTime, 1.e-8);
+    EXPECT_TRUE(std::isnan(computePosition(1.e15, observer,
+                                           Accuracy::Fast).elevation));
+    EXPECT_TRUE(std::isnan(computePosition(1622042345, Observer{91, 0},
+                                           Accuracy::Fast).elevation));
+}
+
+TEST(SolarPosition, InvalidInputs)
+{
+    auto position = computePosition(32503680000.0, 40, -111);
+    EXPECT_TRUE(std::isnan(position.elevation));
+    EXPECT_TRUE(std::isnan(position.azimuth));
+    EXPECT_TRUE(std::isnan(position.declination));
+    EXPECT_TRUE(std::isnan(position.equationOfTime));
+    position = computePosition(1622042345, Observer{91, 0});
+    EXPECT_TRUE(std::isnan(position.elevation));
+    position = computePosition(1622042345, Ephemeris(1622042345),
+                               Observer{std::nan(""), 0});
+    EXPECT_TRUE(std::isnan(position.elevation));
+}
+
+TEST(SolarPosition, Location)
+{
+    Location location(Observer{39.77, -109.89});
+    auto observer = location.getObserver();
+    EXPECT_NEAR(observer.latitude, 39.77, 1.e-14);
+    EXPECT_NEAR(observer.longitude, -109.89 + 360, 1.e-10);
+    EXPECT_THROW(Location(Observer{-91, 0}), std::invalid_argument);
+    Location empty;
+    EXPECT_THROW(static_cast<void> (empty.getObserver()), std::runtime_error);
+    // Sun wraps the value API
+    Sun sun;
+    sun.setLocation(location);
+    sun.setTime(1575507986);
+    auto position = computePosition(1575507986, observer);
+    EXPECT_NEAR(sun.getElevation(), position.elevation, 1.e-14);
+    EXPECT_NEAR(sun.getAzimuth(), position.azimuth, 1.e-14);
+    EXPECT_NEAR(sun.getDeclination(), position.declination, 1.e-14);
+    EXPECT_NEAR(sun.getEquationOfTime(), position.equationOfTime, 1.e-14);
+}
+
+
+TEST(SolarPosition, SubsolarPoint)
+{
+    for (const double time : {1622042345.0, 1575507986.0, -9.e10, 3.2e10})
+    {
+        auto subsolar = computeSubsolarPoint(time);
+        EXPECT_GE(subsolar.longitude, -180);
+        EXPECT_LT(subsolar.longitude, 180);
+        auto position = computePosition(time, subsolar);
+        EXPECT_NEAR(position.declination, subsolar.latitude, 1.e-12);
+        EXPECT_NEAR(position.elevation, 90, 1.e-5);
+        // The antipode sees the sun at the nadir
+        Observer antipode{-subsolar.latitude, subsolar.longitude + 180};
+        EXPECT_NEAR(computePosition(time, antipode).elevation, -90, 1.e-5);
+    }
+    EXPECT_TRUE(std::isnan(computeSubsolarPoint(1.e15).latitude));
+}
+
+}
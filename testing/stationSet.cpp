@@ -0,0 +1,111 @@
+#include <vector>
+#include <cmath>
+#include "solarCalculator/stationSet.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/ephemeris.hpp"
+#include "solarCalculator/batch.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(StationSet, Registry)
+{
+    StationSet stations;
+    EXPECT_EQ(stations.size(), 0);
+    EXPECT_EQ(stations.add(Observer{40.77, -111.89}, "UU.CTU"), 0);
+    EXPECT_EQ(stations.add(Location(39.77, -109.89)), 1);
+    EXPECT_EQ(stations.add(Observer{-33.9, 378.4}, "quarry"), 2);
+    EXPECT_THROW(stations.add(Observer{10, 10}, "UU.CTU"),
+                 std::invalid_argument);
+    EXPECT_THROW(stations.add(Observer{91, 10}), std::invalid_argument);
+    EXPECT_THROW(stations.add(Observer{10, 540}), std::invalid_argument);
+    EXPECT_THROW(stations.add(Location()), std::invalid_argument);
+    EXPECT_EQ(stations.size(), 3);
+    EXPECT_EQ(stations.getIndex("quarry"), 2);
+    EXPECT_TRUE(stations.haveSite("UU.CTU"));
+    EXPECT_FALSE(stations.haveSite("UU.NOPE"));
+    EXPECT_THROW(static_cast<void> (stations.getIndex("UU.NOPE")),
+                 std::invalid_argument);
+    EXPECT_EQ(stations.getName(0), "UU.CTU");
+    EXPECT_TRUE(stations.getName(1).empty());
+    const auto &site = stations.getSite(2);
+    EXPECT_NEAR(site.latitude, -33.9, 1.e-14);
+    EXPECT_NEAR(site.longitude, 18.4, 1.e-12);
+    EXPECT_NEAR(site.sinLatitude, std::sin(-33.9*M_PI/180), 1.e-15);
+    EXPECT_NEAR(site.cosLatitude, std::cos(-33.9*M_PI/180), 1.e-15);
+    EXPECT_NEAR(stations.getSite(0).longitude, 360 - 111.89, 1.e-12);
+    auto cosLat = std::cos(-33.9*M_PI/180);
+    EXPECT_NEAR(stations.getUnitVectorsX()[2],
+                cosLat*std::cos(18.4*M_PI/180), 1.e-14);
+    EXPECT_NEAR(stations.getUnitVectorsY()[2],
+                cosLat*std::sin(18.4*M_PI/180), 1.e-14);
+    EXPECT_NEAR(stations.getUnitVectorsZ()[2], std::sin(-33.9*M_PI/180),
+                1.e-15);
+    EXPECT_THROW(static_cast<void> (stations.getSite(3)),
+                 std::invalid_argument);
+    StationSet copy(stations);
+    stations.clear();
+    EXPECT_EQ(stations.size(), 0);
+    EXPECT_FALSE(stations.haveSite("UU.CTU"));
+    EXPECT_EQ(copy.size(), 3);
+    EXPECT_EQ(copy.getIndex("UU.CTU"), 0);
+}
+
+TEST(StationSet, Solvers)
+{
+    std::vector<Observer> observers{Observer{40.77, -111.89},
+                                    Observer{39.77, -109.89},
+                                    Observer{-33.9, 18.4},
+                                    Observer{89.99, 0}};
+    StationSet stations;
+    for (const auto &observer : observers){stations.add(observer);}
+    std::vector<double> times;
+    std::vector<size_t> sites;
+    for (int i = 0; i < 1000; ++i)
+    {
+        times.push_back(1600718786 + 3671.0*i);
+        sites.push_back(static_cast<size_t> (i)%observers.size());
+    }
+    auto nRows = times.size();
+    std::vector<double> elevations(nRows), azimuths(nRows);
+    std::vector<double> declinations(nRows), equationsOfTime(nRows);
+    computeSolarPositions(stations, nRows, times.data(), sites.data(),
+                          elevations.data(), azimuths.data(),
+                          declinations.data(), equationsOfTime.data());
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        auto reference = computePosition(times[i], observers[sites[i]]);
+        auto position = computePosition(times[i], stations, sites[i]);
+        EXPECT_NEAR(position.elevation, reference.elevation, 1.e-9);
+        EXPECT_NEAR(position.azimuth, reference.azimuth, 1.e-7);
+        EXPECT_NEAR(position.declination, reference.declination, 1.e-12);
+        EXPECT_NEAR(position.equationOfTime,
+                    reference.equationOfTime, 1.e-12);
+        EXPECT_NEAR(elevations[i], reference.elevation, 1.e-9);
+        EXPECT_NEAR(azimuths[i], reference.azimuth, 1.e-7);
+        EXPECT_NEAR(declinations[i], reference.declination, 1.e-9);
+        EXPECT_NEAR(equationsOfTime[i], reference.equationOfTime, 1.e-9);
+        Ephemeris ephemeris(times[i]);
+        auto fromEphemeris
+            = computePosition(times[i], ephemeris, stations, sites[i]);
+        EXPECT_NEAR(fromEphemeris.elevation, position.elevation, 1.e-12);
+        EXPECT_NEAR(fromEphemeris.azimuth, position.azimuth, 1.e-12);
+    }
+    // Bad inputs
+    EXPECT_TRUE(std::isnan(computePosition(times[0], stations, 4).elevation));
+    EXPECT_TRUE(std::isnan(
+        computePosition(32503680000.0, stations, 0).elevation));
+    sites[3] = 4;
+    EXPECT_THROW(computeSolarPositions(stations, nRows, times.data(),
+                                       sites.data(), elevations.data()),
+                 std::invalid_argument);
+    EXPECT_THROW(computeSolarPositions(stations, nRows, times.data(),
+                                       nullptr, elevations.data()),
+                 std::invalid_argument);
+}
+
+}
@@ -1,3 +1,8 @@
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <thread>
 #include <iostream>
 #include "solarCalculator/sun.hpp"
 #include "solarCalculator/location.hpp"
@@ -8,6 +13,23 @@ namespace
 
 using namespace SolarCalculator;
 
+/// Steps one day at a time until the sun rises (or sets).
+double bruteForceCrossing(const Location &location, const int64_t time,
+                          const bool rise, const bool next)
+{
+    Sun sun;
+    sun.setLocation(location);
+    for (int day = 0; day < 800; ++day)
+    {
+        sun.setTime(next ? time + 86400*day : time - 86400*day);
+        auto crossing = rise ? sun.getSunrise() : sun.getSunset();
+        if (std::isnan(crossing)){continue;}
+        if (next && crossing > static_cast<double> (time)){return crossing;}
+        if (!next && crossing < static_cast<double> (time)){return crossing;}
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
 TEST(Sun, Time)
 {
     Sun sun;
@@ -74,6 +96,200 @@ TEST(Sun, Calculate)
     // Sunset: Local time: 16:55
 }
 
+TEST(Sun, LazyEvaluation)
+{
+    // Results must not depend on the order in which the time, location,
+    // and getters are called.
+    Location location(40.77, -111.89);
+    Sun reference;
+    reference.setLocation(location);
+    reference.setTime(1622042345);
+    auto elevation = reference.getElevation();
+    auto azimuth = reference.getAzimuth();
+    auto equationOfTime = reference.getEquationOfTime();
+    auto declination = reference.getDeclination();
+
+    Sun sun;
+    sun.setTime(1600718786);
+    sun.setLocation(Location(39.77, -109.89));
+    EXPECT_NEAR(sun.getDeclination(), 0.28, 0.01);
+    sun.setTime(1622042345);
+    EXPECT_NEAR(sun.getDeclination(), declination, 1.e-12);
+    EXPECT_NEAR(sun.getEquationOfTime(), equationOfTime, 1.e-12);
+    sun.setLocation(location);
+    EXPECT_NEAR(sun.getAzimuth(), azimuth, 1.e-12);
+    EXPECT_NEAR(sun.getElevation(), elevation, 1.e-12);
+
+    // Copies carry the cached state
+    Sun copy(sun);
+    EXPECT_NEAR(copy.getElevation(), elevation, 1.e-12);
+    EXPECT_NEAR(copy.getDeclination(), declination, 1.e-12);
+}
+
+TEST(Sun, ConcurrentReaders)
+{
+    // Readers of one const Sun race to fill the same cache entries.  Run
+    // this in a -DENABLE_THREAD_SANITIZER=ON build to check for races.
+    Location location(40.77, -111.89);
+    Sun reference;
+    reference.setLocation(location);
+    reference.setTime(1622042345);
+    std::vector<double> expected{reference.getElevation(),
+                                 reference.getAzimuth(),
+                                 reference.getDeclination(),
+                                 reference.getEquationOfTime(),
+                                 reference.getSunrise(),
+                                 reference.getSunset(),
+                                 reference.getSolarNoon()};
+    constexpr int nThreads = 4;
+    for (int trial = 0; trial < 20; ++trial)
+    {
+        Sun sun;
+        sun.setLocation(location);
+        sun.setTime(1622042345);
+        const Sun &shared = sun;
+        std::vector<std::vector<double>> results(nThreads);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < nThreads; ++i)
+        {
+            threads.emplace_back([&shared, &result = results[i], i]()
+            {
+                // Start on different getters so the misses overlap
+                if (i%2 == 1){static_cast<void> (shared.getSunrise());}
+                result = {shared.getElevation(),
+                          shared.getAzimuth(),
+                          shared.getDeclination(),
+                          shared.getEquationOfTime(),
+                          shared.getSunrise(),
+                          shared.getSunset(),
+                          shared.getSolarNoon()};
+            });
+        }
+        for (auto &thread : threads){thread.join();}
+        for (const auto &result : results){EXPECT_EQ(result, expected);}
+    }
+}
+
+TEST(Sun, RiseSet)
+{
+    // Salt Lake City on 2021-05-26: sunrise 6:01, sunset 20:48 MDT
+    Sun sun;
+    sun.setLocation(Location(40.77, -111.89));
+    sun.setTime(1622042345);
+    EXPECT_NEAR(sun.getSunrise(), 1622030460, 90);
+    EXPECT_NEAR(sun.getSunset(),  1622083680, 90);
+    EXPECT_LT(sun.getSunrise(), sun.getSolarNoon());
+    EXPECT_LT(sun.getSolarNoon(), sun.getSunset());
+    // 2019-12-04: sunrise 7:24, solar noon 12:09:46, sunset 16:55 MST
+    sun.setLocation(Location(39.77, -109.89));
+    sun.setTime(1575507986);
+    EXPECT_NEAR(sun.getSunrise(),   1575469440, 90);
+    EXPECT_NEAR(sun.getSolarNoon(), 1575486586, 30);
+    EXPECT_NEAR(sun.getSunset(),    1575503700, 90);
+    // 2015-01-04: Sunrise 7:55, solar noon 12:24:58, sunset 16:55 MST.
+    // The time precedes sunrise but is on the same local day.
+    sun.setLocation(Location(44, -110));
+    sun.setTime(1420378385);
+    EXPECT_NEAR(sun.getSunrise(),   1420383300, 90);
+    EXPECT_NEAR(sun.getSolarNoon(), 1420399498, 30);
+    EXPECT_NEAR(sun.getSunset(),    1420415700, 90);
+    // Polar night in Utqiagvik on 2020-12-21
+    sun.setLocation(Location(71.29, -156.79));
+    sun.setTime(1608552000);
+    EXPECT_TRUE(std::isnan(sun.getSunrise()));
+    EXPECT_TRUE(std::isnan(sun.getSunset()));
+    EXPECT_FALSE(std::isnan(sun.getSolarNoon()));
+    // Not set
+    Sun empty;
+    EXPECT_THROW(static_cast<void> (empty.getSunrise()), std::runtime_error);
+}
+
 
+TEST(Sun, NextPreviousRiseSet)
+{
+    // Salt Lake City before sunrise on 2021-05-26
+    Sun sun;
+    sun.setLocation(Location(40.77, -111.89));
+    sun.setTime(1622020000);
+    EXPECT_NEAR(sun.getNextSunrise(), sun.getSunrise(), 1.e-6);
+    EXPECT_NEAR(sun.getNextSunset(), sun.getSunset(), 1.e-6);
+    EXPECT_LT(sun.getPreviousSunrise(), 1622020000);
+    EXPECT_GT(sun.getPreviousSunrise(), 1622020000 - 86400);
+    // Utqiagvik: the polar night ends in late January and began in
+    // mid-November.  The midnight sun ends in early August.
+    // Antarctic sites and near-pole sites where the sun goes directly from
+    // never setting to never rising.
+    const std::vector<std::pair<Location, int64_t>> cases
+    {
+        {Location(71.29, -156.79), 1608552000}, // 2020-12-21
+        {Location(71.29, -156.79), 1593000000}, // 2020-06-24
+        {Location(-77.85, 166.67), 1593000000}, // McMurdo
+        {Location(-77.85, 166.67), 1608552000},
+        {Location(78.22, 15.65),   1583020800}, // Svalbard 2020-03-01
+        {Location(89.2, 30),       1584000000}, // Near the pole
+        {Location(-89.5, 0),       1600000000},
+        {Location(89.9, 0),        1584000000},
+        {Location(-89.95, 0),      1600000000},
+        {Location(0, 0),           1600000000},
+        {Location(66.6, 25.7),     1608552000}  // Just inside the circle
+    };
+    for (const auto &c : cases)
+    {
+        sun.setLocation(c.first);
+        sun.setTime(c.second);
+        for (const bool rise : {true, false})
+        {
+            for (const bool next : {true, false})
+            {
+                double crossing = 0;
+                if (rise)
+                {
+                    crossing = next ? sun.getNextSunrise() :
+                                      sun.getPreviousSunrise();
+                }
+                else
+                {
+                    crossing = next ? sun.getNextSunset() :
+                                      sun.getPreviousSunset();
+                }
+                auto reference = bruteForceCrossing(c.first, c.second,
+                                                    rise, next);
+                // Within ~0.1 degrees of the pole the sun can go directly
+                // from never rising to never setting, so no day has a
+                // sunrise.  The crossing is then when the declination is
+                // latitude -/+ 90.833 degrees (rise) or +/-89.167 degrees
+                // less the latitude (set) in the north/south.
+                auto latitude = c.first.getLatitude();
+                if (std::abs(latitude) > 89.8 &&
+                    (std::isnan(reference) ||
+                     (next ? crossing < reference : crossing > reference)))
+                {
+                    Sun flip;
+                    flip.setLocation(c.first);
+                    flip.setTime(static_cast<int64_t> (crossing));
+                    EXPECT_TRUE(std::isnan(flip.getSunrise()));
+                    auto north = (latitude > 0);
+                    auto threshold = rise ?
+                        (north ? latitude - 90.833 : latitude + 90.833) :
+                        (north ? 89.167 - latitude : -89.167 - latitude);
+                    EXPECT_NEAR(flip.getDeclination(), threshold, 1.e-3);
+                    continue;
+                }
+                EXPECT_NEAR(crossing, reference, 1.e-3)
+                    << "latitude=" << c.first.getLatitude()
+                    << " rise=" << rise << " next=" << next;
+            }
+        }
+    }
+    // Utqiagvik's polar night runs from about Nov 18 to Jan 23
+    sun.setLocation(Location(71.29, -156.79));
+    sun.setTime(1608552000);
+    EXPECT_NEAR(sun.getNextSunrise(),      1611400000, 3*86400);
+    EXPECT_NEAR(sun.getPreviousSunset(),   1605700000, 3*86400);
+    // Not set
+    Sun empty;
+    EXPECT_THROW(static_cast<void> (empty.getNextSunrise()),
+                 std::runtime_error);
 }
 
+}
@@ -0,0 +1,99 @@
+#include <vector>
+#include <cmath>
+#include "solarCalculator/traceGenerator.hpp"
+#include "solarCalculator/location.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace SolarCalculator;
+
+TEST(TraceGenerator, Initialize)
+{
+    TraceGenerator generator;
+    EXPECT_FALSE(generator.isInitialized());
+    std::vector<double> elevations(10);
+    EXPECT_THROW(generator.generate(elevations.size(), elevations.data()),
+                 std::runtime_error);
+    Location location(40.77, -111.89);
+    EXPECT_THROW(generator.initialize(Location(), 1622042345, 1),
+                 std::invalid_argument);
+    EXPECT_THROW(generator.initialize(location, 32503680000.0, 1),
+                 std::invalid_argument);
+    EXPECT_THROW(generator.initialize(location, 1622042345, 0),
+                 std::invalid_argument);
+    EXPECT_THROW(generator.initialize(location, 1622042345, 1, 0),
+                 std::invalid_argument);
+    generator.initialize(location, 1622042345, 0.5);
+    EXPECT_TRUE(generator.isInitialized());
+    EXPECT_NEAR(generator.getSamplingPeriod(), 0.5, 1.e-14);
+    EXPECT_NEAR(generator.getNextTime(), 1622042345, 1.e-14);
+    EXPECT_THROW(generator.generate(1, nullptr), std::invalid_argument);
+    generator.generate(elevations.size(), elevations.data());
+    EXPECT_NEAR(generator.getNextTime(), 1622042350, 1.e-14);
+    // Cannot run past the end of the supported time range
+    generator.initialize(location, 32503680000.0 - 10, 1);
+    EXPECT_THROW(generator.generate(11, elevations.data()),
+                 std::invalid_argument);
+}
+
+TEST(TraceGenerator, Accuracy)
+{
+    // Several days at a mid-latitude station, a southern station, and a
+    // polar station.  The trace is generated in uneven chunks.
+    for (const auto &observer : {Observer{40.77, -111.89},
+                                 Observer{-33.9, 18.4},
+                                 Observer{78.2, 15.6}})
+    {
+    for (const double samplingPeriod : {1.0, 10.0, 60.0, 7200.0})
+    {
+        double startTime = 1600718786;
+        size_t nSamples = static_cast<size_t> (5*86400/samplingPeriod);
+        std::vector<double> elevations(nSamples);
+        std::vector<double> azimuths(nSamples);
+        TraceGenerator generator;
+        generator.initialize(Location(observer), startTime, samplingPeriod);
+        size_t i = 0;
+        size_t chunk = 1;
+        while (i < nSamples)
+        {
+            auto n = std::min(chunk, nSamples - i);
+            generator.generate(n, elevations.data() + i, azimuths.data() + i);
+            i = i + n;
+            chunk = 3*chunk + 1;
+        }
+        // Generating in one go gives the same trace
+        std::vector<double> elevations1(nSamples);
+        generator.initialize(Location(observer), startTime, samplingPeriod);
+        generator.generate(nSamples, elevations1.data());
+        EXPECT_EQ(elevations, elevations1);
+        double maxElevationError = 0;
+        double maxAzimuthError = 0;
+        for (i = 0; i < nSamples; i = i + 1)
+        {
+            auto time = startTime + static_cast<double> (i)*samplingPeriod;
+            auto reference = computePosition(time, observer);
+            maxElevationError
+                = std::max(maxElevationError,
+                           std::abs(elevations[i] - reference.elevation));
+            auto dAzimuth = std::abs(azimuths[i] - reference.azimuth);
+            dAzimuth = std::min(dAzimuth, 360 - dAzimuth);
+            // The arccosine defining the azimuth is poorly conditioned
+            // near the zenith and the meridian
+            auto southNorth = std::min(std::abs(reference.azimuth - 180),
+                                       std::min(reference.azimuth,
+                                                360 - reference.azimuth));
+            if (reference.elevation < 85 && southNorth > 1)
+            {
+                maxAzimuthError = std::max(maxAzimuthError, dAzimuth);
+            }
+        }
+        EXPECT_LT(maxElevationError, 1.e-4);
+        EXPECT_LT(maxAzimuthError, 1.e-3);
+    }
+    }
+}
+
+}
@@ -0,0 +1,372 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include "solarCalculator/almanac.hpp"
+#include "solarCalculator/catalogFile.hpp"
+#include "solarCalculator/parallelEngine.hpp"
+#include "solarCalculator/solarPosition.hpp"
+#include "solarCalculator/stationSet.hpp"
+
+/// @brief Tabulates the sunrise, sunset, solar noon, and day length at each
+///        station of a station list for every day of a range of years.
+///        The tables are written as CSV or as a columnar catalog file.
+
+using namespace SolarCalculator;
+
+namespace
+{
+
+struct Options
+{
+    std::string stationFile;
+    std::string outputFile;
+    std::string catalogFile;
+    int firstYear = 0;
+    int lastYear = 0;
+    int nThreads = 0;
+    bool haveFirstYear = false;
+    bool haveLastYear = false;
+};
+
+/// @result The civil date (year, month, day) of the days since the epoch.
+void dayToDate(const int64_t days, int64_t *year, int *month, int *day)
+{
+    auto z = days + 719468;
+    auto era = (z >= 0 ? z : z - 146096)/146097;
+    auto doe = z - era*146097;
+    auto yoe = (doe - doe/1460 + doe/36524 - doe/146096)/365;
+    auto doy = doe - (365*yoe + yoe/4 - yoe/100);
+    auto mp = (5*doy + 2)/153;
+    *day = static_cast<int> (doy - (153*mp + 2)/5 + 1);
+    *month = static_cast<int> (mp < 10 ? mp + 3 : mp - 9);
+    *year = yoe + era*400 + (*month <= 2 ? 1 : 0);
+}
+
+bool parseDouble(std::string_view field, double *value)
+{
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t'))
+    {
+        field.remove_prefix(1);
+    }
+    while (!field.empty() &&
+           (field.back() == ' ' || field.back() == '\t' ||
+            field.back() == '\r'))
+    {
+        field.remove_suffix(1);
+    }
+    auto [ptr, ec] = std::from_chars(field.data(),
+                                     field.data() + field.size(), *value);
+    return ec == std::errc() && ptr == field.data() + field.size() &&
+           !field.empty();
+}
+
+/// Reads name,latitude,longitude lines.  Blank lines, comments (#), and a
+/// header line are skipped.
+std::vector<std::string> readStations(const std::string &fileName,
+                                      StationSet *stations)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open())
+    {
+        throw std::invalid_argument("Failed to open " + fileName);
+    }
+    std::vector<std::string> names;
+    std::string line;
+    int lineNumber = 0;
+    bool firstLine = true;
+    while (std::getline(file, line))
+    {
+        lineNumber = lineNumber + 1;
+        if (line.empty() || line == "\r" || line[0] == '#'){continue;}
+        auto first = line.find(',');
+        auto second = (first == std::string::npos) ?
+                      std::string::npos : line.find(',', first + 1);
+        double latitude = 0;
+        double longitude = 0;
+        bool valid = (second != std::string::npos);
+        if (valid)
+        {
+            std::string_view view(line);
+            auto third = line.find(',', second + 1);
+            valid = parseDouble(view.substr(first + 1, second - first - 1),
+                                &latitude) &&
+                    parseDouble(view.substr(second + 1, third - second - 1),
+                                &longitude);
+        }
+        if (!valid && firstLine)
+        {
+            firstLine = false;
+            continue; // Header
+        }
+        firstLine = false;
+        if (!valid)
+        {
+            throw std::invalid_argument("Invalid station on line "
+                                      + std::to_string(lineNumber));
+        }
+        auto name = line.substr(0, first);
+        try
+        {
+            stations->add(Observer{latitude, longitude});
+        }
+        catch (const std::exception &e)
+        {
+            throw std::invalid_argument("Line " + std::to_string(lineNumber)
+                                      + ": " + e.what());
+        }
+        names.push_back(name);
+    }
+    if (stations->size() == 0)
+    {
+        throw std::invalid_argument("No stations in " + fileName);
+    }
+    return names;
+}
+
+void appendDouble(std::string &output, const double value)
+{
+    if (std::isnan(value)){return;}
+    char buffer[64];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                   std::chars_format::fixed, 3);
+    output.append(buffer, ptr);
+}
+
+/// Writes one line per station and day.
+bool writeCSV(std::FILE *output, const Almanac &almanac,
+              const std::vector<std::string> &names)
+{
+    const auto *days = almanac.getLocalDays();
+    const auto *sunrises = almanac.getSunrises();
+    const auto *sunsets = almanac.getSunsets();
+    const auto *noons = almanac.getSolarNoons();
+    const auto *dayLengths = almanac.getDayLengths();
+    auto nDays = almanac.getNumberOfDays();
+    std::string text{"station,date,sunrise,sunset,solar_noon,day_length\n"};
+    for (size_t site = 0; site < almanac.getNumberOfSites(); ++site)
+    {
+        for (size_t day = 0; day < nDays; ++day)
+        {
+            auto row = site*nDays + day;
+            int64_t year = 0;
+            int month = 0;
+            int dayOfMonth = 0;
+            dayToDate(days[day], &year, &month, &dayOfMonth);
+            char date[32];
+            std::snprintf(date, sizeof(date), "%lld-%02d-%02d",
+                          static_cast<long long> (year), month, dayOfMonth);
+            text.append(names[site]);
+            text.push_back(',');
+            text.append(date);
+            text.push_back(',');
+            appendDouble(text, sunrises[row]);
+            text.push_back(',');
+            appendDouble(text, sunsets[row]);
+            text.push_back(',');
+            appendDouble(text, noons[row]);
+            text.push_back(',');
+            appendDouble(text, dayLengths[row]);
+            text.push_back('\n');
+        }
+        if (std::fwrite(text.data(), 1, text.size(), output) != text.size())
+        {
+            return false;
+        }
+        text.clear();
+    }
+    return true;
+}
+
+/// Writes the columns to a catalog file.
+void writeCatalog(const std::string &fileName, const Almanac &almanac)
+{
+    auto nDays = almanac.getNumberOfDays();
+    auto nRows = almanac.getNumberOfRows();
+    CatalogFile catalog;
+    catalog.create(fileName, nRows,
+                   {{"site", ColumnType::Int64},
+                    {"day", ColumnType::Int64},
+                    {"sunrise", ColumnType::Float64},
+                    {"sunset", ColumnType::Float64},
+                    {"solarNoon", ColumnType::Float64},
+                    {"dayLength", ColumnType::Float64}});
+    auto *sites = catalog.getMutableInt64Column("site");
+    auto *days = catalog.getMutableInt64Column("day");
+    for (size_t row = 0; row < nRows; ++row)
+    {
+        sites[row] = static_cast<int64_t> (row/nDays);
+        days[row] = almanac.getLocalDays()[row%nDays];
+    }
+    std::memcpy(catalog.getMutableFloat64Column("sunrise"),
+                almanac.getSunrises(), nRows*sizeof(double));
+    std::memcpy(catalog.getMutableFloat64Column("sunset"),
+                almanac.getSunsets(), nRows*sizeof(double));
+    std::memcpy(catalog.getMutableFloat64Column("solarNoon"),
+                almanac.getSolarNoons(), nRows*sizeof(double));
+    std::memcpy(catalog.getMutableFloat64Column("dayLength"),
+                almanac.getDayLengths(), nRows*sizeof(double));
+    catalog.close();
+}
+
+void printUsage()
+{
+    std::cout << "Usage: solarCalculator-almanac [options] stations.csv\n\n"
+              << "Tabulates the sunrise, sunset, solar noon (UTC seconds from\n"
+              << "the epoch), and day length (seconds) on each local day of\n"
+              << "the years at every station.  Each line of the station file\n"
+              << "is name,latitude,longitude in degrees.  Sunrise and sunset\n"
+              << "are empty when the sun does not rise or set.\n\n"
+              << "Options:\n"
+              << "  --first-year Y          First year (required)\n"
+              << "  --last-year Y           Last year (default: first year)\n"
+              << "  -o, --output FILE       Write CSV to FILE instead of stdout\n"
+              << "  --catalog FILE          Write a columnar catalog file with\n"
+              << "                          the columns site, day, sunrise,\n"
+              << "                          sunset, solarNoon, and dayLength\n"
+              << "                          instead of CSV\n"
+              << "  --threads N             Compute threads (default: all)\n"
+              << "  -h, --help              Print this message\n";
+}
+
+Options parseCommandLine(int argc, char *argv[])
+{
+    Options options;
+    auto getValue = [&](int &i) -> std::string
+    {
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument(std::string {argv[i]}
+                                      + " requires a value");
+        }
+        i = i + 1;
+        return argv[i];
+    };
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument(argv[i]);
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            std::exit(EXIT_SUCCESS);
+        }
+        else if (argument == "-o" || argument == "--output")
+        {
+            options.outputFile = getValue(i);
+        }
+        else if (argument == "--catalog")
+        {
+            options.catalogFile = getValue(i);
+        }
+        else if (argument == "--first-year")
+        {
+            options.firstYear = std::stoi(getValue(i));
+            options.haveFirstYear = true;
+        }
+        else if (argument == "--last-year")
+        {
+            options.lastYear = std::stoi(getValue(i));
+            options.haveLastYear = true;
+        }
+        else if (argument == "--threads")
+        {
+            options.nThreads = std::stoi(getValue(i));
+            if (options.nThreads < 1)
+            {
+                throw std::invalid_argument("Threads must be positive");
+            }
+        }
+        else if (!argument.empty() && argument[0] == '-')
+        {
+            throw std::invalid_argument("Unknown option " + argument);
+        }
+        else if (options.stationFile.empty())
+        {
+            options.stationFile = argument;
+        }
+        else
+        {
+            throw std::invalid_argument("Only one station file is allowed");
+        }
+    }
+    if (options.stationFile.empty())
+    {
+        throw std::invalid_argument("Station file not specified");
+    }
+    if (!options.haveFirstYear)
+    {
+        throw std::invalid_argument("First year not specified");
+    }
+    if (!options.haveLastYear){options.lastYear = options.firstYear;}
+    if (!options.catalogFile.empty() && !options.outputFile.empty())
+    {
+        throw std::invalid_argument("Specify only one of --output and --catalog");
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    try
+    {
+        options = parseCommandLine(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    StationSet stations;
+    Almanac almanac;
+    std::vector<std::string> names;
+    try
+    {
+        names = readStations(options.stationFile, &stations);
+        auto engine = options.nThreads > 0 ?
+                      std::make_unique<ParallelEngine> (options.nThreads) :
+                      std::make_unique<ParallelEngine> ();
+        engine->setGrainSize(256);
+        almanac.compute(stations, options.firstYear, options.lastYear,
+                        *engine);
+        if (!options.catalogFile.empty())
+        {
+            writeCatalog(options.catalogFile, almanac);
+            return EXIT_SUCCESS;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::FILE *output = stdout;
+    if (!options.outputFile.empty())
+    {
+        output = std::fopen(options.outputFile.c_str(), "wb");
+        if (output == nullptr)
+        {
+            std::cerr << "Failed to open " << options.outputFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    bool writeFailed = !writeCSV(output, almanac, names);
+    writeFailed = (std::fflush(output) != 0) || writeFailed;
+    if (output != stdout){writeFailed = (std::fclose(output) != 0) || writeFailed;}
+    if (writeFailed)
+    {
+        std::cerr << "Failed to write output" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
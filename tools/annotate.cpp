@@ -0,0 +1,609 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <semaphore>
+#include <optional>
+#include <charconv>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "solarCalculator/batch.hpp"
+#include "solarCalculator/dayNight.hpp"
+#include "solarCalculator/julianDate.hpp"
+#include "solarCalculator/parallelEngine.hpp"
+
+/// @brief Reads a CSV catalog of (time, latitude, longitude) rows and
+///        appends the solar elevation, azimuth, and a day/night flag to
+///        each row.  Reading, parsing, computing, formatting, and writing
+///        are pipelined stages connected by bounded queues so memory use
+///        does not depend on the size of the catalog.
+
+using namespace SolarCalculator;
+
+namespace
+{
+
+/// Bytes read per batch
+constexpr size_t READ_SIZE = 1 << 20;
+/// Batches buffered between stages
+constexpr std::ptrdiff_t QUEUE_CAPACITY = 4;
+
+struct Options
+{
+    std::string inputFile;
+    std::string outputFile;
+    double depressionAngle = DayNightClassifier::SUNRISE_DEPRESSION_ANGLE;
+    size_t timeColumn = 0;
+    size_t latitudeColumn = 1;
+    size_t longitudeColumn = 2;
+    int nThreads = 0;
+    char delimiter = ',';
+};
+
+/// Marks a batch without a header line
+constexpr size_t NO_HEADER = static_cast<size_t> (-1);
+
+/// A block of complete lines and the values derived from them.
+struct Batch
+{
+    std::string text;
+    /// Line i is text[lineStart[i], lineStart[i+1]) less the new line
+    std::vector<size_t> lineStart;
+    std::vector<double> times;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<double> elevations;
+    std::vector<double> azimuths;
+    std::unique_ptr<bool[]> isNight;
+    std::vector<char> isValid;
+    std::string output;
+    /// The index of the header line or NO_HEADER
+    size_t headerLine = NO_HEADER;
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return lineStart.empty() ? 0 : lineStart.size() - 1;
+    }
+    [[nodiscard]] std::string_view line(const size_t i) const noexcept
+    {
+        auto i0 = lineStart[i];
+        auto i1 = lineStart[i + 1];
+        while (i1 > i0 && (text[i1 - 1] == '\n' || text[i1 - 1] == '\r'))
+        {
+            i1 = i1 - 1;
+        }
+        return std::string_view(text.data() + i0, i1 - i0);
+    }
+};
+
+/// A single-producer, single-consumer bounded FIFO.  An empty optional
+/// marks the end of the stream.
+template<typename T>
+class BoundedQueue
+{
+public:
+    void push(std::optional<T> &&item)
+    {
+        mSlots.acquire();
+        {
+        std::scoped_lock lock(mMutex);
+        mItems.push_back(std::move(item));
+        }
+        mAvailable.release();
+    }
+    std::optional<T> pop()
+    {
+        mAvailable.acquire();
+        std::optional<T> item;
+        {
+        std::scoped_lock lock(mMutex);
+        item = std::move(mItems.front());
+        mItems.pop_front();
+        }
+        mSlots.release();
+        return item;
+    }
+private:
+    std::mutex mMutex;
+    std::deque<std::optional<T>> mItems;
+    std::counting_semaphore<QUEUE_CAPACITY> mSlots{QUEUE_CAPACITY};
+    std::counting_semaphore<QUEUE_CAPACITY> mAvailable{0};
+};
+
+using Queue = BoundedQueue<std::unique_ptr<Batch>>;
+
+/// The first error raised by a pipeline stage.  Once set every stage
+/// discards its remaining batches so the pipeline drains and the threads
+/// can be joined.
+class PipelineError
+{
+public:
+    void set(const std::string &message)
+    {
+        std::scoped_lock lock(mMutex);
+        if (!mFailed){mMessage = message;}
+        mFailed = true;
+    }
+    [[nodiscard]] bool failed() const
+    {
+        std::scoped_lock lock(mMutex);
+        return mFailed;
+    }
+    [[nodiscard]] std::string getMessage() const
+    {
+        std::scoped_lock lock(mMutex);
+        return mMessage;
+    }
+private:
+    mutable std::mutex mMutex;
+    std::string mMessage;
+    bool mFailed = false;
+};
+
+/// @result The field'th field in the line.
+std::string_view getField(std::string_view line, size_t field,
+                          const char delimiter)
+{
+    while (field > 0)
+    {
+        auto position = line.find(delimiter);
+        if (position == std::string_view::npos){return {};}
+        line.remove_prefix(position + 1);
+        field = field - 1;
+    }
+    auto position = line.find(delimiter);
+    if (position != std::string_view::npos){line = line.substr(0, position);}
+    while (!line.empty() && line.front() == ' '){line.remove_prefix(1);}
+    while (!line.empty() && line.back() == ' '){line.remove_suffix(1);}
+    return line;
+}
+
+bool toDouble(std::string_view field, double *value)
+{
+    if (!field.empty() && field.front() == '+'){field.remove_prefix(1);}
+    auto [ptr, ec] = std::from_chars(field.data(),
+                                     field.data() + field.size(), *value);
+    return ec == std::errc() && ptr == field.data() + field.size() &&
+           !field.empty();
+}
+
+void appendDouble(std::string &output, const double value)
+{
+    char buffer[64];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                   std::chars_format::fixed, 6);
+    output.append(buffer, ptr);
+}
+
+/// Reads the input in large blocks and splits it into complete lines.
+void readLines(std::FILE *input, Queue &queue, PipelineError &error)
+{
+    std::string remainder;
+    while (!error.failed())
+    {
+        auto batch = std::make_unique<Batch> ();
+        batch->text = std::move(remainder);
+        remainder.clear();
+        auto offset = batch->text.size();
+        batch->text.resize(offset + READ_SIZE);
+        auto nRead = std::fread(batch->text.data() + offset, 1, READ_SIZE,
+                                input);
+        batch->text.resize(offset + nRead);
+        bool done = (nRead < READ_SIZE);
+        if (!done)
+        {
+            // Carry the partial last line into the next batch
+            auto lastNewLine = batch->text.rfind('\n');
+            if (lastNewLine == std::string::npos)
+            {
+                remainder = std::move(batch->text);
+                continue;
+            }
+            remainder = batch->text.substr(lastNewLine + 1);
+            batch->text.resize(lastNewLine + 1);
+        }
+        size_t i0 = 0;
+        while (i0 < batch->text.size())
+        {
+            batch->lineStart.push_back(i0);
+            auto i1 = batch->text.find('\n', i0);
+            i0 = (i1 == std::string::npos) ? batch->text.size() : i1 + 1;
+        }
+        batch->lineStart.push_back(batch->text.size());
+        if (batch->size() > 0){queue.push(std::move(batch));}
+        if (done)
+        {
+            if (std::ferror(input)){error.set("Failed to read input");}
+            break;
+        }
+    }
+    queue.push(std::nullopt);
+}
+
+/// Extracts the time, latitude, and longitude from each line.
+void parseLines(const Options &options, Queue &input, Queue &output,
+                PipelineError &error)
+{
+    // Only the first non-empty line may be a header
+    bool lookingForHeader = true;
+    while (auto item = input.pop())
+    {
+        if (error.failed()){continue;}
+        auto &batch = *item.value();
+        try
+        {
+            auto nRows = batch.size();
+            batch.times.resize(nRows);
+            batch.latitudes.resize(nRows);
+            batch.longitudes.resize(nRows);
+            batch.isValid.resize(nRows);
+            for (size_t i = 0; i < nRows; ++i)
+            {
+                auto line = batch.line(i);
+                double time, latitude, longitude;
+                bool valid
+                    = toDouble(getField(line, options.timeColumn,
+                                        options.delimiter), &time)
+                   && toDouble(getField(line, options.latitudeColumn,
+                                        options.delimiter), &latitude)
+                   && toDouble(getField(line, options.longitudeColumn,
+                                        options.delimiter), &longitude)
+                   && isValidTime(time)
+                   && latitude >= -90 && latitude <= 90
+                   && longitude >= -540 && longitude < 540;
+                if (lookingForHeader && !line.empty())
+                {
+                    if (!valid){batch.headerLine = i;}
+                    lookingForHeader = false;
+                }
+                batch.isValid[i] = valid;
+                batch.times[i] = valid ? time : 0;
+                batch.latitudes[i] = valid ? latitude : 0;
+                batch.longitudes[i] = valid ? longitude : 0;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            error.set(e.what());
+            continue;
+        }
+        output.push(std::move(item));
+    }
+    output.push(std::nullopt);
+}
+
+/// Computes the solar position and day/night flag for the valid rows.
+void computeLines(const Options &options,
+                  ParallelEngine &engine,
+                  const DayNightClassifier &classifier,
+                  Queue &input, Queue &output,
+                  PipelineError &error)
+{
+    while (auto item = input.pop())
+    {
+        if (error.failed()){continue;}
+        auto &batch = *item.value();
+        try
+        {
+            auto nRows = batch.size();
+            // Invalid rows were zeroed so they are harmless to compute
+            batch.elevations.resize(nRows);
+            batch.azimuths.resize(nRows);
+            batch.isNight = std::make_unique<bool[]> (nRows);
+            engine.parallelFor(nRows,
+                               [&](const size_t i0, const size_t i1, int)
+            {
+                auto n = i1 - i0;
+                computeSolarPositions(n, batch.times.data() + i0,
+                                      batch.latitudes.data() + i0,
+                                      batch.longitudes.data() + i0,
+                                      batch.elevations.data() + i0,
+                                      batch.azimuths.data() + i0);
+                classifier.classify(n, batch.times.data() + i0,
+                                    batch.latitudes.data() + i0,
+                                    batch.longitudes.data() + i0,
+                                    batch.isNight.get() + i0,
+                                    options.depressionAngle);
+            });
+        }
+        catch (const std::exception &e)
+        {
+            error.set(e.what());
+            continue;
+        }
+        output.push(std::move(item));
+    }
+    output.push(std::nullopt);
+}
+
+/// Appends the computed columns to each line.
+void formatLines(const Options &options, Queue &input, Queue &output,
+                 PipelineError &error)
+{
+    const char delimiter = options.delimiter;
+    while (auto item = input.pop())
+    {
+        if (error.failed()){continue;}
+        auto &batch = *item.value();
+        try
+        {
+            auto nRows = batch.size();
+            batch.output.clear();
+            batch.output.reserve(batch.text.size() + 32*nRows);
+            for (size_t i = 0; i < nRows; ++i)
+            {
+                // Blank lines pass through
+                if (batch.line(i).empty())
+                {
+                    batch.output.push_back('\n');
+                    continue;
+                }
+                batch.output.append(batch.line(i));
+                batch.output.push_back(delimiter);
+                if (i == batch.headerLine)
+                {
+                    batch.output.append("elevation");
+                    batch.output.push_back(delimiter);
+                    batch.output.append("azimuth");
+                    batch.output.push_back(delimiter);
+                    batch.output.append("is_night");
+                }
+                else if (batch.isValid[i])
+                {
+                    appendDouble(batch.output, batch.elevations[i]);
+                    batch.output.push_back(delimiter);
+                    appendDouble(batch.output, batch.azimuths[i]);
+                    batch.output.push_back(delimiter);
+                    batch.output.push_back(batch.isNight[i] ? '1' : '0');
+                }
+                else
+                {
+                    batch.output.push_back(delimiter);
+                    batch.output.push_back(delimiter);
+                }
+                batch.output.push_back('\n');
+            }
+        }
+        catch (const std::exception &e)
+        {
+            error.set(e.what());
+            continue;
+        }
+        output.push(std::move(item));
+    }
+    output.push(std::nullopt);
+}
+
+/// Writes the annotated lines.
+void writeLines(std::FILE *outputFile, Queue &input, size_t *nInvalid,
+                PipelineError &error)
+{
+    *nInvalid = 0;
+    while (auto item = input.pop())
+    {
+        if (error.failed()){continue;}
+        auto &batch = *item.value();
+        auto nWritten = std::fwrite(batch.output.data(), 1,
+                                    batch.output.size(), outputFile);
+        if (nWritten != batch.output.size() || std::ferror(outputFile))
+        {
+            error.set("Failed to write output");
+            continue;
+        }
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            if (!batch.isValid[i] && i != batch.headerLine &&
+                !batch.line(i).empty())
+            {
+                *nInvalid = *nInvalid + 1;
+            }
+        }
+    }
+}
+
+void printUsage()
+{
+    std::cout << "Usage: solarCalculator-annotate [options] [input.csv]\n\n"
+              << "Appends the solar elevation and azimuth in degrees and a\n"
+              << "day/night flag (1 is night) to each row of a catalog.\n"
+              << "The catalog is read from the input file or stdin.\n"
+              << "Rows that cannot be parsed are written with empty values.\n\n"
+              << "Options:\n"
+              << "  -o, --output FILE       Write to FILE instead of stdout\n"
+              << "  --time-column N         Column of the UTC epoch time (default 0)\n"
+              << "  --latitude-column N     Column of the latitude (default 1)\n"
+              << "  --longitude-column N    Column of the longitude (default 2)\n"
+              << "  --delimiter C           Field delimiter (default ,)\n"
+              << "  --depression-angle DEG  Night begins when the sun is this far\n"
+              << "                          below the horizon (default 0.833)\n"
+              << "  --threads N             Compute threads (default: all)\n"
+              << "  -h, --help              Print this message\n";
+}
+
+/// @result The non-negative integer in the string.
+size_t toIndex(const std::string &value, const std::string &option)
+{
+    size_t index = 0;
+    auto [ptr, ec] = std::from_chars(value.data(),
+                                     value.data() + value.size(), index);
+    if (value.empty() || ec != std::errc() ||
+        ptr != value.data() + value.size())
+    {
+        throw std::invalid_argument(option + " must be a non-negative integer");
+    }
+    return index;
+}
+
+Options parseCommandLine(int argc, char *argv[])
+{
+    Options options;
+    auto getValue = [&](int &i) -> std::string
+    {
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument(std::string {argv[i]}
+                                      + " requires a value");
+        }
+        i = i + 1;
+        return argv[i];
+    };
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument(argv[i]);
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            std::exit(EXIT_SUCCESS);
+        }
+        else if (argument == "-o" || argument == "--output")
+        {
+            options.outputFile = getValue(i);
+        }
+        else if (argument == "--time-column")
+        {
+            options.timeColumn = toIndex(getValue(i), argument);
+        }
+        else if (argument == "--latitude-column")
+        {
+            options.latitudeColumn = toIndex(getValue(i), argument);
+        }
+        else if (argument == "--longitude-column")
+        {
+            options.longitudeColumn = toIndex(getValue(i), argument);
+        }
+        else if (argument == "--delimiter")
+        {
+            auto delimiter = getValue(i);
+            if (delimiter.size() != 1)
+            {
+                throw std::invalid_argument("Delimiter must be 1 character");
+            }
+            options.delimiter = delimiter[0];
+        }
+        else if (argument == "--depression-angle")
+        {
+            options.depressionAngle = std::stod(getValue(i));
+            if (!(options.depressionAngle >= -90 &&
+                  options.depressionAngle <= 90))
+            {
+                throw std::invalid_argument(
+                    "Depression angle must be in range [-90,90]");
+            }
+        }
+        else if (argument == "--threads")
+        {
+            options.nThreads = std::stoi(getValue(i));
+            if (options.nThreads < 1)
+            {
+                throw std::invalid_argument("Threads must be positive");
+            }
+        }
+        else if (!argument.empty() && argument[0] == '-' && argument != "-")
+        {
+            throw std::invalid_argument("Unknown option " + argument);
+        }
+        else if (options.inputFile.empty())
+        {
+            options.inputFile = argument;
+        }
+        else
+        {
+            throw std::invalid_argument("Only one input file is allowed");
+        }
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    try
+    {
+        options = parseCommandLine(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    std::FILE *input = stdin;
+    if (!options.inputFile.empty() && options.inputFile != "-")
+    {
+        input = std::fopen(options.inputFile.c_str(), "rb");
+        if (input == nullptr)
+        {
+            std::cerr << "Failed to open " << options.inputFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::FILE *output = stdout;
+    if (!options.outputFile.empty())
+    {
+        output = std::fopen(options.outputFile.c_str(), "wb");
+        if (output == nullptr)
+        {
+            std::cerr << "Failed to open " << options.outputFile << std::endl;
+            if (input != stdin){std::fclose(input);}
+            return EXIT_FAILURE;
+        }
+    }
+    auto engine = options.nThreads > 0 ?
+                  std::make_unique<ParallelEngine> (options.nThreads) :
+                  std::make_unique<ParallelEngine> ();
+    DayNightClassifier classifier;
+    Queue readQueue, parseQueue, computeQueue, formatQueue;
+    PipelineError error;
+    size_t nInvalid = 0;
+    std::thread parser(parseLines, std::cref(options),
+                       std::ref(readQueue), std::ref(parseQueue),
+                       std::ref(error));
+    std::thread computer(computeLines, std::cref(options),
+                         std::ref(*engine), std::cref(classifier),
+                         std::ref(parseQueue), std::ref(computeQueue),
+                         std::ref(error));
+    std::thread formatter(formatLines, std::cref(options),
+                          std::ref(computeQueue), std::ref(formatQueue),
+                          std::ref(error));
+    std::thread writer(writeLines, output, std::ref(formatQueue), &nInvalid,
+                       std::ref(error));
+    try
+    {
+        readLines(input, readQueue, error);
+    }
+    catch (const std::exception &e)
+    {
+        error.set(e.what());
+        readQueue.push(std::nullopt);
+    }
+    parser.join();
+    computer.join();
+    formatter.join();
+    writer.join();
+    if (input != stdin){std::fclose(input);}
+    bool writeFailed = (std::fflush(output) != 0) || std::ferror(output);
+    if (output != stdout){writeFailed = (std::fclose(output) != 0) || writeFailed;}
+    if (error.failed())
+    {
+        std::cerr << error.getMessage() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (nInvalid > 0)
+    {
+        std::cerr << "Skipped " << nInvalid << " invalid rows" << std::endl;
+    }
+    if (writeFailed)
+    {
+        std::cerr << "Failed to write output" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
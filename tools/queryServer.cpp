@@ -0,0 +1,126 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <csignal>
+#include <stdexcept>
+#include <pthread.h>
+#include "solarCalculator/queryServer.hpp"
+
+/// @brief Serves sun position, day/night, and rise/set queries over a Unix
+///        domain socket until interrupted.
+
+using namespace SolarCalculator;
+
+namespace
+{
+
+struct Options
+{
+    std::string socketPath;
+    int firstYear = 1900;
+    int lastYear = 2100;
+};
+
+void printUsage()
+{
+    std::cout << "Usage: solarCalculator-server [options] --socket PATH\n\n"
+              << "Answers sun position, day/night, and rise/set queries from\n"
+              << "local processes over a Unix domain socket.  Concurrent\n"
+              << "requests are answered in batches.  Positions whose times\n"
+              << "are in the ephemeris table's years are interpolated from\n"
+              << "it.  The server runs until it receives SIGINT or SIGTERM.\n\n"
+              << "Options:\n"
+              << "  --socket PATH           Path of the socket (required)\n"
+              << "  --first-year Y          First year of the ephemeris table\n"
+              << "                          (default: 1900)\n"
+              << "  --last-year Y           Last year of the ephemeris table\n"
+              << "                          (default: 2100)\n"
+              << "  -h, --help              Print this message\n";
+}
+
+Options parseCommandLine(int argc, char *argv[])
+{
+    Options options;
+    auto getValue = [&](int &i) -> std::string
+    {
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument(std::string {argv[i]}
+                                      + " requires a value");
+        }
+        i = i + 1;
+        return argv[i];
+    };
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument(argv[i]);
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            std::exit(EXIT_SUCCESS);
+        }
+        else if (argument == "--socket")
+        {
+            options.socketPath = getValue(i);
+        }
+        else if (argument == "--first-year")
+        {
+            options.firstYear = std::stoi(getValue(i));
+        }
+        else if (argument == "--last-year")
+        {
+            options.lastYear = std::stoi(getValue(i));
+        }
+        else
+        {
+            throw std::invalid_argument("Unknown option " + argument);
+        }
+    }
+    if (options.socketPath.empty())
+    {
+        throw std::invalid_argument("Socket not specified");
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    try
+    {
+        options = parseCommandLine(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    // Block the signals before any threads start so that only sigwait
+    // receives them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    QueryServer server;
+    try
+    {
+        server.start(options.socketPath, options.firstYear, options.lastYear);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Listening on " << options.socketPath << std::endl;
+    int signal = 0;
+    sigwait(&signals, &signal);
+    server.stop();
+    std::cerr << "Answered " << server.getNumberOfRequests()
+              << " requests in " << server.getNumberOfBatches()
+              << " batches" << std::endl;
+    return EXIT_SUCCESS;
+}